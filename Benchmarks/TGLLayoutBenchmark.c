@@ -0,0 +1,600 @@
+//
+//  TGLLayoutBenchmark.c
+//  TGLStackedViewController
+//
+//  Created by Tim Gleue on 17.10.26.
+//  Copyright (c) 2026 Tim Gleue ( http://gleue-interactive.com )
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+/* Headless benchmark of the platform-neutral layout geometry.
+ *
+ * Drives the stacked and exposed geometry through the same
+ * per-frame work the UIKit layouts do, i.e. preparing the
+ * geometry and computing origins and flags of all items in
+ * the visible rect, for synthetic scroll and expose sweeps.
+ * Bytes allocated per frame are counted by the benchmark's
+ * allocator, which all buffers grown during sweeps go through.
+ * Geometry functions called per frame don't allocate, so the
+ * figure is 0 once buffers reached the visible item count.
+ * The `records` scenario additionally moves a window of
+ * paged records along with the visible items, reporting its
+ * resident memory, which must not grow with the item count.
+ * The benchmark fails if it does, or if records don't match
+ * the items they were read for. The `reveal_table` layout's
+ * `reset` and `reset_concurrent` variants time building
+ * reveal tables of all items serially and in chunks on
+ * several threads, failing if the results differ.
+ *
+ * Build and run from the repository root on any platform
+ * with a C99 compiler, e.g.
+ *
+ *   cc -std=c99 -O2 -pthread -ITGLStackedViewController -o layout-benchmark \
+ *      Benchmarks/TGLLayoutBenchmark.c TGLStackedViewController/TGLLayoutGeometry.c \
+ *      TGLStackedViewController/TGLRecordWindow.c -lm
+ *
+ *   ./layout-benchmark [max item count] > results.jsonl
+ *
+ * Each line of output is a JSON object describing one scenario
+ * and item count, so results of different commits can be
+ * compared by joining on `layout`, `variant` and `items`.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include "TGLLayoutGeometry.h"
+#include "TGLRecordWindow.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// MARK: - Configuration
+
+static const double TGLBenchmarkBoundsHeight = 812.0;
+static const double TGLBenchmarkMarginTop = 20.0;
+static const double TGLBenchmarkMarginBottom = 0.0;
+static const double TGLBenchmarkContentInsetTop = 44.0;
+static const double TGLBenchmarkReveal = 120.0;
+static const double TGLBenchmarkMinimumReveal = 8.0;
+static const double TGLBenchmarkBounceFactor = 0.2;
+static const double TGLBenchmarkOverscroll = 150.0;
+
+static const long TGLBenchmarkFrameCount = 2000;
+
+#define TGLBenchmarkThreadCount 4
+
+// MARK: - Helpers
+
+/** Bytes allocated through `TGLBenchmarkRealloc` */
+static unsigned long long TGLBenchmarkAllocatedBytes = 0;
+
+/** Counting allocator for buffers grown while sweeping */
+static void *TGLBenchmarkRealloc(void *pointer, size_t size) {
+
+    TGLBenchmarkAllocatedBytes += size;
+
+    return realloc(pointer, size);
+}
+
+/** Buffers grown like the layouts' visible item buffers */
+typedef struct {
+
+    long capacity;
+    double *originY;
+    TGLLayoutItemFlags *flags;
+
+} TGLBenchmarkBuffers;
+
+static void TGLBenchmarkReserve(TGLBenchmarkBuffers *buffers, long capacity) {
+
+    if (capacity <= buffers->capacity) return;
+
+    if (capacity < 2 * buffers->capacity) capacity = 2 * buffers->capacity;
+
+    buffers->originY = TGLBenchmarkRealloc(buffers->originY, capacity * sizeof(double));
+    buffers->flags = TGLBenchmarkRealloc(buffers->flags, capacity * sizeof(TGLLayoutItemFlags));
+    buffers->capacity = capacity;
+}
+
+static double TGLBenchmarkNow(void) {
+
+    struct timespec time;
+
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return time.tv_sec * 1e9 + time.tv_nsec;
+}
+
+static void TGLBenchmarkReport(const char *layout, const char *variant, long itemCount, long frameCount, double duration, unsigned long long touchedItems, unsigned long long allocatedBytes) {
+
+    printf("{\"layout\":\"%s\",\"variant\":\"%s\",\"items\":%ld,\"frames\":%ld,\"ns_per_frame\":%.1f,\"items_per_frame\":%.2f,\"bytes_per_frame\":%.2f}\n",
+           layout, variant, itemCount, frameCount, duration / frameCount, (double)touchedItems / frameCount, (double)allocatedBytes / frameCount);
+
+    fflush(stdout);
+}
+
+// MARK: - Stacked layout
+
+typedef enum {
+
+    TGLBenchmarkStackedPlain = 0,       /* Scroll from top to bottom */
+    TGLBenchmarkStackedBounce,          /* Overscroll at top and bottom */
+    TGLBenchmarkStackedFillHeight,      /* Items of a short stack evenly filling height, or scrolling at minimum reveal if too many */
+    TGLBenchmarkStackedCenterSingle,    /* Single item centered, regardless of item count */
+    TGLBenchmarkStackedRevealTable,     /* Per-item reveal heights */
+    TGLBenchmarkStackedVariantCount
+
+} TGLBenchmarkStackedVariant;
+
+static const char *TGLBenchmarkStackedVariantNames[TGLBenchmarkStackedVariantCount] = { "plain", "bounce", "fill_height", "center_single_item", "reveal_table" };
+
+static void TGLBenchmarkStacked(TGLBenchmarkStackedVariant variant, long itemCount) {
+
+    if (variant == TGLBenchmarkStackedCenterSingle) itemCount = 1;
+
+    double layoutHeight = TGLBenchmarkBoundsHeight - TGLBenchmarkMarginTop - TGLBenchmarkMarginBottom;
+    double itemReveal = TGLBenchmarkReveal;
+
+    // Filling height applies to stacks shorter
+    // than the layout only, so start with one
+    // of half the layout's height. Reveal must
+    // not collapse for large item counts though,
+    // these scroll at a minimum reveal instead
+    //
+    if (variant == TGLBenchmarkStackedFillHeight && itemCount > 0) {
+
+        itemReveal = 0.5 * layoutHeight / itemCount;
+
+        if (itemReveal < TGLBenchmarkMinimumReveal) itemReveal = TGLBenchmarkMinimumReveal;
+    }
+
+    TGLRevealTable revealTable;
+
+    TGLRevealTableInit(&revealTable);
+
+    double stackHeight = itemReveal * itemCount;
+
+    if (variant == TGLBenchmarkStackedRevealTable) {
+
+        double *values = malloc((itemCount > 0 ? itemCount : 1) * sizeof(double));
+
+        for (long item = 0; item < itemCount; item++) values[item] = TGLBenchmarkReveal * (0.5 + (item % 4) * 0.25);
+
+        TGLRevealTableReset(&revealTable, values, itemCount);
+
+        stackHeight = TGLRevealTableTotal(&revealTable);
+
+        free(values);
+    }
+
+    double contentHeight = TGLBenchmarkMarginTop + stackHeight + TGLBenchmarkMarginBottom;
+
+    if (contentHeight < TGLBenchmarkBoundsHeight) {
+
+        contentHeight = TGLBenchmarkBoundsHeight;
+
+        if (variant == TGLBenchmarkStackedFillHeight && itemCount > 0) itemReveal = (double)(long)(layoutHeight / itemCount);
+    }
+
+    // Sweep content offset linearly across
+    // scrollable range, extending it at both
+    // ends when bouncing
+    //
+    double minOffset = -TGLBenchmarkContentInsetTop;
+    double maxOffset = contentHeight - TGLBenchmarkBoundsHeight;
+
+    if (maxOffset < minOffset) maxOffset = minOffset;
+
+    if (variant == TGLBenchmarkStackedBounce || variant == TGLBenchmarkStackedCenterSingle || variant == TGLBenchmarkStackedFillHeight) {
+
+        minOffset -= TGLBenchmarkOverscroll;
+        maxOffset += TGLBenchmarkOverscroll;
+    }
+
+    TGLStackedParameters parameters = {
+
+        .itemCount = itemCount,
+        .itemReveal = itemReveal,
+        .itemHeight = layoutHeight,
+        .revealTable = (variant == TGLBenchmarkStackedRevealTable) ? &revealTable : NULL,
+        .marginTop = TGLBenchmarkMarginTop,
+        .layoutHeight = layoutHeight,
+        .boundsHeight = TGLBenchmarkBoundsHeight,
+        .contentHeight = contentHeight,
+        .contentOffset = 0.0,
+        .contentInsetTop = TGLBenchmarkContentInsetTop,
+        .bounceFactor = TGLBenchmarkBounceFactor,
+        .centerSingleItem = (variant == TGLBenchmarkStackedCenterSingle)
+    };
+
+    TGLBenchmarkBuffers buffers = { 0 };
+    TGLStackedGeometry geometry;
+    long firstCompressingItem = -1;
+    unsigned long long touchedItems = 0;
+    unsigned long long allocatedBytes = TGLBenchmarkAllocatedBytes;
+    double checksum = 0.0;
+    double startTime = TGLBenchmarkNow();
+
+    for (long frame = 0; frame < TGLBenchmarkFrameCount; frame++) {
+
+        parameters.contentOffset = minOffset + (maxOffset - minOffset) * frame / (TGLBenchmarkFrameCount - 1);
+
+        TGLStackedGeometryPrepare(&geometry, &parameters, &firstCompressingItem);
+
+        long first, end;
+
+        TGLStackedGeometryItemRange(&geometry, parameters.contentOffset, parameters.contentOffset + TGLBenchmarkBoundsHeight, &first, &end);
+
+        TGLBenchmarkReserve(&buffers, end - first);
+        TGLStackedGeometryGetItems(&geometry, first, end - first, buffers.originY, buffers.flags);
+
+        if (end > first) checksum += buffers.originY[0];
+
+        touchedItems += end - first;
+    }
+
+    double duration = TGLBenchmarkNow() - startTime;
+
+    allocatedBytes = TGLBenchmarkAllocatedBytes - allocatedBytes;
+
+    // Keep results observable so
+    // work is not optimized away
+    //
+    if (checksum == 0.123456789) fprintf(stderr, "%f\n", checksum);
+
+    TGLBenchmarkReport("stacked", TGLBenchmarkStackedVariantNames[variant], itemCount, TGLBenchmarkFrameCount, duration, touchedItems, allocatedBytes);
+
+    free(buffers.originY);
+    free(buffers.flags);
+
+    TGLRevealTableFree(&revealTable);
+}
+
+// MARK: - Exposed layout
+
+static const char *TGLBenchmarkExposedPinningNames[] = { "pinning_none", "pinning_below", "pinning_all" };
+
+static void TGLBenchmarkExposed(TGLExposedPinning pinning, long itemCount) {
+
+    TGLExposedParameters parameters = {
+
+        .itemCount = itemCount,
+        .exposedItem = 0,
+        .itemHeight = TGLBenchmarkBoundsHeight - 40.0,
+        .marginTop = 40.0,
+        .marginBottom = 0.0,
+        .boundsHeight = TGLBenchmarkBoundsHeight,
+        .contentHeight = TGLBenchmarkBoundsHeight - TGLBenchmarkContentInsetTop,
+        .topOverlap = 10.0,
+        .bottomOverlap = 10.0,
+        .bottomOverlapCount = 1,
+        .pinning = pinning,
+        .topPinningCount = -1,
+        .bottomPinningCount = -1
+    };
+
+    TGLBenchmarkBuffers buffers = { 0 };
+    TGLExposedGeometry geometry;
+    unsigned long long touchedItems = 0;
+    unsigned long long allocatedBytes = TGLBenchmarkAllocatedBytes;
+    double checksum = 0.0;
+    double startTime = TGLBenchmarkNow();
+
+    for (long frame = 0; frame < TGLBenchmarkFrameCount; frame++) {
+
+        // Expose items spread across the stack
+        //
+        parameters.exposedItem = (itemCount > 1) ? (long)((double)(itemCount - 1) * frame / (TGLBenchmarkFrameCount - 1)) : 0;
+
+        TGLExposedGeometryPrepare(&geometry, &parameters);
+
+        long first[TGLExposedGeometryMaxRangeCount], end[TGLExposedGeometryMaxRangeCount];
+        long rangeCount = TGLExposedGeometryItemRanges(&geometry, -TGLBenchmarkContentInsetTop, TGLBenchmarkBoundsHeight - TGLBenchmarkContentInsetTop, first, end);
+
+        for (long range = 0; range < rangeCount; range++) {
+
+            TGLBenchmarkReserve(&buffers, end[range] - first[range]);
+            TGLExposedGeometryGetItems(&geometry, first[range], end[range] - first[range], buffers.originY, buffers.flags);
+
+            if (end[range] > first[range]) checksum += buffers.originY[0];
+
+            touchedItems += end[range] - first[range];
+        }
+    }
+
+    double duration = TGLBenchmarkNow() - startTime;
+
+    allocatedBytes = TGLBenchmarkAllocatedBytes - allocatedBytes;
+
+    if (checksum == 0.123456789) fprintf(stderr, "%f\n", checksum);
+
+    TGLBenchmarkReport("exposed", TGLBenchmarkExposedPinningNames[pinning], itemCount, TGLBenchmarkFrameCount, duration, touchedItems, allocatedBytes);
+
+    free(buffers.originY);
+    free(buffers.flags);
+}
+
+// MARK: - Reveal table
+
+typedef struct {
+
+    size_t iterations;
+    size_t thread;
+    void *context;
+    void (*work)(void *context, size_t iteration);
+
+} TGLBenchmarkApplyTask;
+
+static void *TGLBenchmarkApplyThread(void *argument) {
+
+    TGLBenchmarkApplyTask *task = argument;
+
+    for (size_t i = task->thread; i < task->iterations; i += TGLBenchmarkThreadCount) task->work(task->context, i);
+
+    return NULL;
+}
+
+/** Stands in for `dispatch_apply_f`, running iterations on a few threads */
+static void TGLBenchmarkConcurrentApply(size_t iterations, void *context, void (*work)(void *context, size_t iteration)) {
+
+    pthread_t threads[TGLBenchmarkThreadCount];
+    TGLBenchmarkApplyTask tasks[TGLBenchmarkThreadCount];
+    bool started[TGLBenchmarkThreadCount];
+
+    for (size_t thread = 0; thread < TGLBenchmarkThreadCount; thread++) {
+
+        tasks[thread] = (TGLBenchmarkApplyTask){ .iterations = iterations, .thread = thread, .context = context, .work = work };
+        started[thread] = thread < iterations && pthread_create(&threads[thread], NULL, TGLBenchmarkApplyThread, &tasks[thread]) == 0;
+
+        // Run iterations of threads that
+        // failed to start on this thread
+        //
+        if (!started[thread]) TGLBenchmarkApplyThread(&tasks[thread]);
+    }
+
+    for (size_t thread = 0; thread < TGLBenchmarkThreadCount; thread++) {
+
+        if (started[thread]) pthread_join(threads[thread], NULL);
+    }
+}
+
+static bool TGLBenchmarkRevealReset(long itemCount) {
+
+    double *values = malloc((itemCount > 0 ? itemCount : 1) * sizeof(double));
+
+    for (long item = 0; item < itemCount; item++) values[item] = TGLBenchmarkReveal * (0.5 + (item % 4) * 0.25);
+
+    // Build about as many items for
+    // all counts, but at least a few
+    // tables of the largest ones
+    //
+    long buildCount = 10000000 / (itemCount > 0 ? itemCount : 1);
+
+    if (buildCount < 10) buildCount = 10;
+    if (buildCount > 10000) buildCount = 10000;
+
+    TGLRevealTable tables[2];
+    const char *variants[2] = { "reset", "reset_concurrent" };
+
+    for (int variant = 0; variant < 2; variant++) {
+
+        TGLRevealTableInit(&tables[variant]);
+
+        double startTime = TGLBenchmarkNow();
+
+        for (long build = 0; build < buildCount; build++) {
+
+            if (variant == 0) {
+
+                TGLRevealTableReset(&tables[variant], values, itemCount);
+
+            } else {
+
+                TGLRevealTableResetConcurrently(&tables[variant], values, itemCount, TGLBenchmarkConcurrentApply);
+            }
+        }
+
+        double duration = TGLBenchmarkNow() - startTime;
+
+        printf("{\"layout\":\"reveal_table\",\"variant\":\"%s\",\"items\":%ld,\"builds\":%ld,\"ns_per_build\":%.1f,\"threads\":%d}\n",
+               variants[variant], itemCount, buildCount, duration / buildCount, variant == 0 ? 1 : TGLBenchmarkThreadCount);
+
+        fflush(stdout);
+    }
+
+    // Chunks are summed in the same order
+    // as when building serially, so tables
+    // must be identical
+    //
+    bool valid = tables[0].count == tables[1].count && tables[0].height == tables[1].height;
+
+    for (long item = 0; valid && item <= itemCount; item += 1 + item / 64) {
+
+        if (TGLRevealTablePrefix(&tables[0], item) != TGLRevealTablePrefix(&tables[1], item)) valid = false;
+    }
+
+    if (TGLRevealTableTotal(&tables[0]) != TGLRevealTableTotal(&tables[1])) valid = false;
+
+    if (!valid) fprintf(stderr, "reveal_table: concurrent build of %ld items differs from serial one\n", itemCount);
+
+    TGLRevealTableFree(&tables[0]);
+    TGLRevealTableFree(&tables[1]);
+
+    free(values);
+
+    return valid;
+}
+
+// MARK: - Record window
+
+/** Record as read by the synthetic paging callback */
+typedef struct {
+
+    long item;
+    char title[56];
+
+} TGLBenchmarkRecord;
+
+static bool TGLBenchmarkReadRecords(void *context, long first, long count, void *buffer) {
+
+    (void)context;
+
+    TGLBenchmarkRecord *records = buffer;
+
+    for (long i = 0; i < count; i++) {
+
+        records[i].item = first + i;
+
+        snprintf(records[i].title, sizeof(records[i].title), "Card #%ld", first + i);
+    }
+
+    return true;
+}
+
+static const long TGLBenchmarkPageRecordCount = 64;
+static const long TGLBenchmarkPageCapacity = 16;
+
+/** Returns `false` if records did not match their items or more pages than capacity became resident */
+static bool TGLBenchmarkRecords(long itemCount) {
+
+    TGLRecordWindow window;
+
+    if (!TGLRecordWindowInit(&window, itemCount, sizeof(TGLBenchmarkRecord), TGLBenchmarkPageRecordCount, TGLBenchmarkPageCapacity, TGLBenchmarkReadRecords, NULL)) return false;
+
+    double layoutHeight = TGLBenchmarkBoundsHeight - TGLBenchmarkMarginTop - TGLBenchmarkMarginBottom;
+    double contentHeight = TGLBenchmarkMarginTop + TGLBenchmarkReveal * itemCount + TGLBenchmarkMarginBottom;
+
+    if (contentHeight < TGLBenchmarkBoundsHeight) contentHeight = TGLBenchmarkBoundsHeight;
+
+    double minOffset = -TGLBenchmarkContentInsetTop;
+    double maxOffset = contentHeight - TGLBenchmarkBoundsHeight;
+
+    if (maxOffset < minOffset) maxOffset = minOffset;
+
+    TGLStackedParameters parameters = {
+
+        .itemCount = itemCount,
+        .itemReveal = TGLBenchmarkReveal,
+        .itemHeight = layoutHeight,
+        .marginTop = TGLBenchmarkMarginTop,
+        .layoutHeight = layoutHeight,
+        .boundsHeight = TGLBenchmarkBoundsHeight,
+        .contentHeight = contentHeight,
+        .contentInsetTop = TGLBenchmarkContentInsetTop,
+        .bounceFactor = TGLBenchmarkBounceFactor
+    };
+
+    TGLStackedGeometry geometry;
+    long firstCompressingItem = -1;
+    unsigned long long touchedItems = 0;
+    long mismatchCount = 0;
+    long maxResidentPageCount = 0;
+    double startTime = TGLBenchmarkNow();
+
+    for (long frame = 0; frame < TGLBenchmarkFrameCount; frame++) {
+
+        parameters.contentOffset = minOffset + (maxOffset - minOffset) * frame / (TGLBenchmarkFrameCount - 1);
+
+        TGLStackedGeometryPrepare(&geometry, &parameters, &firstCompressingItem);
+
+        long first, end;
+
+        TGLStackedGeometryItemRange(&geometry, parameters.contentOffset, parameters.contentOffset + TGLBenchmarkBoundsHeight, &first, &end);
+
+        // Prefetch one screen ahead
+        // in scrolling direction
+        //
+        TGLRecordWindowSetVisibleRange(&window, first, end, first, end + (end - first));
+
+        for (long item = first; item < end; item++) {
+
+            const TGLBenchmarkRecord *record = TGLRecordWindowRecord(&window, item);
+
+            if (record == NULL || record->item != item) mismatchCount++;
+        }
+
+        long residentPageCount = TGLRecordWindowResidentPageCount(&window);
+
+        if (residentPageCount > maxResidentPageCount) maxResidentPageCount = residentPageCount;
+
+        touchedItems += end - first;
+    }
+
+    double duration = TGLBenchmarkNow() - startTime;
+
+    printf("{\"layout\":\"records\",\"variant\":\"paging\",\"items\":%ld,\"frames\":%ld,\"ns_per_frame\":%.1f,\"items_per_frame\":%.2f,\"resident_bytes\":%zu,\"resident_pages\":%ld,\"page_loads\":%lu}\n",
+           itemCount, TGLBenchmarkFrameCount, duration / TGLBenchmarkFrameCount, (double)touchedItems / TGLBenchmarkFrameCount,
+           TGLRecordWindowResidentBytes(&window), maxResidentPageCount, window.loadCount);
+
+    fflush(stdout);
+
+    // Residency must be bounded by capacity,
+    // not grow with the number of items
+    //
+    bool valid = true;
+
+    if (mismatchCount > 0) {
+
+        fprintf(stderr, "records: %ld of %ld items read wrong records\n", mismatchCount, itemCount);
+        valid = false;
+    }
+
+    if (maxResidentPageCount > TGLBenchmarkPageCapacity || TGLRecordWindowResidentBytes(&window) != TGLBenchmarkPageCapacity * (TGLBenchmarkPageRecordCount * sizeof(TGLBenchmarkRecord) + sizeof(long))) {
+
+        fprintf(stderr, "records: %ld pages, %zu bytes resident for %ld items exceed capacity\n", maxResidentPageCount, TGLRecordWindowResidentBytes(&window), itemCount);
+        valid = false;
+    }
+
+    TGLRecordWindowFree(&window);
+
+    return valid;
+}
+
+// MARK: - Main
+
+int main(int argc, const char *argv[]) {
+
+    long maxItemCount = (argc > 1) ? atol(argv[1]) : 1000000;
+    bool valid = true;
+
+    // Centering applies to a single item only,
+    // so there's nothing to sweep
+    //
+    TGLBenchmarkStacked(TGLBenchmarkStackedCenterSingle, 1);
+
+    for (long itemCount = 10; itemCount <= maxItemCount; itemCount *= 10) {
+
+        for (int variant = 0; variant < TGLBenchmarkStackedVariantCount; variant++) {
+
+            if (variant != TGLBenchmarkStackedCenterSingle) TGLBenchmarkStacked((TGLBenchmarkStackedVariant)variant, itemCount);
+        }
+
+        for (int pinning = TGLExposedPinningNone; pinning <= TGLExposedPinningAll; pinning++) {
+
+            TGLBenchmarkExposed((TGLExposedPinning)pinning, itemCount);
+        }
+
+        if (!TGLBenchmarkRevealReset(itemCount)) valid = false;
+        if (!TGLBenchmarkRecords(itemCount)) valid = false;
+    }
+
+    return valid ? 0 : 1;
+}
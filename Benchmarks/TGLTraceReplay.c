@@ -0,0 +1,446 @@
+//
+//  TGLTraceReplay.c
+//  TGLStackedViewController
+//
+//  Created by Tim Gleue on 17.10.26.
+//  Copyright (c) 2026 Tim Gleue ( http://gleue-interactive.com )
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+/* Headless replay of layout traces recorded on device.
+ *
+ * Reads a trace recorded by `TGLStackedViewController`'s
+ * `-startRecordingLayoutTrace` and feeds every frame through
+ * the platform-neutral geometry the way the UIKit layouts
+ * do: the stacked geometry while scrolling or moving items,
+ * the exposed geometry while an item is exposed, and both
+ * while interactively collapsing. Reveal heights provided
+ * per item by a collection view delegate are not recorded,
+ * so items use the stacked layout's uniform reveal.
+ *
+ * Build and run from the repository root on any platform
+ * with a C99 compiler, e.g.
+ *
+ *   cc -std=c99 -O2 -ITGLStackedViewController -o trace-replay \
+ *      Benchmarks/TGLTraceReplay.c TGLStackedViewController/TGLLayoutGeometry.c \
+ *      TGLStackedViewController/TGLLayoutTrace.c -lm
+ *
+ *   ./trace-replay [-f] trace.bin > replay.jsonl
+ *
+ * Prints a JSON object summarizing per-frame cost and a
+ * checksum of all items' origins and flags, which does not
+ * depend on timing and can be compared against the output
+ * of a reference build. Option `-f` additionally prints a
+ * JSON object per frame before the summary.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "TGLLayoutGeometry.h"
+#include "TGLLayoutTrace.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// MARK: - Helpers
+
+typedef enum {
+
+    TGLReplayModeStacked = 0,
+    TGLReplayModeExposed,
+    TGLReplayModeTransition
+
+} TGLReplayMode;
+
+static const char *TGLReplayModeNames[] = { "stacked", "exposed", "transition" };
+
+typedef struct {
+
+    TGLLayoutTraceHeader header;
+
+    TGLStackedParameters stackedParameters;
+    TGLStackedGeometry stackedGeometry;
+    long firstCompressingItem;
+
+    TGLExposedParameters exposedParameters;
+    TGLExposedGeometry exposedGeometry;
+
+    long capacity;
+    double *originY;
+    TGLLayoutItemFlags *flags;
+
+    unsigned long long checksum;
+
+} TGLReplay;
+
+static double TGLReplayNow(void) {
+
+    struct timespec time;
+
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return time.tv_sec * 1e9 + time.tv_nsec;
+}
+
+static void TGLReplayReserve(TGLReplay *replay, long capacity) {
+
+    if (capacity <= replay->capacity) return;
+
+    if (capacity < 2 * replay->capacity) capacity = 2 * replay->capacity;
+
+    replay->originY = realloc(replay->originY, capacity * sizeof(double));
+    replay->flags = realloc(replay->flags, capacity * sizeof(TGLLayoutItemFlags));
+    replay->capacity = capacity;
+}
+
+static void TGLReplayHash(TGLReplay *replay, long value) {
+
+    // FNV-1a over the value's bytes
+    // in little-endian order
+    //
+    unsigned long long bits = (unsigned long long)value;
+
+    for (int i = 0; i < 8; i++) {
+
+        replay->checksum ^= (bits >> (8 * i)) & 0xff;
+        replay->checksum *= 1099511628211ULL;
+    }
+}
+
+static void TGLReplayHashItem(TGLReplay *replay, long item, double originY, TGLLayoutItemFlags flags) {
+
+    // Quantize origins to 1/64 point, so that
+    // results don't depend on floating point
+    // contraction of different compilers
+    //
+    TGLReplayHash(replay, item);
+    TGLReplayHash(replay, (long)llround(originY * 64.0));
+    TGLReplayHash(replay, (long)flags);
+}
+
+static char *TGLReplayReadFile(const char *path, size_t *length) {
+
+    FILE *file = fopen(path, "rb");
+
+    if (file == NULL) return NULL;
+
+    size_t capacity = 1 << 16;
+    char *bytes = malloc(capacity);
+
+    *length = 0;
+
+    while (bytes) {
+
+        *length += fread(bytes + *length, 1, capacity - *length, file);
+
+        if (*length < capacity) break;
+
+        capacity *= 2;
+        bytes = realloc(bytes, capacity);
+    }
+
+    fclose(file);
+
+    return bytes;
+}
+
+// MARK: - Geometry
+
+static void TGLReplayPrepareStacked(TGLReplay *replay, const TGLLayoutTraceFrame *frame) {
+
+    // Same as -[TGLStackedLayout prepareGeometry]
+    //
+    const TGLLayoutTraceHeader *header = &replay->header;
+    double layoutHeight = frame->boundsHeight - header->marginTop - header->marginBottom;
+    double contentHeight = header->marginTop + header->itemReveal * frame->itemCount + header->marginBottom;
+    double itemReveal = header->itemReveal;
+
+    if (contentHeight < frame->boundsHeight) {
+
+        contentHeight = frame->boundsHeight;
+
+        if (header->alwaysBounce) contentHeight += 1.0;
+        if (header->fillHeight && frame->itemCount > 0) itemReveal = floor(layoutHeight / frame->itemCount);
+    }
+
+    replay->stackedParameters = (TGLStackedParameters){
+
+        .itemCount = frame->itemCount,
+        .itemReveal = itemReveal,
+        .itemHeight = (header->itemHeight > 0.0) ? header->itemHeight : layoutHeight,
+        .marginTop = header->marginTop,
+        .layoutHeight = layoutHeight,
+        .boundsHeight = frame->boundsHeight,
+        .contentHeight = contentHeight,
+        .contentOffset = frame->contentOffset,
+        .contentInsetTop = frame->contentInsetTop,
+        .bounceFactor = header->bounceFactor,
+        .centerSingleItem = header->centerSingleItem,
+        .occlusionThreshold = header->occlusionThreshold
+    };
+
+    TGLStackedGeometryPrepare(&replay->stackedGeometry, &replay->stackedParameters, &replay->firstCompressingItem);
+}
+
+static void TGLReplayPrepareExposed(TGLReplay *replay, const TGLLayoutTraceFrame *frame) {
+
+    // Same as -[TGLExposedLayout prepareGeometryForCollectionView:]
+    //
+    const TGLLayoutTraceHeader *header = &replay->header;
+    double contentHeight = frame->boundsHeight - frame->contentInsetTop - frame->contentInsetBottom;
+
+    replay->exposedParameters = (TGLExposedParameters){
+
+        .itemCount = frame->itemCount,
+        .exposedItem = (frame->exposedItem >= 0) ? frame->exposedItem : 0,
+        .itemHeight = (header->exposedItemHeight > 0.0) ? header->exposedItemHeight : contentHeight - header->exposedMarginTop - header->exposedMarginBottom,
+        .marginTop = header->exposedMarginTop,
+        .marginBottom = header->exposedMarginBottom,
+        .boundsHeight = frame->boundsHeight,
+        .contentHeight = contentHeight,
+        .topOverlap = header->exposedTopOverlap,
+        .bottomOverlap = header->exposedBottomOverlap,
+        .bottomOverlapCount = header->exposedBottomOverlapCount,
+        .pinning = header->exposedPinning,
+        .topPinningCount = header->exposedTopPinningCount,
+        .bottomPinningCount = header->exposedBottomPinningCount
+    };
+
+    TGLExposedGeometryPrepare(&replay->exposedGeometry, &replay->exposedParameters);
+}
+
+static long TGLReplayStacked(TGLReplay *replay, const TGLLayoutTraceFrame *frame) {
+
+    long first, end;
+
+    TGLStackedGeometryItemRange(&replay->stackedGeometry, frame->contentOffset, frame->contentOffset + frame->boundsHeight, &first, &end);
+
+    TGLReplayReserve(replay, end - first);
+    TGLStackedGeometryGetItems(&replay->stackedGeometry, first, end - first, replay->originY, replay->flags);
+
+    for (long item = first; item < end; item++) TGLReplayHashItem(replay, item, replay->originY[item - first], replay->flags[item - first]);
+
+    if (frame->movingItem >= 0) {
+
+        // Target of moved item is the topmost
+        // visible item at target position
+        //
+        long targetItem = -1;
+
+        for (long item = first; item < end; item++) {
+
+            if (replay->originY[item - first] <= frame->moveTargetY && !(replay->flags[item - first] & TGLLayoutItemFlagHidden)) targetItem = item;
+        }
+
+        TGLReplayHash(replay, targetItem);
+    }
+
+    return end - first;
+}
+
+static long TGLReplayExposed(TGLReplay *replay, const TGLLayoutTraceFrame *frame) {
+
+    long first[TGLExposedGeometryMaxRangeCount], end[TGLExposedGeometryMaxRangeCount];
+    long rangeCount = TGLExposedGeometryItemRanges(&replay->exposedGeometry, -frame->contentInsetTop, frame->boundsHeight - frame->contentInsetTop, first, end);
+    long itemCount = 0;
+
+    for (long range = 0; range < rangeCount; range++) {
+
+        TGLReplayReserve(replay, end[range] - first[range]);
+        TGLExposedGeometryGetItems(&replay->exposedGeometry, first[range], end[range] - first[range], replay->originY, replay->flags);
+
+        for (long item = first[range]; item < end[range]; item++) TGLReplayHashItem(replay, item, replay->originY[item - first[range]], replay->flags[item - first[range]]);
+
+        itemCount += end[range] - first[range];
+    }
+
+    return itemCount;
+}
+
+static long TGLReplayTransition(TGLReplay *replay, const TGLLayoutTraceFrame *frame) {
+
+    // Transition layout interpolates attributes of
+    // items visible in either layout, going from
+    // exposed to stacked with increasing progress
+    //
+    double progress = frame->transitionProgress;
+    long first[TGLExposedGeometryMaxRangeCount + 1], end[TGLExposedGeometryMaxRangeCount + 1];
+    long rangeCount = TGLExposedGeometryItemRanges(&replay->exposedGeometry, -frame->contentInsetTop, frame->boundsHeight - frame->contentInsetTop, first, end);
+    long itemCount = 0;
+
+    TGLStackedGeometryItemRange(&replay->stackedGeometry, frame->contentOffset, frame->contentOffset + frame->boundsHeight, &first[rangeCount], &end[rangeCount]);
+
+    rangeCount += 1;
+
+    for (long range = 0; range < rangeCount; range++) {
+
+        for (long item = first[range]; item < end[range]; item++) {
+
+            double exposedY = TGLExposedGeometryOriginY(&replay->exposedGeometry, item);
+            double stackedY = TGLStackedGeometryOriginY(&replay->stackedGeometry, item);
+            TGLLayoutItemFlags flags = (progress < 0.5) ? TGLExposedGeometryFlags(&replay->exposedGeometry, item) : TGLStackedGeometryFlags(&replay->stackedGeometry, item);
+
+            TGLReplayHashItem(replay, item, exposedY + (stackedY - exposedY) * progress, flags);
+        }
+
+        itemCount += end[range] - first[range];
+    }
+
+    return itemCount;
+}
+
+static int TGLReplayCompareDurations(const void *a, const void *b) {
+
+    double lhs = *(const double *)a, rhs = *(const double *)b;
+
+    return (lhs > rhs) - (lhs < rhs);
+}
+
+// MARK: - Main
+
+int main(int argc, const char *argv[]) {
+
+    bool printingFrames = (argc > 2 && strcmp(argv[1], "-f") == 0);
+    const char *path = argv[argc - 1];
+
+    if (argc < 2 || (argc > 2 && !printingFrames)) {
+
+        fprintf(stderr, "usage: %s [-f] trace\n", argv[0]);
+
+        return 2;
+    }
+
+    size_t length = 0;
+    char *bytes = TGLReplayReadFile(path, &length);
+    TGLReplay replay = { .firstCompressingItem = -1, .checksum = 14695981039346656037ULL };
+
+    if (bytes == NULL || !TGLLayoutTraceDecodeHeader((const unsigned char *)bytes, length, &replay.header)) {
+
+        fprintf(stderr, "%s: not a layout trace\n", path);
+
+        free(bytes);
+
+        return 1;
+    }
+
+    // Decode all frames up front, so
+    // that timings cover layout only
+    //
+    size_t offset = TGLLayoutTraceHeaderSize;
+    long frameCount = 0, frameCapacity = 1024;
+    TGLLayoutTraceFrame *frames = malloc(frameCapacity * sizeof(TGLLayoutTraceFrame));
+    TGLLayoutTraceFrame frame;
+
+    TGLLayoutTraceFrameInit(&frame);
+
+    while (offset < length) {
+
+        size_t frameLength = TGLLayoutTraceDecodeFrame((const unsigned char *)bytes + offset, length - offset, &frame);
+
+        if (frameLength == 0) {
+
+            fprintf(stderr, "%s: truncated at byte %zu\n", path, offset);
+
+            break;
+        }
+
+        if (frameCount == frameCapacity) {
+
+            frameCapacity *= 2;
+            frames = realloc(frames, frameCapacity * sizeof(TGLLayoutTraceFrame));
+        }
+
+        frames[frameCount++] = frame;
+        offset += frameLength;
+    }
+
+    double *durations = malloc((frameCount > 0 ? frameCount : 1) * sizeof(double));
+    unsigned long long touchedItems = 0;
+    double totalDuration = 0.0;
+
+    for (long index = 0; index < frameCount; index++) {
+
+        const TGLLayoutTraceFrame *current = &frames[index];
+        TGLReplayMode mode = TGLReplayModeStacked;
+
+        if (current->transitionProgress >= 0.0) {
+
+            mode = TGLReplayModeTransition;
+
+        } else if (current->exposedItem >= 0) {
+
+            mode = TGLReplayModeExposed;
+        }
+
+        double startTime = TGLReplayNow();
+        long itemCount = 0;
+
+        switch (mode) {
+
+            case TGLReplayModeStacked:
+
+                TGLReplayPrepareStacked(&replay, current);
+                itemCount = TGLReplayStacked(&replay, current);
+                break;
+
+            case TGLReplayModeExposed:
+
+                TGLReplayPrepareExposed(&replay, current);
+                itemCount = TGLReplayExposed(&replay, current);
+                break;
+
+            case TGLReplayModeTransition:
+
+                TGLReplayPrepareStacked(&replay, current);
+                TGLReplayPrepareExposed(&replay, current);
+                itemCount = TGLReplayTransition(&replay, current);
+                break;
+        }
+
+        durations[index] = TGLReplayNow() - startTime;
+        totalDuration += durations[index];
+        touchedItems += itemCount;
+
+        if (printingFrames) {
+
+            printf("{\"frame\":%ld,\"time\":%.6f,\"mode\":\"%s\",\"items\":%ld,\"ns\":%.1f}\n", index, current->time, TGLReplayModeNames[mode], itemCount, durations[index]);
+        }
+    }
+
+    qsort(durations, frameCount, sizeof(double), TGLReplayCompareDurations);
+
+    double medianDuration = (frameCount > 0) ? durations[frameCount / 2] : 0.0;
+    double p99Duration = (frameCount > 0) ? durations[(long)(0.99 * (frameCount - 1))] : 0.0;
+    double maxDuration = (frameCount > 0) ? durations[frameCount - 1] : 0.0;
+
+    printf("{\"trace\":\"%s\",\"frames\":%ld,\"seconds\":%.3f,\"ns_per_frame\":%.1f,\"ns_p50\":%.1f,\"ns_p99\":%.1f,\"ns_max\":%.1f,\"items_per_frame\":%.2f,\"checksum\":\"%016llx\"}\n",
+           path, frameCount, (frameCount > 0) ? frames[frameCount - 1].time : 0.0, (frameCount > 0) ? totalDuration / frameCount : 0.0,
+           medianDuration, p99Duration, maxDuration, (frameCount > 0) ? (double)touchedItems / frameCount : 0.0, replay.checksum);
+
+    free(durations);
+    free(frames);
+    free(bytes);
+    free(replay.originY);
+    free(replay.flags);
+
+    return 0;
+}
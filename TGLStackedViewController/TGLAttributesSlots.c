@@ -0,0 +1,427 @@
+//
+//  TGLAttributesSlots.c
+//  TGLStackedViewController
+//
+//  Created by Tim Gleue on 17.10.26.
+//  Copyright (c) 2026 Tim Gleue ( http://gleue-interactive.com )
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+#include "TGLAttributesSlots.h"
+
+#include <limits.h>
+#include <stdlib.h>
+
+// Initial number of slots and window entries,
+// both grown geometrically when needed
+//
+#define TGLAttributesSlotsInitialCount 64
+
+void TGLAttributesSlotsInit(TGLAttributesSlots *slots, long capacity, TGLAttributesSlotsCreateFunction create, TGLAttributesSlotsRelabelFunction relabel, TGLAttributesSlotsRecycleFunction recycle, void *context) {
+
+    slots->create = create;
+    slots->relabel = relabel;
+    slots->recycle = recycle;
+    slots->context = context;
+
+    slots->capacity = capacity;
+    slots->itemCount = 0;
+    slots->generation = 0;
+
+    slots->slotCount = 0;
+    slots->slotCapacity = 0;
+    slots->slotItems = NULL;
+    slots->slotGenerations = NULL;
+    slots->slotObjects = NULL;
+    slots->spareGenerations = NULL;
+    slots->spareObjects = NULL;
+
+    slots->windowFirst = 0;
+    slots->windowEnd = 0;
+    slots->windowMask = -1;
+    slots->window = NULL;
+}
+
+void TGLAttributesSlotsFree(TGLAttributesSlots *slots) {
+
+    TGLAttributesSlotsRemoveAll(slots);
+
+    free(slots->slotItems);
+    free(slots->slotGenerations);
+    free(slots->slotObjects);
+    free(slots->spareGenerations);
+    free(slots->spareObjects);
+    free(slots->window);
+
+    slots->slotItems = NULL;
+    slots->slotGenerations = NULL;
+    slots->slotObjects = NULL;
+    slots->spareGenerations = NULL;
+    slots->spareObjects = NULL;
+    slots->window = NULL;
+    slots->slotCapacity = 0;
+    slots->windowMask = -1;
+}
+
+// MARK: - Helpers
+
+static bool TGLAttributesSlotsReusable(const TGLAttributesSlots *slots, unsigned long generation) {
+
+    // UIKit may hold objects handed
+    // out during the current or the
+    // previous pass
+    //
+    return generation + 2 <= slots->generation;
+}
+
+static void TGLAttributesSlotsRecycleSlot(TGLAttributesSlots *slots, long slot) {
+
+    slots->recycle(slots->context, slots->slotObjects[slot], TGLAttributesSlotsReusable(slots, slots->slotGenerations[slot]));
+
+    if (slots->spareObjects[slot]) slots->recycle(slots->context, slots->spareObjects[slot], TGLAttributesSlotsReusable(slots, slots->spareGenerations[slot]));
+
+    slots->slotObjects[slot] = NULL;
+    slots->spareObjects[slot] = NULL;
+}
+
+static void TGLAttributesSlotsMoveSlot(TGLAttributesSlots *slots, long slot, long target) {
+
+    if (slot == target) return;
+
+    slots->slotItems[target] = slots->slotItems[slot];
+    slots->slotGenerations[target] = slots->slotGenerations[slot];
+    slots->slotObjects[target] = slots->slotObjects[slot];
+    slots->spareGenerations[target] = slots->spareGenerations[slot];
+    slots->spareObjects[target] = slots->spareObjects[slot];
+}
+
+static long TGLAttributesSlotsFind(const TGLAttributesSlots *slots, long item) {
+
+    if (item < slots->windowFirst || item >= slots->windowEnd) return -1;
+
+    return slots->window[item & slots->windowMask];
+}
+
+static void TGLAttributesSlotsClearWindow(TGLAttributesSlots *slots) {
+
+    // Entries outside the window are
+    // kept empty, so clearing those of
+    // resident items suffices
+    //
+    for (long slot = 0; slot < slots->slotCount; slot++) slots->window[slots->slotItems[slot] & slots->windowMask] = -1;
+
+    slots->windowFirst = 0;
+    slots->windowEnd = 0;
+}
+
+static void TGLAttributesSlotsResizeWindow(TGLAttributesSlots *slots, long length) {
+
+    // Items in the window map to distinct
+    // entries as long as it spans at most
+    // as many items as there are entries
+    //
+    long size = TGLAttributesSlotsInitialCount;
+
+    while (size < 2 * length) size *= 2;
+
+    free(slots->window);
+
+    slots->window = malloc(size * sizeof(long));
+    slots->windowMask = size - 1;
+
+    for (long i = 0; i < size; i++) slots->window[i] = -1;
+
+    for (long slot = 0; slot < slots->slotCount; slot++) slots->window[slots->slotItems[slot] & slots->windowMask] = slot;
+}
+
+static void TGLAttributesSlotsInsertWindow(TGLAttributesSlots *slots, long slot) {
+
+    long item = slots->slotItems[slot];
+
+    if (slots->windowFirst == slots->windowEnd) {
+
+        slots->windowFirst = item;
+        slots->windowEnd = item + 1;
+
+    } else {
+
+        if (item < slots->windowFirst) slots->windowFirst = item;
+        if (item >= slots->windowEnd) slots->windowEnd = item + 1;
+    }
+
+    if (slots->windowEnd - slots->windowFirst > slots->windowMask + 1) {
+
+        // Entries of all slots including
+        // `slot` are set when resizing
+        //
+        TGLAttributesSlotsResizeWindow(slots, slots->windowEnd - slots->windowFirst);
+
+    } else {
+
+        slots->window[item & slots->windowMask] = slot;
+    }
+}
+
+static void TGLAttributesSlotsFitWindow(TGLAttributesSlots *slots) {
+
+    long first = LONG_MAX;
+    long end = 0;
+
+    for (long slot = 0; slot < slots->slotCount; slot++) {
+
+        if (slots->slotItems[slot] < first) first = slots->slotItems[slot];
+        if (slots->slotItems[slot] >= end) end = slots->slotItems[slot] + 1;
+    }
+
+    if (first >= end) first = end = 0;
+
+    slots->windowFirst = first;
+    slots->windowEnd = end;
+
+    // Shrink window spanning far more
+    // items than resident after a jump
+    //
+    if (slots->windowMask + 1 > TGLAttributesSlotsInitialCount && slots->windowMask + 1 > 8 * (end - first)) TGLAttributesSlotsResizeWindow(slots, end - first);
+}
+
+static void TGLAttributesSlotsGrow(TGLAttributesSlots *slots) {
+
+    long capacity = 2 * slots->slotCapacity;
+
+    if (capacity < TGLAttributesSlotsInitialCount) capacity = TGLAttributesSlotsInitialCount;
+
+    slots->slotItems = realloc(slots->slotItems, capacity * sizeof(long));
+    slots->slotGenerations = realloc(slots->slotGenerations, capacity * sizeof(unsigned long));
+    slots->slotObjects = realloc(slots->slotObjects, capacity * sizeof(void *));
+    slots->spareGenerations = realloc(slots->spareGenerations, capacity * sizeof(unsigned long));
+    slots->spareObjects = realloc(slots->spareObjects, capacity * sizeof(void *));
+    slots->slotCapacity = capacity;
+
+    if (slots->window == NULL) TGLAttributesSlotsResizeWindow(slots, 0);
+}
+
+static void TGLAttributesSlotsRecycleOutside(TGLAttributesSlots *slots, unsigned long generation, long first, long last) {
+
+    // Recycles objects of items outside
+    // `[first, last]` unless handed out
+    // during pass `generation`
+    //
+    long count = 0;
+
+    for (long slot = 0; slot < slots->slotCount; slot++) {
+
+        long item = slots->slotItems[slot];
+
+        if (slots->slotGenerations[slot] == generation || (item >= first && item <= last)) {
+
+            TGLAttributesSlotsMoveSlot(slots, slot, count);
+
+            slots->window[item & slots->windowMask] = count++;
+
+        } else {
+
+            TGLAttributesSlotsRecycleSlot(slots, slot);
+
+            slots->window[item & slots->windowMask] = -1;
+        }
+    }
+
+    if (count < slots->slotCount) {
+
+        slots->slotCount = count;
+
+        TGLAttributesSlotsFitWindow(slots);
+    }
+}
+
+static void TGLAttributesSlotsTrimForItem(TGLAttributesSlots *slots, long item) {
+
+    long first = (item < slots->windowFirst) ? item : slots->windowFirst;
+    long end = (item >= slots->windowEnd) ? item + 1 : slots->windowEnd;
+
+    if (slots->windowFirst == slots->windowEnd || end - first <= slots->windowMask + 1) return;
+
+    // Before growing the window after a jump
+    // recycle objects not used in the current
+    // pass and far from `item`, e.g. those of
+    // items scrolled past
+    //
+    TGLAttributesSlotsRecycleOutside(slots, slots->generation, item - slots->capacity, item + slots->capacity);
+}
+
+// MARK: - Passes
+
+void TGLAttributesSlotsPrepare(TGLAttributesSlots *slots, long itemCount) {
+
+    if (itemCount < 0) itemCount = 0;
+
+    if (itemCount != slots->itemCount) {
+
+        // Item indices are no longer valid, but
+        // objects can be reused anyway
+        //
+        TGLAttributesSlotsRemoveAll(slots);
+
+        slots->itemCount = itemCount;
+    }
+
+    slots->generation++;
+
+    // Recycle objects of items far from those
+    // used in the last pass, so that slots
+    // don't grow with every item ever visible
+    // and objects are recycled at the rate new
+    // items become visible when scrolling
+    //
+    unsigned long lastGeneration = slots->generation - 1;
+    long first = LONG_MAX;
+    long last = -1;
+
+    for (long slot = 0; slot < slots->slotCount; slot++) {
+
+        if (slots->slotGenerations[slot] != lastGeneration) continue;
+
+        if (slots->slotItems[slot] < first) first = slots->slotItems[slot];
+        if (slots->slotItems[slot] > last) last = slots->slotItems[slot];
+    }
+
+    // Keep everything if the last
+    // pass didn't use any objects
+    //
+    if (last < 0) return;
+
+    TGLAttributesSlotsRecycleOutside(slots, lastGeneration, first - slots->capacity, last + slots->capacity);
+}
+
+void TGLAttributesSlotsRemoveAll(TGLAttributesSlots *slots) {
+
+    if (slots->slotCount == 0) return;
+
+    TGLAttributesSlotsClearWindow(slots);
+
+    for (long slot = 0; slot < slots->slotCount; slot++) TGLAttributesSlotsRecycleSlot(slots, slot);
+
+    slots->slotCount = 0;
+}
+
+void TGLAttributesSlotsUpdate(TGLAttributesSlots *slots, long itemCount, TGLAttributesSlotsMapFunction map, void *mapContext) {
+
+    if (itemCount < 0) itemCount = 0;
+
+    // Compact slots in place, assigning new
+    // item indices and recycling objects of
+    // deleted items, while re-inserting kept
+    // ones into the emptied window
+    //
+    long total = slots->slotCount;
+
+    TGLAttributesSlotsClearWindow(slots);
+
+    slots->slotCount = 0;
+
+    for (long slot = 0; slot < total; slot++) {
+
+        long item = map(mapContext, slots->slotItems[slot]);
+
+        if (item < 0 || item >= itemCount || TGLAttributesSlotsFind(slots, item) >= 0) {
+
+            TGLAttributesSlotsRecycleSlot(slots, slot);
+
+            continue;
+        }
+
+        // Spare objects would have to be
+        // relabeled, too, but are recreated
+        // more cheaply when needed again
+        //
+        if (slots->spareObjects[slot]) slots->recycle(slots->context, slots->spareObjects[slot], TGLAttributesSlotsReusable(slots, slots->spareGenerations[slot]));
+
+        slots->spareObjects[slot] = NULL;
+        slots->slotObjects[slot] = slots->relabel(slots->context, slots->slotObjects[slot], item, TGLAttributesSlotsReusable(slots, slots->slotGenerations[slot]));
+        slots->slotItems[slot] = item;
+
+        long target = slots->slotCount++;
+
+        TGLAttributesSlotsMoveSlot(slots, slot, target);
+        TGLAttributesSlotsInsertWindow(slots, target);
+    }
+
+    slots->itemCount = itemCount;
+}
+
+void TGLAttributesSlotsPreserve(TGLAttributesSlots *slots, long first, long count) {
+
+    unsigned long lastGeneration = slots->generation - 1;
+
+    for (long slot = 0; slot < slots->slotCount; slot++) {
+
+        long item = slots->slotItems[slot];
+
+        if (slots->slotGenerations[slot] == lastGeneration && item >= first && item - first < count) slots->slotGenerations[slot] = slots->generation;
+    }
+}
+
+// MARK: - Objects
+
+void *TGLAttributesSlotsObject(const TGLAttributesSlots *slots, long item) {
+
+    if (item < 0 || item >= slots->itemCount) return NULL;
+
+    long slot = TGLAttributesSlotsFind(slots, item);
+
+    if (slot < 0 || slots->slotGenerations[slot] != slots->generation) return NULL;
+
+    return slots->slotObjects[slot];
+}
+
+void *TGLAttributesSlotsDequeue(TGLAttributesSlots *slots, long item) {
+
+    long slot = TGLAttributesSlotsFind(slots, item);
+
+    if (slot < 0) {
+
+        TGLAttributesSlotsTrimForItem(slots, item);
+
+        if (slots->slotCount == slots->slotCapacity) TGLAttributesSlotsGrow(slots);
+
+        slot = slots->slotCount++;
+
+        slots->slotItems[slot] = item;
+        slots->slotObjects[slot] = slots->create(slots->context, item);
+        slots->spareObjects[slot] = NULL;
+
+        TGLAttributesSlotsInsertWindow(slots, slot);
+
+    } else if (slots->slotGenerations[slot] + 1 == slots->generation) {
+
+        // Handed out during the last pass, so
+        // switch to the spare object, which
+        // was handed out before if at all
+        //
+        void *object = slots->spareObjects[slot];
+
+        slots->spareObjects[slot] = slots->slotObjects[slot];
+        slots->spareGenerations[slot] = slots->slotGenerations[slot];
+        slots->slotObjects[slot] = object ? object : slots->create(slots->context, item);
+    }
+
+    slots->slotGenerations[slot] = slots->generation;
+
+    return slots->slotObjects[slot];
+}
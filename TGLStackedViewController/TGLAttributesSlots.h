@@ -0,0 +1,137 @@
+//
+//  TGLAttributesSlots.h
+//  TGLStackedViewController
+//
+//  Created by Tim Gleue on 17.10.26.
+//  Copyright (c) 2026 Tim Gleue ( http://gleue-interactive.com )
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+#ifndef TGLAttributesSlots_h
+#define TGLAttributesSlots_h
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Platform-neutral bookkeeping of layout attribute objects by item.
+ *
+ * Objects are kept for resident items only, each in a slot
+ * found through a direct-mapped window array spanning the
+ * resident items. Memory therefore depends on the number of
+ * resident items and their spread, not on the item count.
+ *
+ * Objects handed out during a layout pass are not modified
+ * during the next one, since UIKit may still hold them, e.g.
+ * for animations. Each slot double-buffers two objects used
+ * in alternating passes instead, and objects are recycled
+ * as reusable only if not handed out during the current or
+ * previous pass.
+ *
+ * Objects are opaque here and created, relabeled and
+ * recycled by callbacks, e.g. bridging to UIKit.
+ *
+ * Functions in this file do not depend on UIKit or Foundation.
+ */
+
+/** Returns a new or recycled object for `item` */
+typedef void *(*TGLAttributesSlotsCreateFunction)(void *context, long item);
+
+/** Returns `object` assigned to `item`, either `object` modified in place if `reusable` or a copy, giving up `object` */
+typedef void *(*TGLAttributesSlotsRelabelFunction)(void *context, void *object, long item, bool reusable);
+
+/** Gives up `object`, which may be reused for other items if `reusable` */
+typedef void (*TGLAttributesSlotsRecycleFunction)(void *context, void *object, bool reusable);
+
+/** Returns the index after an update of the item at index `item` before it, or -1 if it was deleted */
+typedef long (*TGLAttributesSlotsMapFunction)(void *context, long item);
+
+typedef struct {
+
+    TGLAttributesSlotsCreateFunction create;
+    TGLAttributesSlotsRelabelFunction relabel;
+    TGLAttributesSlotsRecycleFunction recycle;
+    void *context;
+
+    long capacity;                  /* Distance in items from the last pass's items up to which objects are kept */
+    long itemCount;
+    unsigned long generation;       /* Current layout pass */
+
+    long slotCount;
+    long slotCapacity;
+    long *slotItems;
+    unsigned long *slotGenerations; /* Pass the object of each slot was last handed out in */
+    void **slotObjects;
+    unsigned long *spareGenerations;/* Pass the spare object of each slot was last handed out in */
+    void **spareObjects;            /* Object of an earlier pass or `NULL` */
+
+    long windowFirst;               /* Resident items are in `[windowFirst, windowEnd)` */
+    long windowEnd;
+    long windowMask;                /* Size of `window` minus one, a power of two */
+    long *window;                   /* Slot of each item at `item & windowMask` or -1 */
+
+} TGLAttributesSlots;
+
+/** Prepares empty slots keeping objects within `capacity` items of those used in the last pass */
+void TGLAttributesSlotsInit(TGLAttributesSlots *slots, long capacity, TGLAttributesSlotsCreateFunction create, TGLAttributesSlotsRelabelFunction relabel, TGLAttributesSlotsRecycleFunction recycle, void *context);
+
+/** Recycles all objects and frees memory used by `slots` */
+void TGLAttributesSlotsFree(TGLAttributesSlots *slots);
+
+/** Starts a new layout pass for `itemCount` items in total
+ *
+ * Objects of items further than `capacity` items from
+ * those used in the last pass are recycled. All objects
+ * are recycled if the item count changed.
+ */
+void TGLAttributesSlotsPrepare(TGLAttributesSlots *slots, long itemCount);
+
+/** Recycles all objects */
+void TGLAttributesSlotsRemoveAll(TGLAttributesSlots *slots);
+
+/** Moves objects to new item indices after a batch update
+ *
+ * Objects of deleted items and spare objects are recycled,
+ * others relabeled. Cost is linear in the number of slots,
+ * not in `itemCount`.
+ */
+void TGLAttributesSlotsUpdate(TGLAttributesSlots *slots, long itemCount, TGLAttributesSlotsMapFunction map, void *mapContext);
+
+/** Keeps objects handed out during the last pass for items in `[first, first + count)` valid for the current pass */
+void TGLAttributesSlotsPreserve(TGLAttributesSlots *slots, long first, long count);
+
+/** Returns the object of `item` if already handed out during the current pass, `NULL` otherwise */
+void *TGLAttributesSlotsObject(const TGLAttributesSlots *slots, long item);
+
+/** Returns an object for `item` to be handed out during the current pass
+ *
+ * The object is the one already handed out for `item`
+ * during the current pass, one used for it before the
+ * last pass, or a created one. An object handed out
+ * during the last pass is never returned.
+ */
+void *TGLAttributesSlotsDequeue(TGLAttributesSlots *slots, long item);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TGLAttributesSlots_h */
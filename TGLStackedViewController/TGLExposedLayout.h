@@ -25,6 +25,10 @@
 
 #import <UIKit/UIKit.h>
 
+#import "TGLItemSizeCache.h"
+#import "TGLLayoutAttributesPool.h"
+#import "TGLLayoutMetrics.h"
+
 typedef NS_ENUM(NSInteger, TGLExposedLayoutPinningMode) {
 
     TGLExposedLayoutPinningModeNone = 0,    /* Do not pin unexpsed items */
@@ -71,6 +75,73 @@ typedef NS_ENUM(NSInteger, TGLExposedLayoutPinningMode) {
 /** The number of items below the exposed item to be pinned or `-1` for all. Default -1 */
 @property (assign, nonatomic) NSInteger bottomPinningCount;
 
+/** Set to YES to size the exposed item to fit its content. Default `NO`
+ *
+ * The height the exposed item's cell returns from
+ * -preferredLayoutAttributesFittingAttributes: is stored
+ * in -measuredSizeCache and used instead of -itemSize,
+ * limited to the available height. Other items keep
+ * -itemSize, so items are measured only when exposed.
+ */
+@property (assign, nonatomic) BOOL sizesExposedItemToFit;
+
+/** Sizes measured for exposed items. Default is an empty cache
+ *
+ * Share a cache between layouts, e.g. with a stacked
+ * layout, to keep measured sizes across expose and
+ * collapse and in sync with batch updates.
+ */
+@property (nonatomic, strong) TGLItemSizeCache *measuredSizeCache;
+
+/** Metrics object to record layout performance to or `nil` to record nothing. Default is `nil` */
+@property (nonatomic, strong) TGLLayoutMetrics *metrics;
+
+/** Pool to recycle layout attributes objects to. Default is a private pool, setting `nil` restores one
+ *
+ * Layouts sharing a pool return attributes not used
+ * during their last pass to it, so that spare objects
+ * of all layouts are bounded by the pool's capacity.
+ */
+@property (nonatomic, strong) TGLLayoutAttributesPool *attributesPool;
+
+/** Index path of exposed item.
+ *
+ * Set this property when the exposed item's index path
+ * changes due to batch updates, from within the updates
+ * block, to keep the same item exposed.
+ */
+@property (nonatomic, strong) NSIndexPath *exposedItemIndexPath;
+
+/** Exposes item at `exposedItemIndexPath`.
+ *
+ * Items of all sections are stacked one after
+ * another with collapsed items above and below
+ * the exposed item possibly spanning sections.
+ */
+- (instancetype)initWithExposedItemIndexPath:(NSIndexPath *)exposedItemIndexPath;
+
+/** Exposes item `exposedItemIndex` in section 0 */
 - (instancetype)initWithExposedItemIndex:(NSInteger)exposedItemIndex;
 
+/** Computes geometry and visible items' attributes for `collectionView` before the layout is installed.
+ *
+ * Use this to prepare a layout speculatively, e.g. when
+ * the user touches an item that is about to be exposed.
+ * The first layout pass after installation reuses the
+ * results unless the collection view's size, insets or
+ * item counts changed in between. Set all properties
+ * before calling this method.
+ */
+- (void)prepareLayoutForCollectionView:(UICollectionView *)collectionView;
+
+/** Returns YES if the cell of the item at `indexPath` has to measure its size.
+ *
+ * This is the case for the exposed item only when
+ * -sizesExposedItemToFit is set and its size is not
+ * in -measuredSizeCache yet. Call this from the cell's
+ * -preferredLayoutAttributesFittingAttributes: to skip
+ * measuring otherwise.
+ */
+- (BOOL)shouldMeasureItemAtIndexPath:(NSIndexPath *)indexPath;
+
 @end
@@ -24,12 +24,55 @@
 //  THE SOFTWARE.
 
 #import "TGLExposedLayout.h"
+#import "TGLLayoutAttributesStore.h"
+#import "TGLLayoutGeometry.h"
 
-@interface TGLExposedLayout ()
+@interface TGLExposedLayout () {
 
-@property (assign, nonatomic) NSInteger exposedItemIndex;
+    // Geometry of current layout pass
+    // computed in -prepareLayout
+    //
+    TGLExposedGeometry _geometry;
+
+    // Sections are stacked one after another,
+    // items are addressed by global index
+    //
+    TGLSectionTable _sections;
+    TGLSectionTable _previousSections;
 
-@property (nonatomic, strong) NSDictionary *layoutAttributes;
+    // Allocations of attributes store
+    // already reported to -metrics
+    //
+    NSUInteger _recordedAllocationCount;
+}
+
+@property (nonatomic, strong) TGLLayoutAttributesStore *attributesStore;
+
+// Frame of items before being moved vertically
+//
+@property (nonatomic, assign) CGRect itemFrame;
+
+// Set to YES when data source counts changed
+// due to batch updates. Attributes are then
+// moved to their new items in
+// -prepareForCollectionViewUpdates:
+//
+@property (nonatomic, assign) BOOL invalidatingDataSourceCounts;
+@property (nonatomic, assign) BOOL deferringUpdates;
+
+// Set to YES by -prepareLayoutForCollectionView:
+// with the collection view's size and insets
+// the layout was prepared for in advance
+//
+@property (nonatomic, assign) BOOL preparedInAdvance;
+@property (nonatomic, assign) CGSize preparedBoundsSize;
+@property (nonatomic, assign) UIEdgeInsets preparedContentInset;
+
+// Items inserted and attributes of items deleted
+// during current batch update
+//
+@property (nonatomic, strong) NSMutableSet *insertedIndexPaths;
+@property (nonatomic, strong) NSMutableDictionary *disappearingAttributes;
 
 @end
 
@@ -37,6 +80,11 @@
 
 - (instancetype)initWithExposedItemIndex:(NSInteger)exposedItemIndex {
     
+    return [self initWithExposedItemIndexPath:[NSIndexPath indexPathForItem:exposedItemIndex inSection:0]];
+}
+
+- (instancetype)initWithExposedItemIndexPath:(NSIndexPath *)exposedItemIndexPath {
+    
     self = [super init];
     
     if (self) {
@@ -50,14 +98,58 @@
         self.topPinningCount = -1;
         self.bottomPinningCount = -1;
         
-        self.exposedItemIndex = exposedItemIndex;
+        _exposedItemIndexPath = exposedItemIndexPath;
+        _measuredSizeCache = [[TGLItemSizeCache alloc] init];
+
+        self.attributesStore = [[TGLLayoutAttributesStore alloc] init];
+
+        TGLSectionTableInit(&_sections);
+        TGLSectionTableInit(&_previousSections);
+
+        __weak typeof(self) weakSelf = self;
+
+        self.attributesStore.indexPathForItem = ^NSIndexPath *(NSInteger item) {
+            
+            return [weakSelf indexPathForItem:item];
+        };
     }
     
     return self;
 }
 
+- (void)dealloc {
+    
+    TGLSectionTableFree(&_sections);
+    TGLSectionTableFree(&_previousSections);
+}
+
 #pragma mark - Accessors
 
+- (TGLLayoutAttributesPool *)attributesPool {
+
+    return self.attributesStore.pool;
+}
+
+- (void)setAttributesPool:(TGLLayoutAttributesPool *)attributesPool {
+
+    // Keep attributes of items used during the
+    // last pass only when sharing a pool, and
+    // return all others to it
+    //
+    self.attributesStore.pool = attributesPool ?: [[TGLLayoutAttributesPool alloc] init];
+    self.attributesStore.capacity = attributesPool ? 0 : self.attributesStore.pool.capacity;
+}
+
+- (void)setExposedItemIndexPath:(NSIndexPath *)exposedItemIndexPath {
+    
+    if (![exposedItemIndexPath isEqual:self.exposedItemIndexPath]) {
+        
+        _exposedItemIndexPath = exposedItemIndexPath;
+        
+        [self invalidateLayout];
+    }
+}
+
 - (void)setLayoutMargin:(UIEdgeInsets)margins {
     
     if (!UIEdgeInsetsEqualToEdgeInsets(margins, self.layoutMargin)) {
@@ -108,6 +200,26 @@
     }
 }
 
+- (void)setSizesExposedItemToFit:(BOOL)sizesExposedItemToFit {
+    
+    if (sizesExposedItemToFit != self.sizesExposedItemToFit) {
+        
+        _sizesExposedItemToFit = sizesExposedItemToFit;
+        
+        [self invalidateLayout];
+    }
+}
+
+- (void)setMeasuredSizeCache:(TGLItemSizeCache *)measuredSizeCache {
+    
+    if (measuredSizeCache != self.measuredSizeCache) {
+        
+        _measuredSizeCache = measuredSizeCache;
+        
+        [self invalidateLayout];
+    }
+}
+
 #pragma mark - Layout computation
 
 - (CGPoint)targetContentOffsetForProposedContentOffset:(CGPoint)proposedContentOffset {
@@ -119,165 +231,528 @@
 
 - (CGSize)collectionViewContentSize {
 
-    CGSize contentSize = self.collectionView.bounds.size;
+    return [self contentSizeForCollectionView:self.collectionView];
+}
+
+- (void)invalidateLayoutWithContext:(UICollectionViewLayoutInvalidationContext *)context {
     
-    contentSize.height -= self.collectionView.contentInset.top + self.collectionView.contentInset.bottom;
+    if (context.invalidateDataSourceCounts && !context.invalidateEverything) {
+        
+        self.invalidatingDataSourceCounts = YES;
+    }
     
-    return contentSize;
+    [super invalidateLayoutWithContext:context];
 }
 
 - (void)prepareLayout {
     
-    CGSize layoutSize = CGSizeMake(CGRectGetWidth(self.collectionView.bounds) - self.layoutMargin.left - self.layoutMargin.right,
-                                   CGRectGetHeight(self.collectionView.bounds) - self.layoutMargin.top - self.layoutMargin.bottom);
+    TGLLayoutMetrics *metrics = self.metrics;
+    CFTimeInterval startTime = metrics ? CACurrentMediaTime() : 0.0;
+
+    // Allocations since the last report, e.g. by
+    // item queries, belong to the previous pass
+    //
+    if (metrics) [metrics beginPassWithAllocationCount:[self unrecordedAllocationCount]];
+
+    // Batch updates not finished properly
+    // leave attributes in an unknown state
+    //
+    [self finishDeferredUpdates];
+
+    BOOL updating = self.invalidatingDataSourceCounts;
+
+    self.invalidatingDataSourceCounts = NO;
+
+    if (self.preparedInAdvance) {
+        
+        self.preparedInAdvance = NO;
+        
+        // Geometry and attributes prepared in advance
+        // are still valid if neither size nor items
+        // changed since
+        //
+        if (!updating && CGSizeEqualToSize(self.preparedBoundsSize, self.collectionView.bounds.size) && UIEdgeInsetsEqualToEdgeInsets(self.preparedContentInset, self.collectionView.contentInset) && ![self updateSectionTableForCollectionView:self.collectionView]) {
+            
+            if (metrics) [metrics recordPassWithDuration:CACurrentMediaTime() - startTime allocationCount:[self unrecordedAllocationCount]];
+
+            return;
+        }
+        
+        // Attributes prepared in advance
+        // might belong to other items
+        //
+        [self.attributesStore removeAllAttributes];
+    }
+
+    if ([self prepareGeometryForCollectionView:self.collectionView] && !updating) {
+        
+        // Index paths of stored attributes
+        // are no longer valid
+        //
+        [self.attributesStore removeAllAttributes];
+    }
+
+    if (updating) {
+        
+        // Stored attributes are moved to their new
+        // items as soon as updates are known
+        //
+        self.deferringUpdates = YES;
+        
+    } else {
+        
+        [self prepareAttributesForCollectionView:self.collectionView];
+    }
+
+    if (metrics) [metrics recordPassWithDuration:CACurrentMediaTime() - startTime allocationCount:[self unrecordedAllocationCount]];
+}
+
+- (void)prepareLayoutForCollectionView:(UICollectionView *)collectionView {
+    
+    if (collectionView == nil) return;
+    
+    TGLLayoutMetrics *metrics = self.metrics;
+    CFTimeInterval startTime = metrics ? CACurrentMediaTime() : 0.0;
+
+    // Allocations since the last report, e.g. by
+    // item queries, belong to the previous pass
+    //
+    if (metrics) [metrics beginPassWithAllocationCount:[self unrecordedAllocationCount]];
+
+    if ([self prepareGeometryForCollectionView:collectionView]) [self.attributesStore removeAllAttributes];
+    
+    [self prepareAttributesForCollectionView:collectionView];
+    
+    self.preparedInAdvance = YES;
+    self.preparedBoundsSize = collectionView.bounds.size;
+    self.preparedContentInset = collectionView.contentInset;
+
+    if (metrics) [metrics recordPassWithDuration:CACurrentMediaTime() - startTime allocationCount:[self unrecordedAllocationCount]];
+}
+
+- (BOOL)prepareGeometryForCollectionView:(UICollectionView *)collectionView {
+    
+    CGSize contentSize = [self contentSizeForCollectionView:collectionView];
+    CGSize layoutSize = CGSizeMake(CGRectGetWidth(collectionView.bounds) - self.layoutMargin.left - self.layoutMargin.right,
+                                   CGRectGetHeight(collectionView.bounds) - self.layoutMargin.top - self.layoutMargin.bottom);
 
     CGSize itemSize = self.itemSize;
     
     if (itemSize.width == 0.0) itemSize.width = layoutSize.width;
-    if (itemSize.height == 0.0) itemSize.height = self.collectionViewContentSize.height - self.layoutMargin.top - self.layoutMargin.bottom;
+    if (itemSize.height == 0.0) itemSize.height = contentSize.height - self.layoutMargin.top - self.layoutMargin.bottom;
 
     CGFloat itemHorizontalOffset = 0.5 * (layoutSize.width - itemSize.width);
-    CGPoint itemOrigin = CGPointMake(self.layoutMargin.left + floor(itemHorizontalOffset), 0.0);
-    
-    NSMutableDictionary *layoutAttributes = [NSMutableDictionary dictionary];
-    NSInteger itemCount = [self.collectionView numberOfItemsInSection:0];
-    NSInteger bottomOverlapCount = self.bottomOverlapCount;
-    NSInteger bottomPinningCount = MIN(itemCount - self.exposedItemIndex - 1, self.bottomPinningCount);
-    
-    if (bottomPinningCount < 0) bottomPinningCount = itemCount - self.exposedItemIndex - 1;
 
-    NSInteger topPinningCount = self.topPinningCount;
+    self.itemFrame = CGRectMake(self.layoutMargin.left + floor(itemHorizontalOffset), 0.0, itemSize.width, itemSize.height);
     
-    if (topPinningCount < 0) topPinningCount = self.exposedItemIndex;
+    BOOL sectionsChanged = [self updateSectionTableForCollectionView:collectionView];
 
-    for (NSInteger item = 0; item < itemCount; item++) {
+    NSInteger itemCount = TGLSectionTableItemCount(&_sections);
+    NSInteger exposedItem = [self itemForIndexPath:self.exposedItemIndexPath];
+    CGFloat exposedItemHeight = 0.0;
 
-        NSIndexPath *indexPath = [NSIndexPath indexPathForItem:item inSection:0];
-        UICollectionViewLayoutAttributes *attributes = [UICollectionViewLayoutAttributes layoutAttributesForCellWithIndexPath:indexPath];
+    if (self.sizesExposedItemToFit && exposedItem != NSNotFound) {
         
-        // Cards overlap each other
-        // via z depth AND transform
-        //
-        // See http://stackoverflow.com/questions/12659301/uicollectionview-setlayoutanimated-not-preserving-zindex
-        //
-        // KLUDGE: translation is along negative
-        //         z axis as not to block scroll
-        //         indicators
+        // Layout does not scroll, so exposed
+        // item cannot exceed available height
         //
-        attributes.zIndex = item;
-        attributes.transform3D = CATransform3DMakeTranslation(0, 0, item - itemCount);
+        CGFloat measuredHeight = [self.measuredSizeCache sizeForItem:exposedItem].height;
 
-        if (item < self.exposedItemIndex) {
+        if (measuredHeight > 0.0) exposedItemHeight = MIN(measuredHeight, contentSize.height - self.layoutMargin.top - self.layoutMargin.bottom);
+    }
+
+    TGLExposedParameters parameters = {
+        
+        .itemCount = itemCount,
+        .exposedItem = (exposedItem != NSNotFound) ? exposedItem : 0,
+        .itemHeight = itemSize.height,
+        .exposedItemHeight = exposedItemHeight,
+        .marginTop = self.layoutMargin.top,
+        .marginBottom = self.layoutMargin.bottom,
+        .boundsHeight = CGRectGetHeight(collectionView.bounds),
+        .contentHeight = contentSize.height,
+        .topOverlap = self.topOverlap,
+        .bottomOverlap = self.bottomOverlap,
+        .bottomOverlapCount = self.bottomOverlapCount,
+        .pinning = (TGLExposedPinning)self.pinningMode,
+        .topPinningCount = self.topPinningCount,
+        .bottomPinningCount = self.bottomPinningCount
+    };
+    
+    TGLExposedGeometryPrepare(&_geometry, &parameters);
+    
+    return sectionsChanged;
+}
+
+- (void)prepareAttributesForCollectionView:(UICollectionView *)collectionView {
+    
+    [self.attributesStore prepareForItemCount:_geometry.parameters.itemCount];
+
+    // Only items visible in collection view are
+    // materialized up front, all others -- most
+    // of them hidden -- are created on demand
+    //
+    UIEdgeInsets contentInset = collectionView.contentInset;
+    CGRect visibleRect = CGRectMake(0.0, -contentInset.top, CGRectGetWidth(collectionView.bounds), CGRectGetHeight(collectionView.bounds));
+    long first[TGLExposedGeometryMaxRangeCount], end[TGLExposedGeometryMaxRangeCount];
+    long rangeCount = TGLExposedGeometryItemRanges(&_geometry, CGRectGetMinY(visibleRect), CGRectGetMaxY(visibleRect), first, end);
+    
+    for (long range = 0; range < rangeCount; range++) {
+        
+        for (NSInteger item = first[range]; item < end[range]; item++) {
             
-            if (self.pinningMode == TGLExposedLayoutPinningModeAll) {
+            [self dequeueAttributesForItem:item];
+        }
+    }
+}
+
+- (void)prepareForCollectionViewUpdates:(NSArray<UICollectionViewUpdateItem *> *)updateItems {
+    
+    [super prepareForCollectionViewUpdates:updateItems];
+    
+    self.insertedIndexPaths = [NSMutableSet set];
+    self.disappearingAttributes = [NSMutableDictionary dictionary];
+    
+    NSMutableIndexSet *deletedItems = [NSMutableIndexSet indexSet];
+    NSMutableIndexSet *insertedItems = [NSMutableIndexSet indexSet];
+    NSMutableArray *reloadedIndexPaths = [NSMutableArray array];
+    NSMutableDictionary<NSNumber *, NSNumber *> *movedItems = [NSMutableDictionary dictionary];
+    BOOL updatingSections = NO;
+    
+    for (UICollectionViewUpdateItem *updateItem in updateItems) {
+        
+        NSIndexPath *indexPathBeforeUpdate = updateItem.indexPathBeforeUpdate;
+        NSIndexPath *indexPathAfterUpdate = updateItem.indexPathAfterUpdate;
+        
+        if ((indexPathBeforeUpdate && indexPathBeforeUpdate.item == NSNotFound) || (indexPathAfterUpdate && indexPathAfterUpdate.item == NSNotFound)) {
+            
+            updatingSections = YES;
+            continue;
+        }
+        
+        switch (updateItem.updateAction) {
                 
-                NSInteger count = self.exposedItemIndex - item;
+            case UICollectionUpdateActionInsert:
                 
-                if (count > topPinningCount) {
-                    
-                    attributes.frame = CGRectMake(itemOrigin.x, self.collectionViewContentSize.height, itemSize.width, itemSize.height);
-                    attributes.hidden = YES;
-
-                } else {
+                [insertedItems addIndex:[self itemForIndexPath:indexPathAfterUpdate inSections:&_sections]];
+                [self.insertedIndexPaths addObject:indexPathAfterUpdate];
+                break;
+                
+            case UICollectionUpdateActionDelete: {
+                
+                NSInteger item = [self itemForIndexPath:indexPathBeforeUpdate inSections:&_previousSections];
+                UICollectionViewLayoutAttributes *attributes = self.deferringUpdates ? [self.attributesStore attributesForItem:item] : nil;
+                
+                if (attributes && !attributes.hidden) {
                     
-                    count += bottomPinningCount;
+                    // Let visible cards fade out in place
+                    //
+                    attributes = [attributes copy];
+                    attributes.alpha = 0.0;
                     
-                    attributes.frame = CGRectMake(itemOrigin.x, self.collectionViewContentSize.height - self.layoutMargin.bottom - count * self.bottomOverlap, itemSize.width, itemSize.height);
+                    self.disappearingAttributes[indexPathBeforeUpdate] = attributes;
                 }
-
-            } else {
                 
-                // Items before exposed item
-                // are aligned above top with
-                // amount -topOverlap
-                //
-                attributes.frame = CGRectMake(itemOrigin.x, self.layoutMargin.top - self.topOverlap, itemSize.width, itemSize.height);
-                
-                // Items below first unexposed
-                // are hidden to improve
-                // performance
-                //
-                if (item < self.exposedItemIndex - 1) attributes.hidden = YES;
+                [deletedItems addIndex:item];
+                break;
             }
+                
+            case UICollectionUpdateActionMove: {
+                
+                NSInteger item = [self itemForIndexPath:indexPathBeforeUpdate inSections:&_previousSections];
+                NSInteger targetItem = [self itemForIndexPath:indexPathAfterUpdate inSections:&_sections];
 
-        } else if (item == self.exposedItemIndex) {
-            
-            // Exposed item
-            //
-            attributes.frame = CGRectMake(itemOrigin.x, self.layoutMargin.top, itemSize.width, itemSize.height);
-
-        } else if (self.pinningMode != TGLExposedLayoutPinningModeNone) {
-
-            // Pinning lower items to bottom
-            //
-            if (item > self.exposedItemIndex + bottomPinningCount) {
+                [deletedItems addIndex:item];
+                [insertedItems addIndex:targetItem];
 
-                attributes.frame = CGRectMake(itemOrigin.x, self.collectionViewContentSize.height, itemSize.width, itemSize.height);
-                attributes.hidden = YES;
+                if (item != NSNotFound && targetItem != NSNotFound) movedItems[@(item)] = @(targetItem);
+                break;
+            }
                 
-            } else {
+            case UICollectionUpdateActionReload:
                 
-                NSInteger count = MIN(bottomPinningCount + 1, itemCount - self.exposedItemIndex) - (item - self.exposedItemIndex);
+                if (indexPathAfterUpdate) [reloadedIndexPaths addObject:indexPathAfterUpdate];
+                break;
                 
-                attributes.frame = CGRectMake(itemOrigin.x, self.collectionViewContentSize.height - self.layoutMargin.bottom - count * self.bottomOverlap, itemSize.width, itemSize.height);
-            }
-            
-        } else if (item > self.exposedItemIndex + bottomOverlapCount) {
-            
-            // Items following overlapping
-            // items at bottom are hidden
-            // to improve performance
-            //
-            attributes.frame = CGRectMake(itemOrigin.x, self.collectionViewContentSize.height, itemSize.width, itemSize.height);
-            attributes.hidden = YES;
-
-        } else {
-        
-            // At max -bottomOverlapCount
-            // overlapping item(s) at the
-            // bottom right below the
-            // exposed item
-            //
-            NSInteger count = MIN(self.bottomOverlapCount + 1, itemCount - self.exposedItemIndex) - (item - self.exposedItemIndex);
-
-            attributes.frame = CGRectMake(itemOrigin.x, self.layoutMargin.top + itemSize.height - count * self.bottomOverlap, itemSize.width, itemSize.height);
+            default:
+                break;
+        }
+    }
+    
+    [deletedItems removeIndex:NSNotFound];
+    [insertedItems removeIndex:NSNotFound];
+    
+    BOOL trackingItems = !updatingSections && TGLSectionTableItemCount(&_previousSections) - (NSInteger)deletedItems.count + (NSInteger)insertedItems.count == TGLSectionTableItemCount(&_sections);
+
+    // Measured sizes follow moved items, while
+    // reloaded items have to be measured again
+    //
+    if (trackingItems) {
+        
+        [self.measuredSizeCache updateWithDeletedItems:deletedItems insertedItems:insertedItems movedItems:movedItems];
+        
+        for (NSIndexPath *indexPath in reloadedIndexPaths) {
             
-            // Issue #21
-            //
-            // Make sure overlapping cards
-            // reach to the bottom before
-            // being hidden
-            //
-            if (item == self.exposedItemIndex + bottomOverlapCount && attributes.frame.origin.y < self.collectionView.bounds.size.height - self.layoutMargin.bottom) {
-
-                ++bottomOverlapCount;
-            }
+            [self.measuredSizeCache removeSizeForItem:[self itemForIndexPath:indexPath]];
         }
+        
+    } else {
+        
+        [self.measuredSizeCache removeAllSizes];
+    }
+
+    if (!self.deferringUpdates) return;
+    
+    if (!trackingItems) {
+        
+        // Section updates shift index paths
+        // in ways not worth tracking
+        //
+        [self finishDeferredUpdates];
+        
+        return;
+    }
+    
+    long *deleted = malloc(MAX(deletedItems.count, 1) * sizeof(long));
+    long *inserted = malloc(MAX(insertedItems.count, 1) * sizeof(long));
+    long deletedCount = 0;
+    long insertedCount = 0;
+    
+    for (NSUInteger item = deletedItems.firstIndex; item != NSNotFound; item = [deletedItems indexGreaterThanIndex:item]) deleted[deletedCount++] = item;
+    for (NSUInteger item = insertedItems.firstIndex; item != NSNotFound; item = [insertedItems indexGreaterThanIndex:item]) inserted[insertedCount++] = item;
+    
+    [self.attributesStore updateItemCount:TGLSectionTableItemCount(&_sections) usingBlock:^NSInteger(NSInteger item) {
+        
+        long result = TGLItemUpdateMap(deleted, deletedCount, inserted, insertedCount, item);
+        
+        return (result < 0) ? NSNotFound : result;
+    }];
+    
+    free(deleted);
+    free(inserted);
+    
+    self.deferringUpdates = NO;
 
-        layoutAttributes[indexPath] = attributes;
+    [self prepareAttributesForCollectionView:self.collectionView];
+}
+
+- (void)finalizeCollectionViewUpdates {
+    
+    [super finalizeCollectionViewUpdates];
+    
+    self.insertedIndexPaths = nil;
+    self.disappearingAttributes = nil;
+}
+
+- (UICollectionViewLayoutAttributes *)initialLayoutAttributesForAppearingItemAtIndexPath:(NSIndexPath *)itemIndexPath {
+    
+    if ([self.insertedIndexPaths containsObject:itemIndexPath]) {
+        
+        // Let inserted cards fade in place
+        //
+        UICollectionViewLayoutAttributes *attributes = [[self layoutAttributesForItemAtIndexPath:itemIndexPath] copy];
+        
+        attributes.alpha = 0.0;
+        
+        return attributes;
     }
     
-    self.layoutAttributes = layoutAttributes;
+    return [super initialLayoutAttributesForAppearingItemAtIndexPath:itemIndexPath];
+}
+
+- (UICollectionViewLayoutAttributes *)finalLayoutAttributesForDisappearingItemAtIndexPath:(NSIndexPath *)itemIndexPath {
+    
+    UICollectionViewLayoutAttributes *attributes = self.disappearingAttributes[itemIndexPath];
+    
+    return attributes ?: [super finalLayoutAttributesForDisappearingItemAtIndexPath:itemIndexPath];
+}
+
+- (BOOL)shouldInvalidateLayoutForPreferredLayoutAttributes:(UICollectionViewLayoutAttributes *)preferredAttributes withOriginalAttributes:(UICollectionViewLayoutAttributes *)originalAttributes {
+    
+    if (!self.sizesExposedItemToFit || preferredAttributes.representedElementCategory != UICollectionElementCategoryCell || ![preferredAttributes.indexPath isEqual:self.exposedItemIndexPath]) return NO;
+    
+    NSInteger item = [self itemForIndexPath:preferredAttributes.indexPath];
+    CGFloat height = preferredAttributes.size.height;
+
+    // Known heights may exceed the height
+    // the item is limited to, so they must
+    // not invalidate over and over again
+    //
+    if (item == NSNotFound || height <= 0.0 || height == [self.measuredSizeCache sizeForItem:item].height) return NO;
+
+    // Heights matching the original ones are
+    // cached, too, so that the item is not
+    // measured again, but leave the layout
+    // unchanged
+    //
+    [self.measuredSizeCache setSize:preferredAttributes.size forItem:item];
+    
+    return height != originalAttributes.size.height;
 }
 
 - (NSArray *)layoutAttributesForElementsInRect:(CGRect)rect {
     
+    [self finishDeferredUpdates];
+
     NSMutableArray *layoutAttributes = [NSMutableArray array];
-    
-    [self.layoutAttributes enumerateKeysAndObjectsUsingBlock:^(NSIndexPath *indexPath, UICollectionViewLayoutAttributes *attributes, BOOL *stop) {
+    long first[TGLExposedGeometryMaxRangeCount], end[TGLExposedGeometryMaxRangeCount];
+    long rangeCount = TGLExposedGeometryItemRanges(&_geometry, CGRectGetMinY(rect), CGRectGetMaxY(rect), first, end);
+
+    for (long range = 0; range < rangeCount; range++) {
         
-        if (CGRectIntersectsRect(rect, attributes.frame)) {
+        for (NSInteger item = first[range]; item < end[range]; item++) {
+            
+            UICollectionViewLayoutAttributes *attributes = [self.attributesStore attributesForItem:item];
             
-            [layoutAttributes addObject:attributes];
+            if (attributes == nil) attributes = [self dequeueAttributesForItem:item];
+            
+            if (!attributes.hidden && CGRectIntersectsRect(rect, attributes.frame)) {
+                
+                [layoutAttributes addObject:attributes];
+            }
         }
-    }];
+    }
     
+    TGLLayoutMetrics *metrics = self.metrics;
+
+    if (metrics) [metrics recordQueryWithReturnedCount:layoutAttributes.count allocationCount:[self unrecordedAllocationCount]];
+
     return layoutAttributes;
 }
 
 - (UICollectionViewLayoutAttributes *)layoutAttributesForItemAtIndexPath:(NSIndexPath *)indexPath {
     
-    return self.layoutAttributes[indexPath];
+    [self finishDeferredUpdates];
+
+    NSInteger item = [self itemForIndexPath:indexPath];
+
+    if (item == NSNotFound || item >= _geometry.parameters.itemCount) return nil;
+    
+    UICollectionViewLayoutAttributes *attributes = [self.attributesStore attributesForItem:item];
+    
+    return attributes ?: [self dequeueAttributesForItem:item];
+}
+
+#pragma mark - Methods
+
+- (BOOL)shouldMeasureItemAtIndexPath:(NSIndexPath *)indexPath {
+    
+    if (!self.sizesExposedItemToFit || ![indexPath isEqual:self.exposedItemIndexPath]) return NO;
+    
+    NSInteger item = [self itemForIndexPath:indexPath];
+    
+    return item != NSNotFound && [self.measuredSizeCache sizeForItem:item].height <= 0.0;
+}
+
+#pragma mark - Helpers
+
+- (void)finishDeferredUpdates {
+    
+    if (!self.deferringUpdates) return;
+    
+    self.deferringUpdates = NO;
+    
+    [self.attributesStore removeAllAttributes];
+
+    [self prepareAttributesForCollectionView:self.collectionView];
+}
+
+- (UICollectionViewLayoutAttributes *)dequeueAttributesForItem:(NSInteger)item {
+    
+    UICollectionViewLayoutAttributes *attributes = [self.attributesStore dequeueAttributesForItem:item];
+    CGRect frame = self.itemFrame;
+    
+    frame.origin.y = TGLExposedGeometryOriginY(&_geometry, item);
+    
+    if (item == _geometry.parameters.exposedItem && _geometry.parameters.exposedItemHeight > 0.0) frame.size.height = _geometry.parameters.exposedItemHeight;
+
+    attributes.frame = frame;
+    
+    // Cards overlap each other
+    // via z depth AND transform
+    //
+    // See http://stackoverflow.com/questions/12659301/uicollectionview-setlayoutanimated-not-preserving-zindex
+    //
+    // KLUDGE: translation is along negative
+    //         z axis as not to block scroll
+    //         indicators
+    //
+    attributes.zIndex = item;
+    attributes.transform3D = CATransform3DMakeTranslation(0, 0, item - _geometry.parameters.itemCount);
+    
+    // Items not visible are placed at the
+    // bottom and hidden to improve performance
+    //
+    attributes.hidden = (TGLExposedGeometryFlags(&_geometry, item) & TGLLayoutItemFlagHidden) != 0;
+
+    [self.metrics recordItemsWithVisibleCount:!attributes.hidden hiddenCount:attributes.hidden];
+
+    return attributes;
+}
+
+- (NSUInteger)unrecordedAllocationCount {
+    
+    NSUInteger allocationCount = self.attributesStore.allocationCount;
+    NSUInteger count = allocationCount - _recordedAllocationCount;
+    
+    _recordedAllocationCount = allocationCount;
+    
+    return count;
+}
+
+- (CGSize)contentSizeForCollectionView:(UICollectionView *)collectionView {
+    
+    CGSize contentSize = collectionView.bounds.size;
+    
+    contentSize.height -= collectionView.contentInset.top + collectionView.contentInset.bottom;
+    
+    return contentSize;
+}
+
+- (BOOL)updateSectionTableForCollectionView:(UICollectionView *)collectionView {
+    
+    NSInteger sectionCount = collectionView.numberOfSections;
+    long *itemCounts = malloc(MAX(sectionCount, 1) * sizeof(long));
+    
+    for (NSInteger section = 0; section < sectionCount; section++) {
+        
+        itemCounts[section] = [collectionView numberOfItemsInSection:section];
+    }
+    
+    // Keep previous sections to map index
+    // paths before batch updates
+    //
+    TGLSectionTable sections = _previousSections;
+    
+    _previousSections = _sections;
+    _sections = sections;
+    
+    TGLSectionTableReset(&_sections, itemCounts, sectionCount);
+    
+    free(itemCounts);
+    
+    return !TGLSectionTableEqual(&_sections, &_previousSections);
+}
+
+- (NSInteger)itemForIndexPath:(NSIndexPath *)indexPath {
+    
+    return [self itemForIndexPath:indexPath inSections:&_sections];
+}
+
+- (NSInteger)itemForIndexPath:(NSIndexPath *)indexPath inSections:(const TGLSectionTable *)sections {
+    
+    if (indexPath == nil || indexPath.section < 0 || indexPath.section >= sections->count || indexPath.item < 0) return NSNotFound;
+    
+    NSInteger item = TGLSectionTableStart(sections, indexPath.section) + indexPath.item;
+    
+    return (item < TGLSectionTableStart(sections, indexPath.section + 1)) ? item : NSNotFound;
+}
+
+- (NSIndexPath *)indexPathForItem:(NSInteger)item {
+    
+    NSInteger section = TGLSectionTableSection(&_sections, item);
+    
+    return [NSIndexPath indexPathForItem:item - TGLSectionTableStart(&_sections, section) inSection:section];
 }
 
 @end
@@ -0,0 +1,68 @@
+//
+//  TGLItemSizeCache.h
+//  TGLStackedViewController
+//
+//  Created by Tim Gleue on 17.10.26.
+//  Copyright (c) 2026 Tim Gleue ( http://gleue-interactive.com )
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+#import <UIKit/UIKit.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/** Sizes measured for individual items, kept across layouts.
+ *
+ * Items are addressed by global index, i.e. their position in
+ * the concatenation of all sections. Layouts sharing a cache
+ * keep it in sync with batch updates while installed: sizes
+ * follow moved items and are discarded for deleted and
+ * reloaded items. Call `-removeAllSizes` after reloading the
+ * collection view's data.
+ */
+@interface TGLItemSizeCache : NSObject
+
+/** Number of items with a measured size */
+@property (nonatomic, readonly) NSUInteger count;
+
+/** Returns the size measured for `item` or `CGSizeZero` if there is none */
+- (CGSize)sizeForItem:(NSInteger)item;
+
+/** Stores `size` measured for `item` */
+- (void)setSize:(CGSize)size forItem:(NSInteger)item;
+
+/** Discards the size measured for `item` */
+- (void)removeSizeForItem:(NSInteger)item;
+
+/** Discards all measured sizes */
+- (void)removeAllSizes;
+
+/** Moves measured sizes to new item indices after a batch update.
+ *
+ * Items are given as global indices, `deletedItems` before
+ * and `insertedItems` after the update. Moved items appear
+ * in both, and `movedItems` maps their indices before the
+ * update to those after it, so that their sizes are kept.
+ * Sizes of deleted items are discarded.
+ */
+- (void)updateWithDeletedItems:(NSIndexSet *)deletedItems insertedItems:(NSIndexSet *)insertedItems movedItems:(nullable NSDictionary<NSNumber *, NSNumber *> *)movedItems;
+
+@end
+
+NS_ASSUME_NONNULL_END
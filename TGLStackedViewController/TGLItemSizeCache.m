@@ -0,0 +1,118 @@
+//
+//  TGLItemSizeCache.m
+//  TGLStackedViewController
+//
+//  Created by Tim Gleue on 17.10.26.
+//  Copyright (c) 2026 Tim Gleue ( http://gleue-interactive.com )
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+#import "TGLItemSizeCache.h"
+#import "TGLLayoutGeometry.h"
+
+@interface TGLItemSizeCache ()
+
+// Only items actually measured are
+// stored, so a dictionary is fine
+// even for large item counts
+//
+@property (nonatomic, strong) NSMutableDictionary<NSNumber *, NSValue *> *sizes;
+
+@end
+
+@implementation TGLItemSizeCache
+
+- (instancetype)init {
+
+    self = [super init];
+
+    if (self) {
+
+        _sizes = [NSMutableDictionary dictionary];
+    }
+
+    return self;
+}
+
+#pragma mark - Accessors
+
+- (NSUInteger)count {
+
+    return self.sizes.count;
+}
+
+#pragma mark - Methods
+
+- (CGSize)sizeForItem:(NSInteger)item {
+
+    NSValue *value = self.sizes[@(item)];
+
+    return value ? value.CGSizeValue : CGSizeZero;
+}
+
+- (void)setSize:(CGSize)size forItem:(NSInteger)item {
+
+    if (item < 0 || item == NSNotFound) return;
+
+    self.sizes[@(item)] = [NSValue valueWithCGSize:size];
+}
+
+- (void)removeSizeForItem:(NSInteger)item {
+
+    [self.sizes removeObjectForKey:@(item)];
+}
+
+- (void)removeAllSizes {
+
+    [self.sizes removeAllObjects];
+}
+
+- (void)updateWithDeletedItems:(NSIndexSet *)deletedItems insertedItems:(NSIndexSet *)insertedItems movedItems:(NSDictionary<NSNumber *, NSNumber *> *)movedItems {
+
+    if (self.sizes.count == 0 || (deletedItems.count == 0 && insertedItems.count == 0)) return;
+
+    long *deleted = malloc(MAX(deletedItems.count, 1) * sizeof(long));
+    long *inserted = malloc(MAX(insertedItems.count, 1) * sizeof(long));
+    long deletedCount = 0;
+    long insertedCount = 0;
+
+    for (NSUInteger item = deletedItems.firstIndex; item != NSNotFound; item = [deletedItems indexGreaterThanIndex:item]) deleted[deletedCount++] = item;
+    for (NSUInteger item = insertedItems.firstIndex; item != NSNotFound; item = [insertedItems indexGreaterThanIndex:item]) inserted[insertedCount++] = item;
+
+    NSMutableDictionary *sizes = [NSMutableDictionary dictionaryWithCapacity:self.sizes.count];
+
+    [self.sizes enumerateKeysAndObjectsUsingBlock:^(NSNumber *key, NSValue *value, BOOL *stop) {
+
+        // Moves are reported as deletes and
+        // inserts, so moved items are looked
+        // up first to keep their sizes
+        //
+        NSNumber *movedItem = movedItems[key];
+        long item = movedItem ? movedItem.longValue : TGLItemUpdateMap(deleted, deletedCount, inserted, insertedCount, key.longValue);
+
+        if (item >= 0) sizes[@(item)] = value;
+    }];
+
+    free(deleted);
+    free(inserted);
+
+    self.sizes = sizes;
+}
+
+@end
@@ -0,0 +1,68 @@
+//
+//  TGLLayoutAttributesPool.h
+//  TGLStackedViewController
+//
+//  Created by Tim Gleue on 17.10.26.
+//  Copyright (c) 2026 Tim Gleue ( http://gleue-interactive.com )
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+#import <UIKit/UIKit.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/** Bounded pool of layout attributes objects no longer used by any layout.
+ *
+ * Each layout recycles to a private pool by default. Share
+ * a single pool between layouts, e.g. by assigning it to
+ * several `TGLStackedViewController` instances, to bound
+ * the number of spare attribute objects for all of them
+ * together.
+ *
+ * Layouts recycle only objects not handed out during their
+ * current or previous pass, so objects UIKit may still hold
+ * for any collection view are never reused. Pools must be
+ * used on the main thread only.
+ */
+@interface TGLLayoutAttributesPool : NSObject
+
+/** Maximum number of attributes objects kept. Objects beyond are released when recycled */
+@property (nonatomic, assign) NSUInteger capacity;
+
+/** Number of attributes objects currently kept */
+@property (nonatomic, readonly) NSUInteger count;
+
+/** Creates a pool keeping at most `capacity` objects */
+- (instancetype)initWithCapacity:(NSUInteger)capacity NS_DESIGNATED_INITIALIZER;
+
+/** Creates a pool keeping at most 256 objects */
+- (instancetype)init;
+
+/** Removes and returns an attributes object, or `nil` if the pool is empty */
+- (nullable UICollectionViewLayoutAttributes *)dequeueAttributes;
+
+/** Keeps `attributes` for reuse unless the pool is full */
+- (void)recycleAttributes:(UICollectionViewLayoutAttributes *)attributes;
+
+/** Releases all objects kept */
+- (void)removeAllAttributes;
+
+@end
+
+NS_ASSUME_NONNULL_END
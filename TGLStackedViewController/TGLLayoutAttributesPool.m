@@ -0,0 +1,92 @@
+//
+//  TGLLayoutAttributesPool.m
+//  TGLStackedViewController
+//
+//  Created by Tim Gleue on 17.10.26.
+//  Copyright (c) 2026 Tim Gleue ( http://gleue-interactive.com )
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+#import "TGLLayoutAttributesPool.h"
+
+@interface TGLLayoutAttributesPool ()
+
+@property (nonatomic, strong) NSMutableArray<UICollectionViewLayoutAttributes *> *attributes;
+
+@end
+
+@implementation TGLLayoutAttributesPool
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity {
+
+    self = [super init];
+
+    if (self) {
+
+        _capacity = capacity;
+        _attributes = [NSMutableArray array];
+    }
+
+    return self;
+}
+
+- (instancetype)init {
+
+    return [self initWithCapacity:256];
+}
+
+#pragma mark - Accessors
+
+- (void)setCapacity:(NSUInteger)capacity {
+
+    _capacity = capacity;
+
+    if (self.attributes.count > capacity) {
+
+        [self.attributes removeObjectsInRange:NSMakeRange(capacity, self.attributes.count - capacity)];
+    }
+}
+
+- (NSUInteger)count {
+
+    return self.attributes.count;
+}
+
+#pragma mark - Methods
+
+- (UICollectionViewLayoutAttributes *)dequeueAttributes {
+
+    UICollectionViewLayoutAttributes *attributes = self.attributes.lastObject;
+
+    if (attributes) [self.attributes removeLastObject];
+
+    return attributes;
+}
+
+- (void)recycleAttributes:(UICollectionViewLayoutAttributes *)attributes {
+
+    if (self.attributes.count < self.capacity) [self.attributes addObject:attributes];
+}
+
+- (void)removeAllAttributes {
+
+    [self.attributes removeAllObjects];
+}
+
+@end
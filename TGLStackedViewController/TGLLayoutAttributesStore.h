@@ -0,0 +1,115 @@
+//
+//  TGLLayoutAttributesStore.h
+//  TGLStackedViewController
+//
+//  Created by Tim Gleue on 17.10.26.
+//  Copyright (c) 2026 Tim Gleue ( http://gleue-interactive.com )
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+#import <UIKit/UIKit.h>
+
+#import "TGLLayoutAttributesPool.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/** Item-keyed storage for cell layout attributes, recycling
+ *  attribute objects between layout passes.
+ *
+ * Items are addressed by global index, i.e. their position in
+ * the concatenation of all sections. Call `-prepareForItemCount:`
+ * at the start of each layout pass. Attributes dequeued for an
+ * item before are reused for it if available, so repeatedly
+ * laying out the same range of items does not allocate any
+ * new objects.
+ *
+ * Attributes handed out during a pass are not modified during
+ * the next one, since UIKit may still hold them. Each item
+ * alternates between two attribute objects instead.
+ *
+ * Attributes are kept for resident items only and looked up
+ * in an array indexed by item, spanning the resident items.
+ * Memory therefore depends on the number of resident items,
+ * not on the item count.
+ */
+@interface TGLLayoutAttributesStore : NSObject
+
+/** Distance in items from those used in the last pass up to which attributes are kept for their items, others are recycled to -pool. Default is 256 */
+@property (nonatomic, assign) NSUInteger capacity;
+
+/** Pool to recycle attribute objects to and reuse them from. Default is a private pool */
+@property (nonatomic, strong) TGLLayoutAttributesPool *pool;
+
+/** Number of attribute objects and index paths allocated by the store so far */
+@property (nonatomic, readonly) NSUInteger allocationCount;
+
+/** Maps a global item index to its index path. Default is `nil`, i.e. all items are in section 0 */
+@property (nonatomic, copy, nullable) NSIndexPath *(^indexPathForItem)(NSInteger item);
+
+/** Starts a new layout pass for `itemCount` items in total.
+ *
+ * All attributes stored during the previous pass become stale
+ * and are reused by subsequent calls to `-dequeueAttributesForItem:`.
+ */
+- (void)prepareForItemCount:(NSInteger)itemCount;
+
+/** Recycles all stored attributes.
+ *
+ * Use this when index paths of items changed without
+ * changing the total item count, e.g. when items were
+ * moved between sections.
+ */
+- (void)removeAllAttributes;
+
+/** Moves stored attributes to new item indices after a batch update.
+ *
+ * `block` returns the index after the update of an item at
+ * index `item` before it, or `NSNotFound` if it was deleted.
+ * Attributes of deleted items are recycled, those of other
+ * items are assigned their new index paths, copying them if
+ * handed out recently. Cost is linear in the number of stored
+ * attributes, not in `itemCount`.
+ *
+ * Call `-prepareForItemCount:` with `itemCount` afterwards to
+ * start a new pass, reusing moved attributes for their items.
+ */
+- (void)updateItemCount:(NSInteger)itemCount usingBlock:(NSInteger (NS_NOESCAPE ^)(NSInteger item))block;
+
+/** Keeps attributes dequeued during the previous pass for items in `range` valid for the current pass.
+ *
+ * Use this when the layout knows these items did not change
+ * since the previous pass, e.g. when scrolling.
+ */
+- (void)preserveAttributesForItemsInRange:(NSRange)range;
+
+/** Returns the attributes for `item` if already dequeued during the current pass, `nil` otherwise. */
+- (nullable UICollectionViewLayoutAttributes *)attributesForItem:(NSInteger)item;
+
+/** Returns an attributes object for `item` and stores it for the current pass.
+ *
+ * The object is either one used for the same item before
+ * the previous pass, a recycled one, or a newly allocated
+ * one. Caller has to set all of its properties but
+ * `-indexPath`.
+ */
+- (UICollectionViewLayoutAttributes *)dequeueAttributesForItem:(NSInteger)item;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,205 @@
+//
+//  TGLLayoutAttributesStore.m
+//  TGLStackedViewController
+//
+//  Created by Tim Gleue on 17.10.26.
+//  Copyright (c) 2026 Tim Gleue ( http://gleue-interactive.com )
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+#import "TGLLayoutAttributesStore.h"
+#import "TGLAttributesSlots.h"
+
+@interface TGLLayoutAttributesStore () {
+
+    // Slots keep attributes of resident items,
+    // retained manually while in a slot
+    //
+    TGLAttributesSlots _slots;
+}
+
+@property (nonatomic, assign) NSUInteger allocationCount;
+
+- (UICollectionViewLayoutAttributes *)createAttributesForItem:(NSInteger)item;
+- (UICollectionViewLayoutAttributes *)relabelAttributes:(UICollectionViewLayoutAttributes *)attributes item:(NSInteger)item reusable:(BOOL)reusable;
+- (void)recycleAttributes:(UICollectionViewLayoutAttributes *)attributes reusable:(BOOL)reusable;
+
+@end
+
+#pragma mark - Slot callbacks
+
+static void *TGLLayoutAttributesStoreCreate(void *context, long item) {
+
+    TGLLayoutAttributesStore *store = (__bridge TGLLayoutAttributesStore *)context;
+
+    return (__bridge_retained void *)[store createAttributesForItem:item];
+}
+
+static void *TGLLayoutAttributesStoreRelabel(void *context, void *object, long item, bool reusable) {
+
+    TGLLayoutAttributesStore *store = (__bridge TGLLayoutAttributesStore *)context;
+
+    return (__bridge_retained void *)[store relabelAttributes:(__bridge_transfer UICollectionViewLayoutAttributes *)object item:item reusable:reusable];
+}
+
+static void TGLLayoutAttributesStoreRecycle(void *context, void *object, bool reusable) {
+
+    TGLLayoutAttributesStore *store = (__bridge TGLLayoutAttributesStore *)context;
+
+    [store recycleAttributes:(__bridge_transfer UICollectionViewLayoutAttributes *)object reusable:reusable];
+}
+
+static long TGLLayoutAttributesStoreMap(void *context, long item) {
+
+    NSInteger (^block)(NSInteger) = (__bridge NSInteger (^)(NSInteger))context;
+    NSInteger result = block(item);
+
+    return (result == NSNotFound) ? -1 : result;
+}
+
+@implementation TGLLayoutAttributesStore
+
+- (instancetype)init {
+
+    self = [super init];
+
+    if (self) {
+
+        _capacity = 256;
+        _pool = [[TGLLayoutAttributesPool alloc] init];
+
+        TGLAttributesSlotsInit(&_slots, _capacity, TGLLayoutAttributesStoreCreate, TGLLayoutAttributesStoreRelabel, TGLLayoutAttributesStoreRecycle, (__bridge void *)self);
+    }
+
+    return self;
+}
+
+- (void)dealloc {
+
+    TGLAttributesSlotsFree(&_slots);
+}
+
+#pragma mark - Accessors
+
+- (void)setCapacity:(NSUInteger)capacity {
+
+    _capacity = capacity;
+    _slots.capacity = (long)MIN(capacity, (NSUInteger)NSIntegerMax / 2);
+}
+
+#pragma mark - Methods
+
+- (void)prepareForItemCount:(NSInteger)itemCount {
+
+    TGLAttributesSlotsPrepare(&_slots, itemCount);
+}
+
+- (void)removeAllAttributes {
+
+    TGLAttributesSlotsRemoveAll(&_slots);
+}
+
+- (void)updateItemCount:(NSInteger)itemCount usingBlock:(NSInteger (NS_NOESCAPE ^)(NSInteger))block {
+
+    TGLAttributesSlotsUpdate(&_slots, itemCount, TGLLayoutAttributesStoreMap, (__bridge void *)block);
+}
+
+- (void)preserveAttributesForItemsInRange:(NSRange)range {
+
+    TGLAttributesSlotsPreserve(&_slots, range.location, range.length);
+}
+
+- (UICollectionViewLayoutAttributes *)attributesForItem:(NSInteger)item {
+
+    return (__bridge UICollectionViewLayoutAttributes *)TGLAttributesSlotsObject(&_slots, item);
+}
+
+- (UICollectionViewLayoutAttributes *)dequeueAttributesForItem:(NSInteger)item {
+
+    NSAssert(item >= 0 && item < _slots.itemCount, @"Item %ld out of range", (long)item);
+
+    return (__bridge UICollectionViewLayoutAttributes *)TGLAttributesSlotsDequeue(&_slots, item);
+}
+
+#pragma mark - Helpers
+
+- (NSIndexPath *)indexPathForItemAtIndex:(NSInteger)item {
+
+    return self.indexPathForItem ? self.indexPathForItem(item) : [NSIndexPath indexPathForItem:item inSection:0];
+}
+
+- (UICollectionViewLayoutAttributes *)createAttributesForItem:(NSInteger)item {
+
+    UICollectionViewLayoutAttributes *attributes = [self.pool dequeueAttributes];
+    NSIndexPath *indexPath = [self indexPathForItemAtIndex:item];
+
+    if (attributes) {
+
+        attributes.indexPath = indexPath;
+
+        // Reset properties not necessarily
+        // set by layout when dequeueing,
+        // or set by another layout
+        //
+        attributes.hidden = NO;
+        attributes.alpha = 1.0;
+        attributes.zIndex = 0;
+        attributes.transform3D = CATransform3DIdentity;
+
+        self.allocationCount += 1;
+
+    } else {
+
+        attributes = [UICollectionViewLayoutAttributes layoutAttributesForCellWithIndexPath:indexPath];
+
+        self.allocationCount += 2;
+    }
+
+    return attributes;
+}
+
+- (UICollectionViewLayoutAttributes *)relabelAttributes:(UICollectionViewLayoutAttributes *)attributes item:(NSInteger)item reusable:(BOOL)reusable {
+
+    // Attributes UIKit may still hold,
+    // e.g. for update animations, must
+    // not change their index paths
+    //
+    if (!reusable) {
+
+        attributes = [attributes copy];
+
+        self.allocationCount += 1;
+    }
+
+    attributes.indexPath = [self indexPathForItemAtIndex:item];
+
+    self.allocationCount += 1;
+
+    return attributes;
+}
+
+- (void)recycleAttributes:(UICollectionViewLayoutAttributes *)attributes reusable:(BOOL)reusable {
+
+    // Others are left to UIKit
+    // and released when done
+    //
+    if (reusable) [self.pool recycleAttributes:attributes];
+}
+
+@end
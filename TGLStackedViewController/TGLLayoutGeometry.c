@@ -0,0 +1,1585 @@
+//
+//  TGLLayoutGeometry.c
+//  TGLStackedViewController
+//
+//  Created by Tim Gleue on 17.10.26.
+//  Copyright (c) 2026 Tim Gleue ( http://gleue-interactive.com )
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+#include "TGLLayoutGeometry.h"
+
+#include <math.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+// MARK: - Section table
+
+void TGLSectionTableInit(TGLSectionTable *table) {
+
+    table->count = 0;
+    table->capacity = 0;
+    table->starts = NULL;
+}
+
+void TGLSectionTableFree(TGLSectionTable *table) {
+
+    free(table->starts);
+
+    TGLSectionTableInit(table);
+}
+
+bool TGLSectionTableReset(TGLSectionTable *table, const long *itemCounts, long count) {
+
+    if (count + 1 > table->capacity) {
+
+        table->capacity = count + 1;
+        table->starts = realloc(table->starts, table->capacity * sizeof(long));
+    }
+
+    bool changed = (count != table->count);
+    long start = 0;
+
+    for (long section = 0; section <= count; section++) {
+
+        if (!changed && table->starts[section] != start) changed = true;
+
+        table->starts[section] = start;
+
+        if (section < count) start += itemCounts[section];
+    }
+
+    table->count = count;
+
+    return changed;
+}
+
+bool TGLSectionTableEqual(const TGLSectionTable *table, const TGLSectionTable *other) {
+
+    if (table->count != other->count) return false;
+
+    for (long section = 1; section <= table->count; section++) {
+
+        if (table->starts[section] != other->starts[section]) return false;
+    }
+
+    return true;
+}
+
+long TGLSectionTableItemCount(const TGLSectionTable *table) {
+
+    return (table->count > 0) ? table->starts[table->count] : 0;
+}
+
+long TGLSectionTableStart(const TGLSectionTable *table, long section) {
+
+    return table->starts[section];
+}
+
+long TGLSectionTableSection(const TGLSectionTable *table, long item) {
+
+    // Find last section starting at or
+    // before item, thus skipping any
+    // empty sections in between
+    //
+    long low = 0;
+    long high = table->count;
+
+    while (high - low > 1) {
+
+        long mid = low + (high - low) / 2;
+
+        if (table->starts[mid] <= item) {
+
+            low = mid;
+
+        } else {
+
+            high = mid;
+        }
+    }
+
+    return low;
+}
+
+// MARK: - Item updates
+
+long TGLItemUpdateMap(const long *deletedItems, long deletedCount, const long *insertedItems, long insertedCount, long item) {
+
+    // Count deleted items preceding item
+    //
+    long low = 0;
+    long high = deletedCount;
+
+    while (low < high) {
+
+        long mid = low + (high - low) / 2;
+
+        if (deletedItems[mid] < item) {
+
+            low = mid + 1;
+
+        } else {
+
+            high = mid;
+        }
+    }
+
+    if (low < deletedCount && deletedItems[low] == item) return -1;
+
+    // Then shift by inserted items at
+    // or before resulting position
+    //
+    long result = item - low;
+
+    for (long i = 0; i < insertedCount && insertedItems[i] <= result; i++) result++;
+
+    return result;
+}
+
+long TGLItemLongestIncreasingSubsequence(const long *values, long count, bool *members) {
+
+    if (count <= 0) return 0;
+
+    // Patience sorting: `tails[k]` is the index of
+    // the smallest value ending an increasing
+    // subsequence of length k + 1 found so far
+    //
+    long *tails = malloc(count * sizeof(long));
+    long *predecessors = malloc(count * sizeof(long));
+    long length = 0;
+
+    for (long i = 0; i < count; i++) {
+
+        long low = 0;
+        long high = length;
+
+        while (low < high) {
+
+            long mid = low + (high - low) / 2;
+
+            if (values[tails[mid]] < values[i]) {
+
+                low = mid + 1;
+
+            } else {
+
+                high = mid;
+            }
+        }
+
+        predecessors[i] = (low > 0) ? tails[low - 1] : -1;
+        tails[low] = i;
+
+        if (low == length) length++;
+    }
+
+    memset(members, 0, count * sizeof(bool));
+
+    for (long i = tails[length - 1]; i >= 0; i = predecessors[i]) members[i] = true;
+
+    free(tails);
+    free(predecessors);
+
+    return length;
+}
+
+// MARK: - Reveal table
+
+// Chunks built concurrently are complete subtrees
+// of two branch levels, see `TGLRevealTableShape`
+//
+typedef char TGLRevealTableChunkSizeCheck[(TGLRevealTableChunkSize == TGLRevealTableLeafCapacity * TGLRevealTableBranchCapacity * TGLRevealTableBranchCapacity) ? 1 : -1];
+
+/** Maximum number of branch levels, enough for any `long` item count */
+#define TGLRevealTableMaxHeight 16
+
+/** Node counts per level of a table built from scratch, level 0 being leaves */
+typedef struct {
+
+    long height;
+    long nodeCounts[TGLRevealTableMaxHeight + 1];
+    long firstNodes[TGLRevealTableMaxHeight + 1];   /* Index of first node of each level in leaf or branch storage */
+    long branchCount;
+
+} TGLRevealTableShape;
+
+void TGLRevealTableInit(TGLRevealTable *table) {
+
+    table->count = 0;
+    table->height = 0;
+    table->root = -1;
+    table->leafCount = 0;
+    table->leafCapacity = 0;
+    table->leafValues = NULL;
+    table->leafSizes = NULL;
+    table->branchCount = 0;
+    table->branchCapacity = 0;
+    table->branches = NULL;
+}
+
+void TGLRevealTableFree(TGLRevealTable *table) {
+
+    free(table->leafValues);
+    free(table->leafSizes);
+    free(table->branches);
+
+    TGLRevealTableInit(table);
+}
+
+static void TGLRevealTableReserve(TGLRevealTable *table, long leafCount, long branchCount) {
+
+    if (leafCount > table->leafCapacity) {
+
+        long capacity = (2 * table->leafCapacity > leafCount) ? 2 * table->leafCapacity : leafCount;
+
+        table->leafValues = realloc(table->leafValues, capacity * TGLRevealTableLeafCapacity * sizeof(double));
+        table->leafSizes = realloc(table->leafSizes, capacity * sizeof(long));
+        table->leafCapacity = capacity;
+    }
+
+    if (branchCount > table->branchCapacity) {
+
+        long capacity = (2 * table->branchCapacity > branchCount) ? 2 * table->branchCapacity : branchCount;
+
+        table->branches = realloc(table->branches, capacity * sizeof(TGLRevealTableBranch));
+        table->branchCapacity = capacity;
+    }
+}
+
+static void TGLRevealTableNodeTotals(const TGLRevealTable *table, long node, long level, long *count, double *sum) {
+
+    // Sums are always accumulated in item
+    // order, so that they only depend on
+    // the tree's shape and values
+    //
+    double total = 0.0;
+
+    if (level == 0) {
+
+        const double *values = table->leafValues + node * TGLRevealTableLeafCapacity;
+
+        *count = table->leafSizes[node];
+
+        for (long i = 0; i < *count; i++) total += values[i];
+
+    } else {
+
+        const TGLRevealTableBranch *branch = &table->branches[node];
+
+        *count = 0;
+
+        for (long i = 0; i < branch->childCount; i++) {
+
+            *count += branch->counts[i];
+            total += branch->sums[i];
+        }
+    }
+
+    *sum = total;
+}
+
+static void TGLRevealTableShapeForCount(TGLRevealTableShape *shape, long count) {
+
+    // Leaves and branches are filled completely
+    // from left to right, only the last node of
+    // each level may be partially filled
+    //
+    long nodeCount = (count + TGLRevealTableLeafCapacity - 1) / TGLRevealTableLeafCapacity;
+
+    if (nodeCount < 1) nodeCount = 1;
+
+    shape->height = 0;
+    shape->nodeCounts[0] = nodeCount;
+    shape->firstNodes[0] = 0;
+    shape->branchCount = 0;
+
+    while (nodeCount > 1) {
+
+        nodeCount = (nodeCount + TGLRevealTableBranchCapacity - 1) / TGLRevealTableBranchCapacity;
+
+        shape->height += 1;
+        shape->nodeCounts[shape->height] = nodeCount;
+        shape->firstNodes[shape->height] = shape->branchCount;
+        shape->branchCount += nodeCount;
+    }
+}
+
+static void TGLRevealTableBuildLeaf(TGLRevealTable *table, long leaf, const double *values, long count) {
+
+    long first = leaf * TGLRevealTableLeafCapacity;
+    long size = count - first;
+
+    if (size > TGLRevealTableLeafCapacity) size = TGLRevealTableLeafCapacity;
+    if (size < 0) size = 0;
+
+    if (size > 0) memcpy(table->leafValues + first, values + first, size * sizeof(double));
+
+    table->leafSizes[leaf] = size;
+}
+
+static void TGLRevealTableBuildBranch(TGLRevealTable *table, const TGLRevealTableShape *shape, long level, long index) {
+
+    TGLRevealTableBranch *branch = &table->branches[shape->firstNodes[level] + index];
+    long first = index * TGLRevealTableBranchCapacity;
+    long end = first + TGLRevealTableBranchCapacity;
+
+    if (end > shape->nodeCounts[level - 1]) end = shape->nodeCounts[level - 1];
+
+    branch->childCount = end - first;
+
+    for (long i = 0; i < branch->childCount; i++) {
+
+        long child = shape->firstNodes[level - 1] + first + i;
+
+        branch->children[i] = child;
+
+        TGLRevealTableNodeTotals(table, child, level - 1, &branch->counts[i], &branch->sums[i]);
+    }
+}
+
+static void TGLRevealTableFinishBuild(TGLRevealTable *table, const TGLRevealTableShape *shape, long count) {
+
+    table->count = count;
+    table->height = shape->height;
+    table->root = shape->firstNodes[shape->height];
+    table->leafCount = shape->nodeCounts[0];
+    table->branchCount = shape->branchCount;
+}
+
+void TGLRevealTableReset(TGLRevealTable *table, const double *values, long count) {
+
+    TGLRevealTableShape shape;
+
+    TGLRevealTableShapeForCount(&shape, count);
+    TGLRevealTableReserve(table, shape.nodeCounts[0], shape.branchCount);
+
+    for (long leaf = 0; leaf < shape.nodeCounts[0]; leaf++) TGLRevealTableBuildLeaf(table, leaf, values, count);
+
+    for (long level = 1; level <= shape.height; level++) {
+
+        for (long index = 0; index < shape.nodeCounts[level]; index++) TGLRevealTableBuildBranch(table, &shape, level, index);
+    }
+
+    TGLRevealTableFinishBuild(table, &shape, count);
+}
+
+typedef struct {
+
+    TGLRevealTable *table;
+    const TGLRevealTableShape *shape;
+    const double *values;
+    long count;
+
+} TGLRevealTableChunkContext;
+
+static void TGLRevealTableBuildChunk(void *context, size_t chunk) {
+
+    // A chunk's items fill whole leaves, which
+    // fill whole branches of the two levels
+    // above, so nodes up to level 2 are built
+    // without touching other chunks
+    //
+    const TGLRevealTableChunkContext *chunkContext = context;
+    const TGLRevealTableShape *shape = chunkContext->shape;
+    long nodeCount = TGLRevealTableChunkSize / TGLRevealTableLeafCapacity;
+
+    for (long level = 0; level <= 2; level++) {
+
+        long first = (long)chunk * nodeCount;
+        long end = first + nodeCount;
+
+        if (end > shape->nodeCounts[level]) end = shape->nodeCounts[level];
+
+        for (long index = first; index < end; index++) {
+
+            if (level == 0) {
+
+                TGLRevealTableBuildLeaf(chunkContext->table, index, chunkContext->values, chunkContext->count);
+
+            } else {
+
+                TGLRevealTableBuildBranch(chunkContext->table, shape, level, index);
+            }
+        }
+
+        nodeCount /= TGLRevealTableBranchCapacity;
+    }
+}
+
+void TGLRevealTableResetConcurrently(TGLRevealTable *table, const double *values, long count, TGLConcurrentApplyFunction apply) {
+
+    if (apply == NULL || count < 2 * TGLRevealTableChunkSize) {
+
+        TGLRevealTableReset(table, values, count);
+
+        return;
+    }
+
+    TGLRevealTableShape shape;
+
+    TGLRevealTableShapeForCount(&shape, count);
+    TGLRevealTableReserve(table, shape.nodeCounts[0], shape.branchCount);
+
+    TGLRevealTableChunkContext context = { table, &shape, values, count };
+
+    apply((size_t)shape.nodeCounts[2], &context, TGLRevealTableBuildChunk);
+
+    // Serial fix-up of the few branches
+    // above chunks, building nodes the
+    // same way as the serial construction
+    //
+    for (long level = 3; level <= shape.height; level++) {
+
+        for (long index = 0; index < shape.nodeCounts[level]; index++) TGLRevealTableBuildBranch(table, &shape, level, index);
+    }
+
+    TGLRevealTableFinishBuild(table, &shape, count);
+}
+
+void TGLRevealTableCopy(TGLRevealTable *table, const TGLRevealTable *other) {
+
+    TGLRevealTableReserve(table, other->leafCount, other->branchCount);
+
+    if (other->leafCount > 0) {
+
+        memcpy(table->leafValues, other->leafValues, other->leafCount * TGLRevealTableLeafCapacity * sizeof(double));
+        memcpy(table->leafSizes, other->leafSizes, other->leafCount * sizeof(long));
+    }
+
+    if (other->branchCount > 0) memcpy(table->branches, other->branches, other->branchCount * sizeof(TGLRevealTableBranch));
+
+    table->count = other->count;
+    table->height = other->height;
+    table->root = other->root;
+    table->leafCount = other->leafCount;
+    table->branchCount = other->branchCount;
+}
+
+/** Path from root to a leaf, i.e. branch and child slot per level */
+typedef struct {
+
+    long branches[TGLRevealTableMaxHeight];
+    long slots[TGLRevealTableMaxHeight];
+
+} TGLRevealTablePath;
+
+static long TGLRevealTableFindLeaf(const TGLRevealTable *table, long *index, bool inserting, TGLRevealTablePath *path) {
+
+    // When inserting, an index at the end of a
+    // child is in that child rather than at the
+    // start of the next one
+    //
+    long node = table->root;
+
+    for (long depth = 0; depth < table->height; depth++) {
+
+        const TGLRevealTableBranch *branch = &table->branches[node];
+        long slot = 0;
+
+        while (slot < branch->childCount - 1 && (*index > branch->counts[slot] || (!inserting && *index == branch->counts[slot]))) *index -= branch->counts[slot++];
+
+        path->branches[depth] = node;
+        path->slots[depth] = slot;
+
+        node = branch->children[slot];
+    }
+
+    return node;
+}
+
+static void TGLRevealTableUpdatePath(TGLRevealTable *table, const TGLRevealTablePath *path) {
+
+    for (long depth = table->height - 1; depth >= 0; depth--) {
+
+        TGLRevealTableBranch *branch = &table->branches[path->branches[depth]];
+        long slot = path->slots[depth];
+
+        TGLRevealTableNodeTotals(table, branch->children[slot], table->height - depth - 1, &branch->counts[slot], &branch->sums[slot]);
+    }
+}
+
+static void TGLRevealTableGetNodeValues(const TGLRevealTable *table, long node, long level, long first, long count, double *values) {
+
+    if (level == 0) {
+
+        memcpy(values, table->leafValues + node * TGLRevealTableLeafCapacity + first, count * sizeof(double));
+
+        return;
+    }
+
+    const TGLRevealTableBranch *branch = &table->branches[node];
+
+    for (long i = 0; i < branch->childCount && count > 0; i++) {
+
+        long childCount = branch->counts[i];
+
+        if (first >= childCount) {
+
+            first -= childCount;
+            continue;
+        }
+
+        long n = (childCount - first < count) ? childCount - first : count;
+
+        TGLRevealTableGetNodeValues(table, branch->children[i], level - 1, first, n, values);
+
+        values += n;
+        count -= n;
+        first = 0;
+    }
+}
+
+void TGLRevealTableGetValues(const TGLRevealTable *table, long first, long count, double *values) {
+
+    if (count > 0) TGLRevealTableGetNodeValues(table, table->root, table->height, first, count, values);
+}
+
+double TGLRevealTableValue(const TGLRevealTable *table, long item) {
+
+    double value = 0.0;
+
+    TGLRevealTableGetValues(table, item, 1, &value);
+
+    return value;
+}
+
+void TGLRevealTableSetValue(TGLRevealTable *table, long item, double value) {
+
+    TGLRevealTablePath path;
+    long leaf = TGLRevealTableFindLeaf(table, &item, false, &path);
+
+    table->leafValues[leaf * TGLRevealTableLeafCapacity + item] = value;
+
+    TGLRevealTableUpdatePath(table, &path);
+}
+
+static long TGLRevealTableAddLeaf(TGLRevealTable *table) {
+
+    TGLRevealTableReserve(table, table->leafCount + 1, 0);
+
+    return table->leafCount++;
+}
+
+static long TGLRevealTableAddBranch(TGLRevealTable *table) {
+
+    TGLRevealTableReserve(table, 0, table->branchCount + 1);
+
+    return table->branchCount++;
+}
+
+static long TGLRevealTableInsertChild(TGLRevealTable *table, long node, long slot, long child, long level) {
+
+    // Inserts `child` of given level into
+    // branch `node`, splitting it in half
+    // if full. Returns the new sibling
+    // holding the upper half or -1
+    //
+    long sibling = -1;
+
+    if (table->branches[node].childCount == TGLRevealTableBranchCapacity) {
+
+        sibling = TGLRevealTableAddBranch(table);
+
+        TGLRevealTableBranch *branch = &table->branches[node];
+        TGLRevealTableBranch *other = &table->branches[sibling];
+        long half = TGLRevealTableBranchCapacity / 2;
+
+        other->childCount = TGLRevealTableBranchCapacity - half;
+        branch->childCount = half;
+
+        memcpy(other->children, branch->children + half, other->childCount * sizeof(long));
+        memcpy(other->counts, branch->counts + half, other->childCount * sizeof(long));
+        memcpy(other->sums, branch->sums + half, other->childCount * sizeof(double));
+
+        if (slot > half) {
+
+            node = sibling;
+            slot -= half;
+        }
+    }
+
+    TGLRevealTableBranch *branch = &table->branches[node];
+    long moved = branch->childCount - slot;
+
+    memmove(branch->children + slot + 1, branch->children + slot, moved * sizeof(long));
+    memmove(branch->counts + slot + 1, branch->counts + slot, moved * sizeof(long));
+    memmove(branch->sums + slot + 1, branch->sums + slot, moved * sizeof(double));
+
+    branch->children[slot] = child;
+    branch->childCount += 1;
+
+    TGLRevealTableNodeTotals(table, child, level - 1, &branch->counts[slot], &branch->sums[slot]);
+
+    return sibling;
+}
+
+void TGLRevealTableInsert(TGLRevealTable *table, long item, double value) {
+
+    if (table->root < 0) TGLRevealTableReset(table, NULL, 0);
+
+    TGLRevealTablePath path;
+    long leaf = TGLRevealTableFindLeaf(table, &item, true, &path);
+    long sibling = -1;
+
+    // Full leaves are split in half, so
+    // that leaves only split again after
+    // half their capacity was inserted
+    //
+    if (table->leafSizes[leaf] == TGLRevealTableLeafCapacity) {
+
+        long half = TGLRevealTableLeafCapacity / 2;
+
+        sibling = TGLRevealTableAddLeaf(table);
+
+        memcpy(table->leafValues + sibling * TGLRevealTableLeafCapacity, table->leafValues + leaf * TGLRevealTableLeafCapacity + half, (TGLRevealTableLeafCapacity - half) * sizeof(double));
+
+        table->leafSizes[sibling] = TGLRevealTableLeafCapacity - half;
+        table->leafSizes[leaf] = half;
+
+        if (item > half) {
+
+            leaf = sibling;
+            item -= half;
+        }
+    }
+
+    double *values = table->leafValues + leaf * TGLRevealTableLeafCapacity;
+
+    memmove(values + item + 1, values + item, (table->leafSizes[leaf] - item) * sizeof(double));
+
+    values[item] = value;
+    table->leafSizes[leaf] += 1;
+    table->count += 1;
+
+    // Update totals bottom up, adding
+    // split nodes to their parents
+    //
+    for (long depth = table->height - 1; depth >= 0; depth--) {
+
+        long node = path.branches[depth];
+        long slot = path.slots[depth];
+        long level = table->height - depth;
+        TGLRevealTableBranch *branch = &table->branches[node];
+
+        TGLRevealTableNodeTotals(table, branch->children[slot], level - 1, &branch->counts[slot], &branch->sums[slot]);
+
+        if (sibling >= 0) sibling = TGLRevealTableInsertChild(table, node, slot + 1, sibling, level);
+    }
+
+    if (sibling >= 0) {
+
+        long root = TGLRevealTableAddBranch(table);
+        TGLRevealTableBranch *branch = &table->branches[root];
+
+        branch->childCount = 2;
+        branch->children[0] = table->root;
+        branch->children[1] = sibling;
+
+        TGLRevealTableNodeTotals(table, table->root, table->height, &branch->counts[0], &branch->sums[0]);
+        TGLRevealTableNodeTotals(table, sibling, table->height, &branch->counts[1], &branch->sums[1]);
+
+        table->root = root;
+        table->height += 1;
+    }
+}
+
+static void TGLRevealTableCompact(TGLRevealTable *table) {
+
+    double *values = malloc((table->count > 0 ? table->count : 1) * sizeof(double));
+
+    TGLRevealTableGetValues(table, 0, table->count, values);
+    TGLRevealTableReset(table, values, table->count);
+
+    free(values);
+}
+
+void TGLRevealTableRemove(TGLRevealTable *table, long item) {
+
+    TGLRevealTablePath path;
+    long leaf = TGLRevealTableFindLeaf(table, &item, false, &path);
+    double *values = table->leafValues + leaf * TGLRevealTableLeafCapacity;
+
+    memmove(values + item, values + item + 1, (table->leafSizes[leaf] - item - 1) * sizeof(double));
+
+    table->leafSizes[leaf] -= 1;
+    table->count -= 1;
+
+    TGLRevealTableUpdatePath(table, &path);
+
+    // Nodes are never merged, instead the tree
+    // is rebuilt once removals left leaves less
+    // than half full on average. Rebuilding
+    // takes O(n) after at least n/2 edits
+    //
+    if (table->leafCount > 2 * ((table->count + TGLRevealTableLeafCapacity - 1) / TGLRevealTableLeafCapacity) + 2) TGLRevealTableCompact(table);
+}
+
+void TGLRevealTableUpdate(TGLRevealTable *table, const long *deletedItems, long deletedCount, const long *insertedItems, const double *insertedValues, long insertedCount) {
+
+    if (table->root < 0) TGLRevealTableReset(table, NULL, 0);
+
+    // Few edits are applied one by one, removing
+    // from the end so that indices stay valid
+    //
+    if ((deletedCount + insertedCount) * TGLRevealTableLeafCapacity < table->count) {
+
+        for (long d = deletedCount - 1; d >= 0; d--) TGLRevealTableRemove(table, deletedItems[d]);
+        for (long i = 0; i < insertedCount; i++) TGLRevealTableInsert(table, insertedItems[i], insertedValues[i]);
+
+        return;
+    }
+
+    // Many edits rebuild the table instead,
+    // compacting remaining items first ...
+    //
+    long newCount = table->count - deletedCount + insertedCount;
+    long capacity = (newCount > table->count) ? newCount : table->count;
+    double *values = malloc((capacity > 0 ? capacity : 1) * sizeof(double));
+    long count = 0;
+
+    TGLRevealTableGetValues(table, 0, table->count, values);
+
+    for (long item = 0, d = 0; item < table->count; item++) {
+
+        if (d < deletedCount && deletedItems[d] == item) {
+
+            d++;
+
+        } else {
+
+            values[count++] = values[item];
+        }
+    }
+
+    // ... then spreading them from the end
+    // to make room for inserted items
+    //
+    long source = count - 1;
+    long i = insertedCount - 1;
+
+    for (long item = newCount - 1; item >= 0; item--) {
+
+        if (i >= 0 && insertedItems[i] == item) {
+
+            values[item] = insertedValues[i--];
+
+        } else {
+
+            values[item] = values[source--];
+        }
+    }
+
+    TGLRevealTableReset(table, values, newCount);
+
+    free(values);
+}
+
+double TGLRevealTablePrefix(const TGLRevealTable *table, long count) {
+
+    if (count > table->count) count = table->count;
+    if (count <= 0) return 0.0;
+
+    // Whole children preceding the item
+    // are added by their sums, the rest
+    // of its leaf item by item
+    //
+    double sum = 0.0;
+    long node = table->root;
+
+    for (long level = table->height; level > 0; level--) {
+
+        const TGLRevealTableBranch *branch = &table->branches[node];
+        long slot = 0;
+
+        while (count >= branch->counts[slot]) {
+
+            sum += branch->sums[slot];
+            count -= branch->counts[slot++];
+
+            if (count == 0) return sum;
+        }
+
+        node = branch->children[slot];
+    }
+
+    const double *values = table->leafValues + node * TGLRevealTableLeafCapacity;
+
+    for (long i = 0; i < count; i++) sum += values[i];
+
+    return sum;
+}
+
+double TGLRevealTableTotal(const TGLRevealTable *table) {
+
+    return TGLRevealTablePrefix(table, table->count);
+}
+
+long TGLRevealTableCountBelow(const TGLRevealTable *table, double offset) {
+
+    // Item `i` is located at prefix(i), so first
+    // item is at 0.0. Count items with a prefix
+    // less than `offset`, skipping whole children
+    // ending before it
+    //
+    if (offset <= 0.0 || table->count == 0) return 0;
+
+    long count = 0;
+    long node = table->root;
+    double sum = 0.0;
+
+    for (long level = table->height; level > 0; level--) {
+
+        const TGLRevealTableBranch *branch = &table->branches[node];
+        long slot = 0;
+
+        while (slot < branch->childCount && sum + branch->sums[slot] < offset) {
+
+            sum += branch->sums[slot];
+            count += branch->counts[slot++];
+        }
+
+        if (slot == branch->childCount) return count;
+
+        node = branch->children[slot];
+    }
+
+    const double *values = table->leafValues + node * TGLRevealTableLeafCapacity;
+
+    for (long i = 0; i < table->leafSizes[node] && sum < offset; i++) {
+
+        sum += values[i];
+        count += 1;
+    }
+
+    return count;
+}
+
+// MARK: - Layout cache
+
+void TGLLayoutCacheInit(TGLLayoutCache *cache) {
+
+    cache->useCount = 0;
+
+    for (long i = 0; i < TGLLayoutCacheCapacity; i++) {
+
+        cache->entries[i].useCount = 0;
+
+        TGLRevealTableInit(&cache->entries[i].revealTable);
+    }
+}
+
+void TGLLayoutCacheFree(TGLLayoutCache *cache) {
+
+    for (long i = 0; i < TGLLayoutCacheCapacity; i++) TGLRevealTableFree(&cache->entries[i].revealTable);
+
+    TGLLayoutCacheInit(cache);
+}
+
+void TGLLayoutCacheRemoveAll(TGLLayoutCache *cache) {
+
+    for (long i = 0; i < TGLLayoutCacheCapacity; i++) cache->entries[i].useCount = 0;
+}
+
+static bool TGLLayoutCacheKeyEqual(const TGLLayoutCacheKey *key, const TGLLayoutCacheKey *other) {
+
+    // Compare fields one by one, since
+    // padding bytes are undefined
+    //
+    return key->boundsWidth == other->boundsWidth && key->boundsHeight == other->boundsHeight &&
+           key->marginTop == other->marginTop && key->marginLeft == other->marginLeft &&
+           key->marginBottom == other->marginBottom && key->marginRight == other->marginRight &&
+           key->itemWidth == other->itemWidth && key->itemHeight == other->itemHeight &&
+           key->itemReveal == other->itemReveal && key->itemCount == other->itemCount &&
+           key->dataVersion == other->dataVersion;
+}
+
+const TGLLayoutCacheEntry *TGLLayoutCacheLookup(TGLLayoutCache *cache, const TGLLayoutCacheKey *key) {
+
+    for (long i = 0; i < TGLLayoutCacheCapacity; i++) {
+
+        TGLLayoutCacheEntry *entry = &cache->entries[i];
+
+        if (entry->useCount > 0 && TGLLayoutCacheKeyEqual(&entry->key, key)) {
+
+            entry->useCount = ++cache->useCount;
+
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+TGLLayoutCacheEntry *TGLLayoutCacheInsert(TGLLayoutCache *cache, const TGLLayoutCacheKey *key) {
+
+    // Replace entry with same key if any,
+    // otherwise an empty one, or the least
+    // recently used one
+    //
+    TGLLayoutCacheEntry *entry = &cache->entries[0];
+
+    for (long i = 0; i < TGLLayoutCacheCapacity; i++) {
+
+        TGLLayoutCacheEntry *candidate = &cache->entries[i];
+
+        if (candidate->useCount > 0 && TGLLayoutCacheKeyEqual(&candidate->key, key)) {
+
+            entry = candidate;
+            break;
+        }
+
+        if (candidate->useCount < entry->useCount) entry = candidate;
+    }
+
+    entry->key = *key;
+    entry->useCount = ++cache->useCount;
+
+    return entry;
+}
+
+// MARK: - Stacked geometry
+
+void TGLStackedGeometryPrepare(TGLStackedGeometry *geometry, const TGLStackedParameters *parameters, long *firstCompressingItem) {
+
+    geometry->itemCount = parameters->itemCount;
+    geometry->itemReveal = parameters->itemReveal;
+    geometry->itemHeight = parameters->itemHeight;
+    geometry->revealTable = parameters->revealTable;
+    geometry->top = parameters->marginTop;
+    geometry->pinningOffset = parameters->contentOffset + parameters->marginTop;
+    geometry->pinnedItemCount = 0;
+    geometry->adjustment = TGLStackedAdjustmentNone;
+    geometry->adjustmentOffset = 0.0;
+    geometry->compressingItem = -1;
+    geometry->occlusionThreshold = parameters->occlusionThreshold;
+
+    if (parameters->itemCount == 1 && parameters->centerSingleItem) {
+
+        // Center single item if necessary
+        //
+        geometry->adjustment = TGLStackedAdjustmentCentering;
+        geometry->adjustmentOffset = 0.5 * (parameters->layoutHeight - parameters->itemHeight);
+
+    } else if (parameters->contentOffset + parameters->contentInsetTop < 0.0) {
+
+        // Expand cells when reaching top
+        // and user scrolls further down,
+        // i.e. when bouncing
+        //
+        geometry->adjustment = TGLStackedAdjustmentExpanding;
+        geometry->adjustmentOffset = -parameters->bounceFactor * (parameters->contentOffset + parameters->contentInsetTop);
+
+    } else {
+
+        // Topmost cells overlap stack, but
+        // are placed directly above each
+        // other such that only one cell
+        // is visible
+        //
+        geometry->pinnedItemCount = TGLStackedGeometryPinnedItemCount(geometry, geometry->pinningOffset);
+
+        if (parameters->contentHeight > parameters->boundsHeight && parameters->contentOffset > parameters->contentHeight - parameters->boundsHeight) {
+
+            // Compress cells when reaching bottom
+            // and user scrolls further up,
+            // i.e. when bouncing
+            //
+            // First unpinned item at start of
+            // bouncing serves as anchor while
+            // bouncing continues
+            //
+            geometry->adjustment = TGLStackedAdjustmentCompressing;
+            geometry->adjustmentOffset = parameters->bounceFactor * (parameters->contentOffset + parameters->boundsHeight - parameters->contentHeight);
+
+            if (*firstCompressingItem < 0 && geometry->pinnedItemCount < geometry->itemCount) *firstCompressingItem = geometry->pinnedItemCount;
+
+            geometry->compressingItem = *firstCompressingItem;
+
+        } else if (geometry->pinnedItemCount < geometry->itemCount) {
+
+            *firstCompressingItem = -1;
+        }
+    }
+}
+
+long TGLStackedGeometryPinnedItemCount(const TGLStackedGeometry *geometry, double pinningOffset) {
+
+    // Items are pinned while their regular
+    // position is above the pinning offset,
+    // i.e. while `top + reveal * item < pinningOffset`
+    //
+    long itemCount = geometry->itemCount;
+    double offset = pinningOffset - geometry->top;
+    long count;
+
+    if (geometry->revealTable) {
+
+        count = TGLRevealTableCountBelow(geometry->revealTable, offset);
+
+        return (count < itemCount) ? count : itemCount;
+    }
+
+    if (offset <= 0.0) {
+
+        count = 0;
+
+    } else if (geometry->itemReveal <= 0.0) {
+
+        count = itemCount;
+
+    } else {
+
+        count = (long)fmin(ceil(offset / geometry->itemReveal), (double)itemCount);
+    }
+
+    // Compensate rounding errors w/ respect
+    // to the exact comparison used above
+    //
+    while (count > 0 && geometry->top + geometry->itemReveal * (count - 1) >= pinningOffset) count--;
+    while (count < itemCount && geometry->top + geometry->itemReveal * count < pinningOffset) count++;
+
+    return count;
+}
+
+double TGLStackedGeometryOriginY(const TGLStackedGeometry *geometry, long item) {
+
+    double originY = 0.0;
+
+    TGLStackedGeometryGetItems(geometry, item, 1, &originY, NULL);
+
+    return originY;
+}
+
+static bool TGLStackedGeometryOccluded(const TGLStackedGeometry *geometry, long item, double originY, double nextOriginY) {
+
+    // Pinned items are handled separately,
+    // and last item is never covered
+    //
+    if (item < geometry->pinnedItemCount || item >= geometry->itemCount - 1) return false;
+
+    // Successor covers all but a sliver less
+    // than threshold, unless compression
+    // reversed order of items
+    //
+    return nextOriginY >= originY && nextOriginY - originY < geometry->occlusionThreshold;
+}
+
+TGLLayoutItemFlags TGLStackedGeometryFlags(const TGLStackedGeometry *geometry, long item) {
+
+    // Only the two top overlapping items
+    // are visible while pinned
+    //
+    if (item < geometry->pinnedItemCount - 2) return TGLLayoutItemFlagHidden;
+
+    if (geometry->occlusionThreshold > 0.0 && item + 1 < geometry->itemCount) {
+
+        double originY[2];
+
+        TGLStackedGeometryGetItems(geometry, item, 2, originY, NULL);
+
+        if (TGLStackedGeometryOccluded(geometry, item, originY[0], originY[1])) return TGLLayoutItemFlagHidden;
+    }
+
+    return 0;
+}
+
+void TGLStackedGeometryGetItems(const TGLStackedGeometry *geometry, long first, long count, double *originY, TGLLayoutItemFlags *flags) {
+
+    if (originY) {
+
+        double * restrict y = originY;
+        const double top = geometry->top;
+        const double pin = geometry->pinningOffset;
+
+        // Start with offsets of items within
+        // stack, i.e. sum of reveal heights
+        // of all preceding items
+        //
+        if (geometry->revealTable) {
+
+            double sum = TGLRevealTablePrefix(geometry->revealTable, first);
+
+            TGLRevealTableGetValues(geometry->revealTable, first, count, y);
+
+            for (long i = 0; i < count; i++) {
+
+                double value = y[i];
+
+                y[i] = sum;
+                sum += value;
+            }
+
+        } else {
+
+            const double reveal = geometry->itemReveal;
+
+            for (long i = 0; i < count; i++) y[i] = reveal * (double)(first + i);
+        }
+
+        // Loops below are free of branches
+        // depending on the item, so that
+        // they can be vectorized
+        //
+        switch (geometry->adjustment) {
+
+            case TGLStackedAdjustmentCentering: {
+
+                const double centeredTop = top + geometry->adjustmentOffset;
+
+                for (long i = 0; i < count; i++) y[i] += centeredTop;
+                break;
+            }
+
+            case TGLStackedAdjustmentExpanding: {
+
+                // Reveal grows with bounce distance
+                //
+                const double expansion = geometry->adjustmentOffset;
+
+                for (long i = 0; i < count; i++) y[i] += top + expansion * (double)(first + i);
+                break;
+            }
+
+            case TGLStackedAdjustmentCompressing: {
+
+                // Reveal shrinks with bounce distance
+                // relative to anchor item, but items
+                // never move above pinned items
+                //
+                const double compression = (geometry->compressingItem >= 0) ? geometry->adjustmentOffset : 0.0;
+                const double compressedTop = top + compression * (double)geometry->compressingItem;
+                const long pinnedItemCount = geometry->pinnedItemCount;
+
+                for (long i = 0; i < count; i++) {
+
+                    double value = compressedTop + y[i] - compression * (double)(first + i);
+
+                    value = (value < pin) ? pin : value;
+                    y[i] = (first + i < pinnedItemCount) ? pin : value;
+                }
+
+                break;
+            }
+
+            case TGLStackedAdjustmentNone:
+
+                // Pinned items are exactly those
+                // whose regular origin is above
+                // pinning offset
+                //
+                for (long i = 0; i < count; i++) {
+
+                    double value = top + y[i];
+
+                    y[i] = (value < pin) ? pin : value;
+                }
+
+                break;
+        }
+    }
+
+    if (flags) {
+
+        TGLLayoutItemFlags * restrict f = flags;
+        const long hiddenItemCount = geometry->pinnedItemCount - 2;
+
+        for (long i = 0; i < count; i++) f[i] = (first + i < hiddenItemCount) ? TGLLayoutItemFlagHidden : 0;
+
+        if (geometry->occlusionThreshold > 0.0 && count > 0) {
+
+            if (originY) {
+
+                // Origins are at hand, only the one
+                // following the last is missing
+                //
+                const long last = first + count - 1;
+                double nextOriginY = (last + 1 < geometry->itemCount) ? TGLStackedGeometryOriginY(geometry, last + 1) : originY[count - 1];
+
+                for (long i = 0; i < count; i++) {
+
+                    if (TGLStackedGeometryOccluded(geometry, first + i, originY[i], (i + 1 < count) ? originY[i + 1] : nextOriginY)) f[i] = TGLLayoutItemFlagHidden;
+                }
+
+            } else {
+
+                for (long i = 0; i < count; i++) f[i] = TGLStackedGeometryFlags(geometry, first + i);
+            }
+        }
+    }
+}
+
+static long TGLStackedGeometryLowerBound(const TGLStackedGeometry *geometry, long low, long high, double originY) {
+
+    // Returns first item in `[low, high)`
+    // with origin not less than `originY`
+    //
+    while (low < high) {
+
+        long mid = low + (high - low) / 2;
+
+        if (TGLStackedGeometryOriginY(geometry, mid) < originY) {
+
+            low = mid + 1;
+
+        } else {
+
+            high = mid;
+        }
+    }
+
+    return low;
+}
+
+void TGLStackedGeometryItemRange(const TGLStackedGeometry *geometry, double minY, double maxY, long *first, long *end) {
+
+    // Items pinned below the top two
+    // are hidden to improve performance
+    //
+    long firstItem = geometry->pinnedItemCount - 2;
+    long endItem = geometry->itemCount;
+
+    if (firstItem < 0) firstItem = 0;
+
+    // Item origins are non-decreasing, unless
+    // compression when bouncing at the bottom
+    // is strong enough to reverse the stack
+    //
+    // With per-item reveal heights any item's
+    // reveal might be less than compression
+    //
+    bool monotonic = true;
+
+    if (geometry->adjustment == TGLStackedAdjustmentCompressing && geometry->compressingItem >= 0) {
+
+        monotonic = (geometry->revealTable == NULL) && (geometry->adjustmentOffset < geometry->itemReveal);
+    }
+
+
+    if (firstItem < endItem && monotonic) {
+
+        firstItem = TGLStackedGeometryLowerBound(geometry, firstItem, endItem, minY - geometry->itemHeight);
+        endItem = TGLStackedGeometryLowerBound(geometry, firstItem, endItem, maxY);
+    }
+
+    *first = firstItem;
+    *end = (endItem < firstItem) ? firstItem : endItem;
+}
+
+void TGLStackedGeometryPredictItemRange(const TGLStackedParameters *parameters, double velocity, double duration, long *first, long *end) {
+
+    TGLStackedGeometry geometry;
+    TGLStackedParameters predicted = *parameters;
+    long firstCompressingItem = -1;
+    long currentFirst, currentEnd;
+
+    TGLStackedGeometryPrepare(&geometry, parameters, &firstCompressingItem);
+    TGLStackedGeometryItemRange(&geometry, parameters->contentOffset, parameters->contentOffset + parameters->boundsHeight, &currentFirst, &currentEnd);
+
+    // Scrolling decelerates at the content's
+    // edges, so predicted offset never goes
+    // beyond them
+    //
+    double minOffset = -parameters->contentInsetTop;
+    double maxOffset = fmax(minOffset, parameters->contentHeight - parameters->boundsHeight);
+
+    predicted.contentOffset = fmin(fmax(parameters->contentOffset + velocity * duration, minOffset), maxOffset);
+
+    long predictedFirst, predictedEnd;
+
+    firstCompressingItem = -1;
+
+    TGLStackedGeometryPrepare(&geometry, &predicted, &firstCompressingItem);
+    TGLStackedGeometryItemRange(&geometry, predicted.contentOffset, predicted.contentOffset + predicted.boundsHeight, &predictedFirst, &predictedEnd);
+
+    // Scrolling down reveals items at the bottom,
+    // scrolling up unpins items at the top
+    //
+    long firstItem = predictedFirst;
+    long endItem = predictedFirst;
+
+    if (velocity > 0.0) {
+
+        firstItem = (currentEnd > predictedFirst) ? currentEnd : predictedFirst;
+        endItem = predictedEnd;
+
+    } else if (velocity < 0.0) {
+
+        firstItem = predictedFirst;
+        endItem = (currentFirst < predictedEnd) ? currentFirst : predictedEnd;
+    }
+
+    *first = firstItem;
+    *end = (endItem < firstItem) ? firstItem : endItem;
+}
+
+// MARK: - Exposed geometry
+
+static double TGLExposedGeometryExposedItemHeight(const TGLExposedParameters *parameters) {
+
+    return (parameters->exposedItemHeight > 0.0) ? parameters->exposedItemHeight : parameters->itemHeight;
+}
+
+static double TGLExposedGeometryOverlappingOriginY(const TGLExposedGeometry *geometry, long item) {
+
+    // At max -bottomOverlapCount
+    // overlapping item(s) at the
+    // bottom right below the
+    // exposed item
+    //
+    const TGLExposedParameters *parameters = &geometry->parameters;
+    long overlapCount = parameters->bottomOverlapCount + 1;
+
+    if (overlapCount > parameters->itemCount - parameters->exposedItem) overlapCount = parameters->itemCount - parameters->exposedItem;
+
+    long count = overlapCount - (item - parameters->exposedItem);
+
+    return parameters->marginTop + TGLExposedGeometryExposedItemHeight(parameters) - count * parameters->bottomOverlap;
+}
+
+void TGLExposedGeometryPrepare(TGLExposedGeometry *geometry, const TGLExposedParameters *parameters) {
+
+    long itemCount = parameters->itemCount;
+    long exposedItem = parameters->exposedItem;
+
+    geometry->parameters = *parameters;
+
+    long bottomPinningCount = itemCount - exposedItem - 1;
+
+    if (parameters->bottomPinningCount < bottomPinningCount) bottomPinningCount = parameters->bottomPinningCount;
+    if (bottomPinningCount < 0) bottomPinningCount = itemCount - exposedItem - 1;
+
+    long topPinningCount = parameters->topPinningCount;
+
+    if (topPinningCount < 0) topPinningCount = exposedItem;
+
+    geometry->bottomPinningCount = bottomPinningCount;
+    geometry->topPinningCount = topPinningCount;
+
+    // Issue #21
+    //
+    // Make sure overlapping cards
+    // reach to the bottom before
+    // being hidden
+    //
+    long bottomOverlapCount = parameters->bottomOverlapCount;
+
+    if (bottomOverlapCount > 0) {
+
+        while (exposedItem + bottomOverlapCount < itemCount && TGLExposedGeometryOverlappingOriginY(geometry, exposedItem + bottomOverlapCount) < parameters->boundsHeight - parameters->marginBottom) {
+
+            ++bottomOverlapCount;
+        }
+    }
+
+    geometry->bottomOverlapCount = bottomOverlapCount;
+}
+
+double TGLExposedGeometryOriginY(const TGLExposedGeometry *geometry, long item) {
+
+    double originY = 0.0;
+
+    TGLExposedGeometryGetItems(geometry, item, 1, &originY, NULL);
+
+    return originY;
+}
+
+TGLLayoutItemFlags TGLExposedGeometryFlags(const TGLExposedGeometry *geometry, long item) {
+
+    TGLLayoutItemFlags flags = 0;
+
+    TGLExposedGeometryGetItems(geometry, item, 1, NULL, &flags);
+
+    return flags;
+}
+
+void TGLExposedGeometryGetItems(const TGLExposedGeometry *geometry, long first, long count, double *originY, TGLLayoutItemFlags *flags) {
+
+    const TGLExposedParameters *parameters = &geometry->parameters;
+    const long exposedItem = parameters->exposedItem;
+
+    for (long i = 0; i < count; i++) {
+
+        long item = first + i;
+        double y;
+        TGLLayoutItemFlags f = 0;
+
+        if (item < exposedItem) {
+
+            if (parameters->pinning == TGLExposedPinningAll) {
+
+                long pinningCount = exposedItem - item;
+
+                if (pinningCount > geometry->topPinningCount) {
+
+                    y = parameters->contentHeight;
+                    f = TGLLayoutItemFlagHidden;
+
+                } else {
+
+                    pinningCount += geometry->bottomPinningCount;
+
+                    y = parameters->contentHeight - parameters->marginBottom - pinningCount * parameters->bottomOverlap;
+                }
+
+            } else {
+
+                // Items before exposed item
+                // are aligned above top with
+                // amount -topOverlap
+                //
+                y = parameters->marginTop - parameters->topOverlap;
+
+                // Items below first unexposed
+                // are hidden to improve
+                // performance
+                //
+                if (item < exposedItem - 1) f = TGLLayoutItemFlagHidden;
+            }
+
+        } else if (item == exposedItem) {
+
+            // Exposed item
+            //
+            y = parameters->marginTop;
+
+        } else if (parameters->pinning != TGLExposedPinningNone) {
+
+            // Pinning lower items to bottom
+            //
+            if (item > exposedItem + geometry->bottomPinningCount) {
+
+                y = parameters->contentHeight;
+                f = TGLLayoutItemFlagHidden;
+
+            } else {
+
+                long pinningCount = geometry->bottomPinningCount + 1;
+
+                if (pinningCount > parameters->itemCount - exposedItem) pinningCount = parameters->itemCount - exposedItem;
+
+                pinningCount -= item - exposedItem;
+
+                y = parameters->contentHeight - parameters->marginBottom - pinningCount * parameters->bottomOverlap;
+            }
+
+        } else if (item > exposedItem + geometry->bottomOverlapCount) {
+
+            // Items following overlapping
+            // items at bottom are hidden
+            // to improve performance
+            //
+            y = parameters->contentHeight;
+            f = TGLLayoutItemFlagHidden;
+
+        } else {
+
+            y = TGLExposedGeometryOverlappingOriginY(geometry, item);
+        }
+
+        if (originY) originY[i] = y;
+        if (flags) flags[i] = f;
+    }
+}
+
+static long TGLExposedGeometryLowerBound(const TGLExposedGeometry *geometry, long low, long high, double originY) {
+
+    // Returns first item in `[low, high)`
+    // with origin not less than `originY`
+    //
+    while (low < high) {
+
+        long mid = low + (high - low) / 2;
+
+        if (TGLExposedGeometryOriginY(geometry, mid) < originY) {
+
+            low = mid + 1;
+
+        } else {
+
+            high = mid;
+        }
+    }
+
+    return low;
+}
+
+long TGLExposedGeometryItemRanges(const TGLExposedGeometry *geometry, double minY, double maxY, long *first, long *end) {
+
+    const TGLExposedParameters *parameters = &geometry->parameters;
+    const long itemCount = parameters->itemCount;
+    const long exposedItem = parameters->exposedItem;
+
+    if (itemCount <= 0 || exposedItem < 0 || exposedItem >= itemCount) {
+
+        first[0] = 0;
+        end[0] = (itemCount > 0) ? itemCount : 0;
+
+        return 1;
+    }
+
+    // Visible items above ...
+    //
+    long aboveCount = (parameters->pinning == TGLExposedPinningAll) ? geometry->topPinningCount : 1;
+
+    if (aboveCount > exposedItem) aboveCount = exposedItem;
+
+    // ... and below exposed item
+    //
+    long belowCount = (parameters->pinning != TGLExposedPinningNone) ? geometry->bottomPinningCount : geometry->bottomOverlapCount;
+
+    if (belowCount > itemCount - exposedItem - 1) belowCount = itemCount - exposedItem - 1;
+
+    long segments[3][2] = {
+
+        { exposedItem - aboveCount, exposedItem },
+        { exposedItem, exposedItem + 1 },
+        { exposedItem + 1, exposedItem + 1 + belowCount }
+    };
+
+    // Within each segment origins increase
+    // with item index as long as overlaps
+    // are not negative
+    //
+    bool monotonic = (parameters->bottomOverlap >= 0.0);
+    long count = 0;
+
+    for (int i = 0; i < 3; i++) {
+
+        long firstItem = segments[i][0];
+        long endItem = segments[i][1];
+        double itemHeight = (i == 1) ? TGLExposedGeometryExposedItemHeight(parameters) : parameters->itemHeight;
+
+        if (firstItem < endItem && monotonic) {
+
+            firstItem = TGLExposedGeometryLowerBound(geometry, firstItem, endItem, minY - itemHeight);
+            endItem = TGLExposedGeometryLowerBound(geometry, firstItem, endItem, maxY);
+        }
+
+        if (firstItem < endItem) {
+
+            first[count] = firstItem;
+            end[count] = endItem;
+            count++;
+        }
+    }
+
+    return count;
+}
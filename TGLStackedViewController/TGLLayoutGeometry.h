@@ -0,0 +1,459 @@
+//
+//  TGLLayoutGeometry.h
+//  TGLStackedViewController
+//
+//  Created by Tim Gleue on 17.10.26.
+//  Copyright (c) 2026 Tim Gleue ( http://gleue-interactive.com )
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+#ifndef TGLLayoutGeometry_h
+#define TGLLayoutGeometry_h
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Platform-neutral item geometry of stacked and exposed layouts.
+ *
+ * Functions in this file do not depend on UIKit or Foundation.
+ * They compute vertical item origins and flags only, since all
+ * items share the same x position, width and height, and
+ * operate on plain arrays, i.e. structure-of-arrays buffers.
+ */
+
+/** Item flags */
+enum {
+
+    TGLLayoutItemFlagHidden = 1 << 0    /* Item is hidden to improve performance */
+};
+
+typedef unsigned char TGLLayoutItemFlags;
+
+// MARK: - Section table
+
+/** Sections of a collection view, each stacked after the previous one
+ *
+ * Layouts address items by their global index, i.e. their
+ * position in the concatenation of all sections. This table
+ * maps global indices to sections and back.
+ */
+typedef struct {
+
+    long count;
+    long capacity;
+    long *starts;               /* Global index of each section's first item, plus total item count */
+
+} TGLSectionTable;
+
+/** Initializes an empty table */
+void TGLSectionTableInit(TGLSectionTable *table);
+
+/** Frees memory held by table, leaving it empty */
+void TGLSectionTableFree(TGLSectionTable *table);
+
+/** Replaces the table's content with `count` sections' item counts
+ *
+ * Returns `true` if the table changed, i.e. if global indices
+ * of at least one section changed.
+ */
+bool TGLSectionTableReset(TGLSectionTable *table, const long *itemCounts, long count);
+
+/** Returns `true` if both tables contain the same sections */
+bool TGLSectionTableEqual(const TGLSectionTable *table, const TGLSectionTable *other);
+
+/** Returns the total number of items */
+long TGLSectionTableItemCount(const TGLSectionTable *table);
+
+/** Returns the global index of the first item in `section` */
+long TGLSectionTableStart(const TGLSectionTable *table, long section);
+
+/** Returns the section containing the item at global index `item` in O(log sections)
+ *
+ * Empty sections are skipped.
+ */
+long TGLSectionTableSection(const TGLSectionTable *table, long item);
+
+// MARK: - Item updates
+
+/** Returns the index after a batch update of the item at index `item` before it
+ *
+ * `deletedItems` are indices before the update and `insertedItems`
+ * indices after it, both sorted ascending. Returns -1 if the item
+ * was deleted. Cost is O(log deletedCount + insertedCount).
+ */
+long TGLItemUpdateMap(const long *deletedItems, long deletedCount, const long *insertedItems, long insertedCount, long item);
+
+/** Marks a longest strictly increasing subsequence of `values` in `members` in O(n log n)
+ *
+ * Given the indices before an update of items kept by it, in
+ * their order after the update, unmarked items are a minimal
+ * set of items to move. Returns the subsequence's length.
+ */
+long TGLItemLongestIncreasingSubsequence(const long *values, long count, bool *members);
+
+// MARK: - Reveal table
+
+/** Number of reveal heights per leaf of a reveal table */
+#define TGLRevealTableLeafCapacity 64
+
+/** Maximum number of children per branch of a reveal table */
+#define TGLRevealTableBranchCapacity 16
+
+/** Inner node of a reveal table with item count and sum of reveal heights of each child */
+typedef struct {
+
+    long childCount;
+    long children[TGLRevealTableBranchCapacity];
+    long counts[TGLRevealTableBranchCapacity];
+    double sums[TGLRevealTableBranchCapacity];
+
+} TGLRevealTableBranch;
+
+/** Per-item reveal heights of stacked items kept in a balanced tree
+ *
+ * Allows to look up the sum of reveal heights preceding any
+ * item, i.e. its offset in the stack, and to find the item
+ * at any offset in O(log n). Leaves hold consecutive items'
+ * reveal heights and branches item counts and sums of their
+ * children, so that changing, inserting or removing single
+ * items is O(log n), too.
+ */
+typedef struct {
+
+    long count;
+    long height;                /* Number of branch levels above leaves */
+    long root;                  /* Root branch, or root leaf if height is 0, or -1 if never filled */
+
+    long leafCount;
+    long leafCapacity;
+    double *leafValues;         /* `TGLRevealTableLeafCapacity` reveal heights per leaf */
+    long *leafSizes;            /* Number of reveal heights used per leaf */
+
+    long branchCount;
+    long branchCapacity;
+    TGLRevealTableBranch *branches;
+
+} TGLRevealTable;
+
+/** Initializes an empty table */
+void TGLRevealTableInit(TGLRevealTable *table);
+
+/** Frees memory held by table, leaving it empty */
+void TGLRevealTableFree(TGLRevealTable *table);
+
+/** Replaces the table's content with `count` reveal heights in O(n) */
+void TGLRevealTableReset(TGLRevealTable *table, const double *values, long count);
+
+/** Runs `work(context, i)` for all `i` in `[0, iterations)`, possibly concurrently, e.g. using `dispatch_apply_f` */
+typedef void (*TGLConcurrentApplyFunction)(size_t iterations, void *context, void (*work)(void *context, size_t iteration));
+
+/** Number of items per chunk when building reveal tables concurrently, filling two levels of branches */
+#define TGLRevealTableChunkSize 16384
+
+/** Same as `TGLRevealTableReset`, building the tree in chunks run by `apply`
+ *
+ * Leaves and branches covering items of a single chunk
+ * are built per chunk, the few branches spanning chunk
+ * boundaries are built serially afterwards. Sums are
+ * accumulated in the same order as by `TGLRevealTableReset`,
+ * so results are identical. Tables of less than two chunks
+ * or a `NULL` function are built serially.
+ */
+void TGLRevealTableResetConcurrently(TGLRevealTable *table, const double *values, long count, TGLConcurrentApplyFunction apply);
+
+/** Replaces the table's content with a copy of `other` in O(n) without rebuilding the tree */
+void TGLRevealTableCopy(TGLRevealTable *table, const TGLRevealTable *other);
+
+/** Returns reveal height of `item` in O(log n) */
+double TGLRevealTableValue(const TGLRevealTable *table, long item);
+
+/** Copies reveal heights of `count` items starting at `first` to `values` in O(log n + count) */
+void TGLRevealTableGetValues(const TGLRevealTable *table, long first, long count, double *values);
+
+/** Sets reveal height of `item` in O(log n) */
+void TGLRevealTableSetValue(TGLRevealTable *table, long item, double value);
+
+/** Inserts an item with reveal height `value` at index `item` in O(log n) */
+void TGLRevealTableInsert(TGLRevealTable *table, long item, double value);
+
+/** Removes item at index `item` in amortized O(log n)
+ *
+ * Leaves are not merged when getting empty. Instead the table
+ * is rebuilt when they are less than half full on average.
+ */
+void TGLRevealTableRemove(TGLRevealTable *table, long item);
+
+/** Applies a batch update of `k` items
+ *
+ * Removes items at `deletedItems`, i.e. indices before the
+ * update, and inserts `insertedCount` items with reveal heights
+ * `insertedValues` at `insertedItems`, i.e. indices after the
+ * update. Both index lists must be sorted ascending. Few edits
+ * are applied one by one in O(k log n), many by rebuilding the
+ * table in O(n + k).
+ */
+void TGLRevealTableUpdate(TGLRevealTable *table, const long *deletedItems, long deletedCount, const long *insertedItems, const double *insertedValues, long insertedCount);
+
+/** Returns the sum of reveal heights of the first `count` items in O(log n) */
+double TGLRevealTablePrefix(const TGLRevealTable *table, long count);
+
+/** Returns the sum of all reveal heights */
+double TGLRevealTableTotal(const TGLRevealTable *table);
+
+/** Returns the number of items whose offset, i.e. prefix, is less than `offset` in O(log n)
+ *
+ * Requires all reveal heights to be non-negative.
+ */
+long TGLRevealTableCountBelow(const TGLRevealTable *table, double offset);
+
+// MARK: - Layout cache
+
+/** Inputs per-item tables computed by a layout depend on */
+typedef struct {
+
+    double boundsWidth;
+    double boundsHeight;
+    double marginTop;
+    double marginLeft;
+    double marginBottom;
+    double marginRight;
+    double itemWidth;
+    double itemHeight;
+    double itemReveal;
+    long itemCount;
+    unsigned long dataVersion;  /* Changed by layout whenever data source content changes */
+
+} TGLLayoutCacheKey;
+
+/** Maximum number of entries kept by `TGLLayoutCache` */
+#define TGLLayoutCacheCapacity 4
+
+/** Cached tables for a single key */
+typedef struct {
+
+    TGLLayoutCacheKey key;
+    unsigned long useCount;     /* Value of cache's `useCount` when last used or 0 if empty */
+    TGLRevealTable revealTable;
+
+} TGLLayoutCacheEntry;
+
+/** Least recently used cache of tables computed by layouts
+ *
+ * Allows to restore tables when returning to a previously seen
+ * geometry, e.g. when rotating back and forth, instead of
+ * querying the collection view's delegate for every item again.
+ * Entries keep their buffers when evicted to be reused.
+ */
+typedef struct {
+
+    unsigned long useCount;
+    TGLLayoutCacheEntry entries[TGLLayoutCacheCapacity];
+
+} TGLLayoutCache;
+
+/** Initializes an empty cache */
+void TGLLayoutCacheInit(TGLLayoutCache *cache);
+
+/** Frees memory held by cache, leaving it empty */
+void TGLLayoutCacheFree(TGLLayoutCache *cache);
+
+/** Removes all entries, keeping their buffers */
+void TGLLayoutCacheRemoveAll(TGLLayoutCache *cache);
+
+/** Returns the entry for `key` marking it most recently used or `NULL` if there is none */
+const TGLLayoutCacheEntry *TGLLayoutCacheLookup(TGLLayoutCache *cache, const TGLLayoutCacheKey *key);
+
+/** Returns an entry for `key` to store tables in, evicting the least recently used one if necessary */
+TGLLayoutCacheEntry *TGLLayoutCacheInsert(TGLLayoutCache *cache, const TGLLayoutCacheKey *key);
+
+// MARK: - Stacked geometry
+
+/** Adjustment applied to items in addition to stacking */
+typedef enum {
+
+    TGLStackedAdjustmentNone = 0,       /* Items are stacked and pinned to top */
+    TGLStackedAdjustmentCentering,      /* Single item is centered vertically */
+    TGLStackedAdjustmentExpanding,      /* Items expand when bouncing at top */
+    TGLStackedAdjustmentCompressing     /* Items compress when bouncing at bottom */
+
+} TGLStackedAdjustment;
+
+/** Input of a stacked layout pass */
+typedef struct {
+
+    long itemCount;
+    double itemReveal;          /* Amount shown of each item */
+    double itemHeight;
+
+    const TGLRevealTable *revealTable;  /* Per-item reveal heights or `NULL` to use `itemReveal` */
+
+    double marginTop;           /* Layout margin at top */
+    double layoutHeight;        /* Bounds' height minus top and bottom margins */
+    double boundsHeight;
+    double contentHeight;
+    double contentOffset;       /* Vertical content offset */
+    double contentInsetTop;
+    double bounceFactor;
+
+    bool centerSingleItem;
+
+    double occlusionThreshold;  /* Minimum height an item has to show to remain visible or 0 */
+
+} TGLStackedParameters;
+
+/** Result of a stacked layout pass, i.e. everything required to compute any item's origin */
+typedef struct {
+
+    long itemCount;
+    double itemReveal;
+    double itemHeight;
+    const TGLRevealTable *revealTable;
+    double top;                 /* Origin of first item before adjustment */
+    double pinningOffset;       /* Origin of items pinned to top */
+    long pinnedItemCount;       /* Number of items pinned to top */
+
+    TGLStackedAdjustment adjustment;
+    double adjustmentOffset;    /* Centering offset, or expansion/compression per item */
+    long compressingItem;       /* Anchor item when compressing or -1 */
+    double occlusionThreshold;
+
+} TGLStackedGeometry;
+
+/** Prepares stacked geometry for a layout pass.
+ *
+ * The compression anchor is kept in `firstCompressingItem`
+ * between passes while bouncing at the bottom. Initialize
+ * it to -1 and pass the same pointer for consecutive passes.
+ */
+void TGLStackedGeometryPrepare(TGLStackedGeometry *geometry, const TGLStackedParameters *parameters, long *firstCompressingItem);
+
+/** Returns the number of items pinned to top for given pinning offset */
+long TGLStackedGeometryPinnedItemCount(const TGLStackedGeometry *geometry, double pinningOffset);
+
+/** Returns vertical origin of `item` */
+double TGLStackedGeometryOriginY(const TGLStackedGeometry *geometry, long item);
+
+/** Returns flags of `item`
+ *
+ * Besides items pinned below the two top overlapping items,
+ * unpinned items are hidden if their successor starts less
+ * than `occlusionThreshold` below them, i.e. if the sliver
+ * left visible is thinner than that.
+ */
+TGLLayoutItemFlags TGLStackedGeometryFlags(const TGLStackedGeometry *geometry, long item);
+
+/** Computes origins and flags of `count` items starting at `first`
+ *
+ * Either buffer may be `NULL` if not required.
+ */
+void TGLStackedGeometryGetItems(const TGLStackedGeometry *geometry, long first, long count, double *originY, TGLLayoutItemFlags *flags);
+
+/** Returns in `first` and `end` the range of items possibly intersecting `[minY, maxY)`, excluding hidden items */
+void TGLStackedGeometryItemRange(const TGLStackedGeometry *geometry, double minY, double maxY, long *first, long *end);
+
+/** Returns in `first` and `end` the range of items becoming visible when scrolling for `duration` seconds
+ *
+ * Items are not visible at the content offset given in
+ * `parameters`, but intersect the bounds at the offset
+ * predicted for `velocity` points per second, clamped
+ * to the content size. Only items on the leading side
+ * in scrolling direction are returned.
+ */
+void TGLStackedGeometryPredictItemRange(const TGLStackedParameters *parameters, double velocity, double duration, long *first, long *end);
+
+// MARK: - Exposed geometry
+
+/** Layout mode for other than exposed items, equivalent to `TGLExposedLayoutPinningMode` */
+typedef enum {
+
+    TGLExposedPinningNone = 0,
+    TGLExposedPinningBelow,
+    TGLExposedPinningAll
+
+} TGLExposedPinning;
+
+/** Input of an exposed layout pass */
+typedef struct {
+
+    long itemCount;
+    long exposedItem;
+    double itemHeight;
+    double exposedItemHeight;   /* 0 for itemHeight */
+
+    double marginTop;
+    double marginBottom;
+    double boundsHeight;
+    double contentHeight;
+
+    double topOverlap;
+    double bottomOverlap;
+    long bottomOverlapCount;
+
+    TGLExposedPinning pinning;
+    long topPinningCount;       /* -1 for all */
+    long bottomPinningCount;    /* -1 for all */
+
+} TGLExposedParameters;
+
+/** Result of an exposed layout pass */
+typedef struct {
+
+    TGLExposedParameters parameters;
+
+    long topPinningCount;       /* Resolved number of items pinned above exposed item */
+    long bottomPinningCount;    /* Resolved number of items pinned below exposed item */
+    long bottomOverlapCount;    /* Resolved number of items overlapping below exposed item */
+
+} TGLExposedGeometry;
+
+/** Prepares exposed geometry for a layout pass */
+void TGLExposedGeometryPrepare(TGLExposedGeometry *geometry, const TGLExposedParameters *parameters);
+
+/** Returns vertical origin of `item` */
+double TGLExposedGeometryOriginY(const TGLExposedGeometry *geometry, long item);
+
+/** Returns flags of `item` */
+TGLLayoutItemFlags TGLExposedGeometryFlags(const TGLExposedGeometry *geometry, long item);
+
+/** Computes origins and flags of `count` items starting at `first`
+ *
+ * Either buffer may be `NULL` if not required.
+ */
+void TGLExposedGeometryGetItems(const TGLExposedGeometry *geometry, long first, long count, double *originY, TGLLayoutItemFlags *flags);
+
+/** Maximum number of ranges returned by `TGLExposedGeometryItemRanges` */
+#define TGLExposedGeometryMaxRangeCount 3
+
+/** Returns the number of ranges of items possibly intersecting `[minY, maxY)`, excluding hidden items
+ *
+ * Items above, at, and below the exposed item are laid out
+ * independently, so results are returned in up to three
+ * ascending `[first, end)` ranges in `first` and `end`.
+ */
+long TGLExposedGeometryItemRanges(const TGLExposedGeometry *geometry, double minY, double maxY, long *first, long *end);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TGLLayoutGeometry_h */
@@ -0,0 +1,103 @@
+//
+//  TGLLayoutMetrics.h
+//  TGLStackedViewController
+//
+//  Created by Tim Gleue on 17.10.26.
+//  Copyright (c) 2026 Tim Gleue ( http://gleue-interactive.com )
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/** Opt-in performance metrics recorded by stacked and exposed layouts.
+ *
+ * Assign an instance to `TGLStackedViewController`'s property
+ * `-layoutMetrics` to start recording. Layouts without metrics
+ * object record nothing.
+ *
+ * Counters are cumulative since creation or the last call to
+ * `-reset`, except for per-pass allocation counts. Sample them
+ * periodically using `-snapshot` to get values for a time span,
+ * e.g. while scrolling.
+ *
+ * A layout pass lasts until the next one begins, i.e. its
+ * allocation count includes allocations by queries made in
+ * between. Per-pass counts cover completed passes only.
+ */
+@interface TGLLayoutMetrics : NSObject <NSCopying>
+
+/** Number of layout passes, i.e. calls to `-prepareLayout` */
+@property (nonatomic, readonly) NSUInteger passCount;
+
+/** Total duration of all layout passes */
+@property (nonatomic, readonly) NSTimeInterval passDuration;
+
+/** Duration of longest layout pass */
+@property (nonatomic, readonly) NSTimeInterval maxPassDuration;
+
+/** Number of calls to `-layoutAttributesForElementsInRect:` */
+@property (nonatomic, readonly) NSUInteger queryCount;
+
+/** Total number of attributes returned from `-layoutAttributesForElementsInRect:` */
+@property (nonatomic, readonly) NSUInteger returnedCount;
+
+/** Number of visible items whose attributes were computed */
+@property (nonatomic, readonly) NSUInteger visibleCount;
+
+/** Number of hidden items whose attributes were computed */
+@property (nonatomic, readonly) NSUInteger hiddenCount;
+
+/** Number of attribute objects and index paths allocated */
+@property (nonatomic, readonly) NSUInteger allocationCount;
+
+/** Number of attribute objects and index paths allocated during the most recent completed layout pass */
+@property (nonatomic, readonly) NSUInteger lastPassAllocationCount;
+
+/** Number of attribute objects and index paths allocated during a single completed layout pass at most */
+@property (nonatomic, readonly) NSUInteger maxPassAllocationCount;
+
+/** Returns a copy of current values, not affected by subsequent recording */
+- (TGLLayoutMetrics *)snapshot;
+
+/** Clears all counters and samples */
+- (void)reset;
+
+/** Returns the duration of recent layout passes at `percentile` between 0.0 and 1.0.
+ *
+ * Only the most recent 256 passes are taken into account.
+ */
+- (NSTimeInterval)passDurationAtPercentile:(double)percentile;
+
+/** Begins a layout pass, completing the previous one. Called by layouts */
+- (void)beginPassWithAllocationCount:(NSUInteger)allocationCount;
+
+/** Records a layout pass. Called by layouts */
+- (void)recordPassWithDuration:(NSTimeInterval)duration allocationCount:(NSUInteger)allocationCount;
+
+/** Records computing attributes of items. Called by layouts */
+- (void)recordItemsWithVisibleCount:(NSUInteger)visibleCount hiddenCount:(NSUInteger)hiddenCount;
+
+/** Records a rect query. Called by layouts */
+- (void)recordQueryWithReturnedCount:(NSUInteger)returnedCount allocationCount:(NSUInteger)allocationCount;
+
+@end
+
+NS_ASSUME_NONNULL_END
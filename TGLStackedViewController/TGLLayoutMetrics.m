@@ -0,0 +1,150 @@
+//
+//  TGLLayoutMetrics.m
+//  TGLStackedViewController
+//
+//  Created by Tim Gleue on 17.10.26.
+//  Copyright (c) 2026 Tim Gleue ( http://gleue-interactive.com )
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+#import "TGLLayoutMetrics.h"
+#import "TGLLayoutRecorder.h"
+
+@interface TGLLayoutMetrics () {
+
+    TGLLayoutRecorder _recorder;
+}
+
+@end
+
+@implementation TGLLayoutMetrics
+
+- (instancetype)init {
+
+    self = [super init];
+
+    if (self) TGLLayoutRecorderReset(&_recorder);
+
+    return self;
+}
+
+- (id)copyWithZone:(NSZone *)zone {
+
+    TGLLayoutMetrics *copy = [[self.class allocWithZone:zone] init];
+
+    if (copy) copy->_recorder = _recorder;
+
+    return copy;
+}
+
+#pragma mark - Accessors
+
+- (NSUInteger)passCount {
+
+    return _recorder.counters.passCount;
+}
+
+- (NSTimeInterval)passDuration {
+
+    return _recorder.counters.passDuration;
+}
+
+- (NSTimeInterval)maxPassDuration {
+
+    return _recorder.counters.maxPassDuration;
+}
+
+- (NSUInteger)queryCount {
+
+    return _recorder.counters.queryCount;
+}
+
+- (NSUInteger)returnedCount {
+
+    return _recorder.counters.returnedCount;
+}
+
+- (NSUInteger)visibleCount {
+
+    return _recorder.counters.visibleCount;
+}
+
+- (NSUInteger)hiddenCount {
+
+    return _recorder.counters.hiddenCount;
+}
+
+- (NSUInteger)allocationCount {
+
+    return _recorder.counters.allocationCount;
+}
+
+- (NSUInteger)lastPassAllocationCount {
+
+    return _recorder.counters.lastPassAllocationCount;
+}
+
+- (NSUInteger)maxPassAllocationCount {
+
+    return _recorder.counters.maxPassAllocationCount;
+}
+
+#pragma mark - Methods
+
+- (TGLLayoutMetrics *)snapshot {
+
+    return [self copy];
+}
+
+- (void)reset {
+
+    TGLLayoutRecorderReset(&_recorder);
+}
+
+- (NSTimeInterval)passDurationAtPercentile:(double)percentile {
+
+    return TGLLayoutRecorderPassDurationPercentile(&_recorder, percentile);
+}
+
+- (void)beginPassWithAllocationCount:(NSUInteger)allocationCount {
+
+    TGLLayoutRecorderBeginPass(&_recorder, allocationCount);
+}
+
+- (void)recordPassWithDuration:(NSTimeInterval)duration allocationCount:(NSUInteger)allocationCount {
+
+    TGLLayoutRecorderRecordPass(&_recorder, duration, allocationCount);
+}
+
+- (void)recordItemsWithVisibleCount:(NSUInteger)visibleCount hiddenCount:(NSUInteger)hiddenCount {
+
+    TGLLayoutRecorderRecordItems(&_recorder, visibleCount, hiddenCount);
+}
+
+- (void)recordQueryWithReturnedCount:(NSUInteger)returnedCount allocationCount:(NSUInteger)allocationCount {
+
+    TGLLayoutRecorderRecordQuery(&_recorder, returnedCount, allocationCount);
+}
+
+- (NSString *)description {
+
+    return [NSString stringWithFormat:@"<%@: %p passes=%lu duration=%.3fms max=%.3fms queries=%lu returned=%lu visible=%lu hidden=%lu allocations=%lu (last pass %lu, max pass %lu)>", self.class, self, (unsigned long)self.passCount, 1000.0 * self.passDuration, 1000.0 * self.maxPassDuration, (unsigned long)self.queryCount, (unsigned long)self.returnedCount, (unsigned long)self.visibleCount, (unsigned long)self.hiddenCount, (unsigned long)self.allocationCount, (unsigned long)self.lastPassAllocationCount, (unsigned long)self.maxPassAllocationCount];
+}
+
+@end
@@ -0,0 +1,117 @@
+//
+//  TGLLayoutRecorder.c
+//  TGLStackedViewController
+//
+//  Created by Tim Gleue on 17.10.26.
+//  Copyright (c) 2026 Tim Gleue ( http://gleue-interactive.com )
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+#include "TGLLayoutRecorder.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+void TGLLayoutRecorderReset(TGLLayoutRecorder *recorder) {
+
+    memset(recorder, 0, sizeof(TGLLayoutRecorder));
+}
+
+void TGLLayoutRecorderBeginPass(TGLLayoutRecorder *recorder, unsigned long allocationCount) {
+
+    TGLLayoutCounters *counters = &recorder->counters;
+
+    counters->allocationCount += allocationCount;
+    counters->passAllocationCount += allocationCount;
+
+    // Nothing to complete before
+    // the very first pass
+    //
+    if (counters->passCount > 0) {
+
+        counters->lastPassAllocationCount = counters->passAllocationCount;
+
+        if (counters->passAllocationCount > counters->maxPassAllocationCount) counters->maxPassAllocationCount = counters->passAllocationCount;
+    }
+
+    counters->passAllocationCount = 0;
+}
+
+void TGLLayoutRecorderRecordPass(TGLLayoutRecorder *recorder, double duration, unsigned long allocationCount) {
+
+    TGLLayoutCounters *counters = &recorder->counters;
+
+    counters->passCount += 1;
+    counters->passDuration += duration;
+    counters->allocationCount += allocationCount;
+    counters->passAllocationCount += allocationCount;
+
+    if (duration > counters->maxPassDuration) counters->maxPassDuration = duration;
+
+    recorder->samples[recorder->sampleCount % TGLLayoutRecorderSampleCount] = duration;
+    recorder->sampleCount += 1;
+}
+
+void TGLLayoutRecorderRecordItems(TGLLayoutRecorder *recorder, unsigned long visibleCount, unsigned long hiddenCount) {
+
+    recorder->counters.visibleCount += visibleCount;
+    recorder->counters.hiddenCount += hiddenCount;
+}
+
+void TGLLayoutRecorderRecordQuery(TGLLayoutRecorder *recorder, unsigned long returnedCount, unsigned long allocationCount) {
+
+    TGLLayoutCounters *counters = &recorder->counters;
+
+    counters->queryCount += 1;
+    counters->returnedCount += returnedCount;
+    counters->allocationCount += allocationCount;
+    counters->passAllocationCount += allocationCount;
+}
+
+static int TGLLayoutRecorderCompareSamples(const void *a, const void *b) {
+
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+
+    return (x > y) - (x < y);
+}
+
+double TGLLayoutRecorderPassDurationPercentile(const TGLLayoutRecorder *recorder, double percentile) {
+
+    unsigned long count = recorder->sampleCount;
+
+    if (count > TGLLayoutRecorderSampleCount) count = TGLLayoutRecorderSampleCount;
+    if (count == 0) return 0.0;
+
+    // Nearest rank on a sorted copy,
+    // samples are few and percentiles
+    // are queried rarely
+    //
+    double samples[TGLLayoutRecorderSampleCount];
+
+    memcpy(samples, recorder->samples, count * sizeof(double));
+    qsort(samples, count, sizeof(double), TGLLayoutRecorderCompareSamples);
+
+    if (percentile < 0.0) percentile = 0.0;
+    if (percentile > 1.0) percentile = 1.0;
+
+    unsigned long rank = (unsigned long)(percentile * (count - 1) + 0.5);
+
+    return samples[rank];
+}
@@ -0,0 +1,99 @@
+//
+//  TGLLayoutRecorder.h
+//  TGLStackedViewController
+//
+//  Created by Tim Gleue on 17.10.26.
+//  Copyright (c) 2026 Tim Gleue ( http://gleue-interactive.com )
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+#ifndef TGLLayoutRecorder_h
+#define TGLLayoutRecorder_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Platform-neutral collection of layout performance metrics.
+ *
+ * Functions in this file do not depend on UIKit or Foundation.
+ * Timings are passed in by the caller in seconds.
+ */
+
+/** Number of recent layout pass durations kept for percentiles */
+#define TGLLayoutRecorderSampleCount 256
+
+/** Cumulative layout counters */
+typedef struct {
+
+    unsigned long passCount;            /* Number of layout passes */
+    double passDuration;                /* Total duration of layout passes */
+    double maxPassDuration;             /* Longest layout pass */
+
+    unsigned long queryCount;           /* Number of rect queries */
+    unsigned long returnedCount;        /* Attributes returned by rect queries */
+
+    unsigned long visibleCount;         /* Visible items whose attributes were computed */
+    unsigned long hiddenCount;          /* Hidden items whose attributes were computed */
+
+    unsigned long allocationCount;      /* Attribute objects and index paths allocated */
+    unsigned long passAllocationCount;      /* Allocated since the current layout pass began */
+    unsigned long lastPassAllocationCount;  /* Allocated during the most recent completed layout pass */
+    unsigned long maxPassAllocationCount;   /* Allocated during a single completed layout pass at most */
+
+} TGLLayoutCounters;
+
+typedef struct {
+
+    TGLLayoutCounters counters;
+
+    double samples[TGLLayoutRecorderSampleCount];   /* Ring buffer of recent pass durations */
+    unsigned long sampleCount;
+
+} TGLLayoutRecorder;
+
+/** Clears all counters and samples */
+void TGLLayoutRecorderReset(TGLLayoutRecorder *recorder);
+
+/** Begins a layout pass, completing the previous one.
+ *
+ * `allocationCount` objects allocated since the last report,
+ * e.g. by item queries, are counted toward the previous pass.
+ * A pass's allocation count includes those of all queries up
+ * to the beginning of the next pass.
+ */
+void TGLLayoutRecorderBeginPass(TGLLayoutRecorder *recorder, unsigned long allocationCount);
+
+/** Records a layout pass taking `duration` seconds and allocating `allocationCount` objects */
+void TGLLayoutRecorderRecordPass(TGLLayoutRecorder *recorder, double duration, unsigned long allocationCount);
+
+/** Records computing attributes of `visibleCount` visible and `hiddenCount` hidden items */
+void TGLLayoutRecorderRecordItems(TGLLayoutRecorder *recorder, unsigned long visibleCount, unsigned long hiddenCount);
+
+/** Records a rect query returning `returnedCount` attributes */
+void TGLLayoutRecorderRecordQuery(TGLLayoutRecorder *recorder, unsigned long returnedCount, unsigned long allocationCount);
+
+/** Returns the `percentile` (0...1) of recent layout pass durations or 0 if there are none */
+double TGLLayoutRecorderPassDurationPercentile(const TGLLayoutRecorder *recorder, double percentile);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TGLLayoutRecorder_h */
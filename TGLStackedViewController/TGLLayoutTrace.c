@@ -0,0 +1,323 @@
+//
+//  TGLLayoutTrace.c
+//  TGLStackedViewController
+//
+//  Created by Tim Gleue on 17.10.26.
+//  Copyright (c) 2026 Tim Gleue ( http://gleue-interactive.com )
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+#include "TGLLayoutTrace.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+// MARK: - Byte order
+
+static unsigned char *TGLLayoutTracePutUInt32(unsigned char *bytes, uint32_t value) {
+
+    for (int i = 0; i < 4; i++) bytes[i] = (unsigned char)(value >> (8 * i));
+
+    return bytes + 4;
+}
+
+static uint32_t TGLLayoutTraceGetUInt32(const unsigned char *bytes) {
+
+    return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+static unsigned char *TGLLayoutTracePutInt32(unsigned char *bytes, long value) {
+
+    if (value > INT32_MAX) value = INT32_MAX;
+    if (value < INT32_MIN) value = INT32_MIN;
+
+    return TGLLayoutTracePutUInt32(bytes, (uint32_t)(int32_t)value);
+}
+
+static long TGLLayoutTraceGetInt32(const unsigned char *bytes) {
+
+    return (long)(int32_t)TGLLayoutTraceGetUInt32(bytes);
+}
+
+static unsigned char *TGLLayoutTracePutFloat(unsigned char *bytes, float value) {
+
+    uint32_t bits;
+
+    memcpy(&bits, &value, sizeof(bits));
+
+    return TGLLayoutTracePutUInt32(bytes, bits);
+}
+
+static float TGLLayoutTraceGetFloat(const unsigned char *bytes) {
+
+    uint32_t bits = TGLLayoutTraceGetUInt32(bytes);
+    float value;
+
+    memcpy(&value, &bits, sizeof(value));
+
+    return value;
+}
+
+static unsigned char *TGLLayoutTracePutDouble(unsigned char *bytes, double value) {
+
+    uint64_t bits;
+
+    memcpy(&bits, &value, sizeof(bits));
+
+    bytes = TGLLayoutTracePutUInt32(bytes, (uint32_t)bits);
+
+    return TGLLayoutTracePutUInt32(bytes, (uint32_t)(bits >> 32));
+}
+
+static double TGLLayoutTraceGetDouble(const unsigned char *bytes) {
+
+    uint64_t bits = (uint64_t)TGLLayoutTraceGetUInt32(bytes) | ((uint64_t)TGLLayoutTraceGetUInt32(bytes + 4) << 32);
+    double value;
+
+    memcpy(&value, &bits, sizeof(value));
+
+    return value;
+}
+
+// MARK: - Header
+
+static const unsigned char TGLLayoutTraceMagic[4] = { 'T', 'G', 'L', 'T' };
+
+/* Bits of the header's flags */
+enum {
+
+    TGLLayoutTraceFillHeight = 1 << 0,
+    TGLLayoutTraceCenterSingleItem = 1 << 1,
+    TGLLayoutTraceAlwaysBounce = 1 << 2
+};
+
+void TGLLayoutTraceEncodeHeader(const TGLLayoutTraceHeader *header, unsigned char *bytes) {
+
+    uint32_t flags = (header->fillHeight ? TGLLayoutTraceFillHeight : 0) | (header->centerSingleItem ? TGLLayoutTraceCenterSingleItem : 0) | (header->alwaysBounce ? TGLLayoutTraceAlwaysBounce : 0);
+
+    memcpy(bytes, TGLLayoutTraceMagic, sizeof(TGLLayoutTraceMagic));
+
+    bytes = TGLLayoutTracePutUInt32(bytes + sizeof(TGLLayoutTraceMagic), TGLLayoutTraceVersion);
+
+    bytes = TGLLayoutTracePutDouble(bytes, header->marginTop);
+    bytes = TGLLayoutTracePutDouble(bytes, header->marginBottom);
+    bytes = TGLLayoutTracePutDouble(bytes, header->itemHeight);
+    bytes = TGLLayoutTracePutDouble(bytes, header->itemReveal);
+    bytes = TGLLayoutTracePutDouble(bytes, header->bounceFactor);
+    bytes = TGLLayoutTracePutDouble(bytes, header->occlusionThreshold);
+    bytes = TGLLayoutTracePutUInt32(bytes, flags);
+
+    bytes = TGLLayoutTracePutDouble(bytes, header->exposedMarginTop);
+    bytes = TGLLayoutTracePutDouble(bytes, header->exposedMarginBottom);
+    bytes = TGLLayoutTracePutDouble(bytes, header->exposedItemHeight);
+    bytes = TGLLayoutTracePutDouble(bytes, header->exposedTopOverlap);
+    bytes = TGLLayoutTracePutDouble(bytes, header->exposedBottomOverlap);
+    bytes = TGLLayoutTracePutInt32(bytes, header->exposedBottomOverlapCount);
+    bytes = TGLLayoutTracePutInt32(bytes, header->exposedPinning);
+    bytes = TGLLayoutTracePutInt32(bytes, header->exposedTopPinningCount);
+    TGLLayoutTracePutInt32(bytes, header->exposedBottomPinningCount);
+}
+
+bool TGLLayoutTraceDecodeHeader(const unsigned char *bytes, size_t length, TGLLayoutTraceHeader *header) {
+
+    if (length < TGLLayoutTraceHeaderSize || memcmp(bytes, TGLLayoutTraceMagic, sizeof(TGLLayoutTraceMagic)) != 0) return false;
+
+    bytes += sizeof(TGLLayoutTraceMagic);
+
+    if (TGLLayoutTraceGetUInt32(bytes) != TGLLayoutTraceVersion) return false;
+
+    bytes += 4;
+
+    header->marginTop = TGLLayoutTraceGetDouble(bytes);
+    header->marginBottom = TGLLayoutTraceGetDouble(bytes + 8);
+    header->itemHeight = TGLLayoutTraceGetDouble(bytes + 16);
+    header->itemReveal = TGLLayoutTraceGetDouble(bytes + 24);
+    header->bounceFactor = TGLLayoutTraceGetDouble(bytes + 32);
+    header->occlusionThreshold = TGLLayoutTraceGetDouble(bytes + 40);
+
+    uint32_t flags = TGLLayoutTraceGetUInt32(bytes + 48);
+
+    header->fillHeight = (flags & TGLLayoutTraceFillHeight) != 0;
+    header->centerSingleItem = (flags & TGLLayoutTraceCenterSingleItem) != 0;
+    header->alwaysBounce = (flags & TGLLayoutTraceAlwaysBounce) != 0;
+
+    bytes += 52;
+
+    header->exposedMarginTop = TGLLayoutTraceGetDouble(bytes);
+    header->exposedMarginBottom = TGLLayoutTraceGetDouble(bytes + 8);
+    header->exposedItemHeight = TGLLayoutTraceGetDouble(bytes + 16);
+    header->exposedTopOverlap = TGLLayoutTraceGetDouble(bytes + 24);
+    header->exposedBottomOverlap = TGLLayoutTraceGetDouble(bytes + 32);
+    header->exposedBottomOverlapCount = TGLLayoutTraceGetInt32(bytes + 40);
+    header->exposedPinning = (TGLExposedPinning)TGLLayoutTraceGetInt32(bytes + 44);
+    header->exposedTopPinningCount = TGLLayoutTraceGetInt32(bytes + 48);
+    header->exposedBottomPinningCount = TGLLayoutTraceGetInt32(bytes + 52);
+
+    return true;
+}
+
+// MARK: - Frames
+
+/* Bits of a frame's leading byte telling which values follow */
+enum {
+
+    TGLLayoutTraceContentOffset = 1 << 0,   /* Offset */
+    TGLLayoutTraceBounds = 1 << 1,          /* Width, height, top and bottom inset */
+    TGLLayoutTraceItemCount = 1 << 2,       /* Count */
+    TGLLayoutTraceProgress = 1 << 3,        /* Progress */
+    TGLLayoutTraceExposedItem = 1 << 4,     /* Item */
+    TGLLayoutTraceMove = 1 << 5,            /* Item, target x and y */
+    TGLLayoutTraceAllValues = (1 << 6) - 1
+};
+
+void TGLLayoutTraceFrameInit(TGLLayoutTraceFrame *frame) {
+
+    memset(frame, 0, sizeof(TGLLayoutTraceFrame));
+
+    frame->transitionProgress = -1.0;
+    frame->exposedItem = -1;
+    frame->movingItem = -1;
+}
+
+size_t TGLLayoutTraceEncodeFrame(const TGLLayoutTraceFrame *frame, TGLLayoutTraceFrame *previous, unsigned char *bytes) {
+
+    // Compare at encoded precision, so
+    // that changes don't accumulate
+    //
+    unsigned flags = 0;
+
+    if ((float)frame->contentOffset != (float)previous->contentOffset) flags |= TGLLayoutTraceContentOffset;
+
+    if ((float)frame->boundsWidth != (float)previous->boundsWidth || (float)frame->boundsHeight != (float)previous->boundsHeight ||
+        (float)frame->contentInsetTop != (float)previous->contentInsetTop || (float)frame->contentInsetBottom != (float)previous->contentInsetBottom) flags |= TGLLayoutTraceBounds;
+
+    if (frame->itemCount != previous->itemCount) flags |= TGLLayoutTraceItemCount;
+    if ((float)frame->transitionProgress != (float)previous->transitionProgress) flags |= TGLLayoutTraceProgress;
+    if (frame->exposedItem != previous->exposedItem) flags |= TGLLayoutTraceExposedItem;
+
+    if (frame->movingItem != previous->movingItem ||
+        (frame->movingItem >= 0 && ((float)frame->moveTargetX != (float)previous->moveTargetX || (float)frame->moveTargetY != (float)previous->moveTargetY))) flags |= TGLLayoutTraceMove;
+
+    if (flags == 0) return 0;
+
+    // Time since previous frame in
+    // microseconds, clamped to 32 bits
+    //
+    double interval = round((frame->time - previous->time) * 1e6);
+
+    if (interval < 0.0) interval = 0.0;
+    if (interval > UINT32_MAX) interval = UINT32_MAX;
+
+    unsigned char *start = bytes;
+
+    *bytes++ = (unsigned char)flags;
+
+    bytes = TGLLayoutTracePutUInt32(bytes, (uint32_t)interval);
+
+    if (flags & TGLLayoutTraceContentOffset) bytes = TGLLayoutTracePutFloat(bytes, (float)frame->contentOffset);
+
+    if (flags & TGLLayoutTraceBounds) {
+
+        bytes = TGLLayoutTracePutFloat(bytes, (float)frame->boundsWidth);
+        bytes = TGLLayoutTracePutFloat(bytes, (float)frame->boundsHeight);
+        bytes = TGLLayoutTracePutFloat(bytes, (float)frame->contentInsetTop);
+        bytes = TGLLayoutTracePutFloat(bytes, (float)frame->contentInsetBottom);
+    }
+
+    if (flags & TGLLayoutTraceItemCount) bytes = TGLLayoutTracePutInt32(bytes, frame->itemCount);
+    if (flags & TGLLayoutTraceProgress) bytes = TGLLayoutTracePutFloat(bytes, (float)frame->transitionProgress);
+    if (flags & TGLLayoutTraceExposedItem) bytes = TGLLayoutTracePutInt32(bytes, frame->exposedItem);
+
+    if (flags & TGLLayoutTraceMove) {
+
+        bytes = TGLLayoutTracePutInt32(bytes, frame->movingItem);
+        bytes = TGLLayoutTracePutFloat(bytes, (float)frame->moveTargetX);
+        bytes = TGLLayoutTracePutFloat(bytes, (float)frame->moveTargetY);
+    }
+
+    size_t length = bytes - start;
+
+    TGLLayoutTraceDecodeFrame(start, length, previous);
+
+    return length;
+}
+
+size_t TGLLayoutTraceDecodeFrame(const unsigned char *bytes, size_t length, TGLLayoutTraceFrame *frame) {
+
+    if (length < 5 || (bytes[0] & ~TGLLayoutTraceAllValues) != 0) return 0;
+
+    unsigned flags = bytes[0];
+    size_t frameLength = 5;
+
+    if (flags & TGLLayoutTraceContentOffset) frameLength += 4;
+    if (flags & TGLLayoutTraceBounds) frameLength += 16;
+    if (flags & TGLLayoutTraceItemCount) frameLength += 4;
+    if (flags & TGLLayoutTraceProgress) frameLength += 4;
+    if (flags & TGLLayoutTraceExposedItem) frameLength += 4;
+    if (flags & TGLLayoutTraceMove) frameLength += 12;
+
+    if (length < frameLength) return 0;
+
+    frame->time += TGLLayoutTraceGetUInt32(bytes + 1) * 1e-6;
+
+    bytes += 5;
+
+    if (flags & TGLLayoutTraceContentOffset) {
+
+        frame->contentOffset = TGLLayoutTraceGetFloat(bytes);
+        bytes += 4;
+    }
+
+    if (flags & TGLLayoutTraceBounds) {
+
+        frame->boundsWidth = TGLLayoutTraceGetFloat(bytes);
+        frame->boundsHeight = TGLLayoutTraceGetFloat(bytes + 4);
+        frame->contentInsetTop = TGLLayoutTraceGetFloat(bytes + 8);
+        frame->contentInsetBottom = TGLLayoutTraceGetFloat(bytes + 12);
+        bytes += 16;
+    }
+
+    if (flags & TGLLayoutTraceItemCount) {
+
+        frame->itemCount = TGLLayoutTraceGetInt32(bytes);
+        bytes += 4;
+    }
+
+    if (flags & TGLLayoutTraceProgress) {
+
+        frame->transitionProgress = TGLLayoutTraceGetFloat(bytes);
+        bytes += 4;
+    }
+
+    if (flags & TGLLayoutTraceExposedItem) {
+
+        frame->exposedItem = TGLLayoutTraceGetInt32(bytes);
+        bytes += 4;
+    }
+
+    if (flags & TGLLayoutTraceMove) {
+
+        frame->movingItem = TGLLayoutTraceGetInt32(bytes);
+        frame->moveTargetX = TGLLayoutTraceGetFloat(bytes + 4);
+        frame->moveTargetY = TGLLayoutTraceGetFloat(bytes + 8);
+    }
+
+    return frameLength;
+}
@@ -0,0 +1,134 @@
+//
+//  TGLLayoutTrace.h
+//  TGLStackedViewController
+//
+//  Created by Tim Gleue on 17.10.26.
+//  Copyright (c) 2026 Tim Gleue ( http://gleue-interactive.com )
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+#ifndef TGLLayoutTrace_h
+#define TGLLayoutTrace_h
+
+#include "TGLLayoutGeometry.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Platform-neutral binary encoding of layout input traces.
+ *
+ * A trace starts with a header holding the stacked and
+ * exposed layouts' configuration, followed by frames
+ * holding the collection view's state per display frame.
+ * Only values changed since the previous frame are
+ * encoded, so idle frames take no space at all. All
+ * values are little-endian, positions are 32-bit floats.
+ *
+ * Functions in this file do not depend on UIKit or Foundation.
+ */
+
+/** Version written to and expected in trace headers */
+#define TGLLayoutTraceVersion 1
+
+/** Size of an encoded header */
+#define TGLLayoutTraceHeaderSize 116
+
+/** Maximum size of an encoded frame */
+#define TGLLayoutTraceMaxFrameSize 49
+
+/** Layout configuration, fixed for a trace */
+typedef struct {
+
+    /* Stacked layout */
+    double marginTop;
+    double marginBottom;
+    double itemHeight;                  /* 0 for layout height */
+    double itemReveal;
+    double bounceFactor;
+    double occlusionThreshold;
+    bool fillHeight;
+    bool centerSingleItem;
+    bool alwaysBounce;
+
+    /* Exposed layout */
+    double exposedMarginTop;
+    double exposedMarginBottom;
+    double exposedItemHeight;           /* 0 for layout height */
+    double exposedTopOverlap;
+    double exposedBottomOverlap;
+    long exposedBottomOverlapCount;
+    TGLExposedPinning exposedPinning;
+    long exposedTopPinningCount;        /* -1 for all */
+    long exposedBottomPinningCount;     /* -1 for all */
+
+} TGLLayoutTraceHeader;
+
+/** Collection view state in a single frame */
+typedef struct {
+
+    double time;                        /* Seconds since start of recording */
+
+    double contentOffset;               /* Vertical content offset */
+    double boundsWidth;
+    double boundsHeight;
+    double contentInsetTop;
+    double contentInsetBottom;
+    long itemCount;
+
+    double transitionProgress;          /* Progress of interactive transition from exposed to stacked layout or -1 */
+    long exposedItem;                   /* Global index of exposed item or -1 */
+    long movingItem;                    /* Global index of item being moved or -1 */
+    double moveTargetX;                 /* Target position of item being moved */
+    double moveTargetY;
+
+} TGLLayoutTraceFrame;
+
+/** Initializes a frame without transition, exposed or moving item, used before encoding or decoding the first frame */
+void TGLLayoutTraceFrameInit(TGLLayoutTraceFrame *frame);
+
+/** Encodes `header` into `TGLLayoutTraceHeaderSize` bytes */
+void TGLLayoutTraceEncodeHeader(const TGLLayoutTraceHeader *header, unsigned char *bytes);
+
+/** Decodes a header from `length` bytes, returns `false` if they don't start with a supported header */
+bool TGLLayoutTraceDecodeHeader(const unsigned char *bytes, size_t length, TGLLayoutTraceHeader *header);
+
+/** Encodes changes of `frame` since `previous` into at most `TGLLayoutTraceMaxFrameSize` bytes
+ *
+ * Returns the number of bytes written or 0 if nothing
+ * changed at encoded precision. Otherwise `previous`
+ * is updated to the frame as decoded from `bytes`.
+ */
+size_t TGLLayoutTraceEncodeFrame(const TGLLayoutTraceFrame *frame, TGLLayoutTraceFrame *previous, unsigned char *bytes);
+
+/** Decodes a frame from `length` bytes, updating the previous frame in `frame`
+ *
+ * Returns the number of bytes read or 0 if `bytes`
+ * don't start with a complete frame.
+ */
+size_t TGLLayoutTraceDecodeFrame(const unsigned char *bytes, size_t length, TGLLayoutTraceFrame *frame);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TGLLayoutTrace_h */
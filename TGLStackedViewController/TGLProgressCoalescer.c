@@ -0,0 +1,98 @@
+//
+//  TGLProgressCoalescer.c
+//  TGLStackedViewController
+//
+//  Created by Tim Gleue on 17.10.26.
+//  Copyright (c) 2026 Tim Gleue ( http://gleue-interactive.com )
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+#include "TGLProgressCoalescer.h"
+
+#include <string.h>
+
+void TGLProgressCoalescerReset(TGLProgressCoalescer *coalescer, double progress) {
+
+    memset(coalescer, 0, sizeof(TGLProgressCoalescer));
+
+    coalescer->progress = progress;
+    coalescer->appliedProgress = progress;
+}
+
+void TGLProgressCoalescerAddInput(TGLProgressCoalescer *coalescer, double progress, double timestamp) {
+
+    if (coalescer->hasInput) {
+
+        double dt = timestamp - coalescer->timestamp;
+
+        // Inputs sharing a timestamp only update
+        // progress, since they carry no velocity
+        //
+        if (dt > 0.0) {
+
+            double velocity = (progress - coalescer->progress) / dt;
+            double alpha = dt / (dt + TGLProgressCoalescerVelocityTimeConstant);
+
+            coalescer->velocity += alpha * (velocity - coalescer->velocity);
+            coalescer->timestamp = timestamp;
+        }
+
+    } else {
+
+        coalescer->velocity = 0.0;
+        coalescer->timestamp = timestamp;
+        coalescer->hasInput = true;
+    }
+
+    coalescer->progress = progress;
+    coalescer->inputCount += 1;
+}
+
+double TGLProgressCoalescerPredictedProgress(const TGLProgressCoalescer *coalescer, double targetTimestamp, double predictionInterval) {
+
+    double progress = coalescer->progress;
+
+    if (coalescer->hasInput && predictionInterval > 0.0) {
+
+        double age = targetTimestamp - coalescer->timestamp;
+
+        if (age < 0.0) age = 0.0;
+
+        if (age <= TGLProgressCoalescerInputTimeout) progress += coalescer->velocity * (age + predictionInterval);
+    }
+
+    if (progress < 0.0) progress = 0.0;
+    if (progress > 1.0) progress = 1.0;
+
+    return progress;
+}
+
+bool TGLProgressCoalescerTick(TGLProgressCoalescer *coalescer, double targetTimestamp, double predictionInterval, double *progress) {
+
+    double predicted = TGLProgressCoalescerPredictedProgress(coalescer, targetTimestamp, predictionInterval);
+
+    if (predicted == coalescer->appliedProgress) return false;
+
+    coalescer->appliedProgress = predicted;
+    coalescer->tickCount += 1;
+
+    if (progress) *progress = predicted;
+
+    return true;
+}
@@ -0,0 +1,93 @@
+//
+//  TGLProgressCoalescer.h
+//  TGLStackedViewController
+//
+//  Created by Tim Gleue on 17.10.26.
+//  Copyright (c) 2026 Tim Gleue ( http://gleue-interactive.com )
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+#ifndef TGLProgressCoalescer_h
+#define TGLProgressCoalescer_h
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Platform-neutral coalescing of interactive transition progress.
+ *
+ * Gesture input may arrive several times per displayed frame.
+ * Input is collected by `TGLProgressCoalescerAddInput` and
+ * applied at most once per frame by `TGLProgressCoalescerTick`,
+ * optionally extrapolating the progress by its velocity.
+ *
+ * Functions in this file do not depend on UIKit or Foundation.
+ * Timestamps are passed in by the caller in seconds.
+ */
+
+/** Time constant in seconds for smoothing the progress velocity */
+#define TGLProgressCoalescerVelocityTimeConstant 0.025
+
+/** Age in seconds after which the latest input is considered stationary and no longer extrapolated */
+#define TGLProgressCoalescerInputTimeout 0.05
+
+typedef struct {
+
+    double progress;            /* Latest input progress */
+    double timestamp;           /* Time of latest input */
+    double velocity;            /* Smoothed progress change per second */
+    bool hasInput;              /* Whether there was any input since reset */
+
+    double appliedProgress;     /* Progress returned by the latest tick */
+
+    unsigned long inputCount;   /* Number of inputs since reset */
+    unsigned long tickCount;    /* Number of ticks returning a progress since reset */
+
+} TGLProgressCoalescer;
+
+/** Resets the coalescer to `progress`, which is considered to be applied already */
+void TGLProgressCoalescerReset(TGLProgressCoalescer *coalescer, double progress);
+
+/** Collects input `progress` received at `timestamp` */
+void TGLProgressCoalescerAddInput(TGLProgressCoalescer *coalescer, double progress, double timestamp);
+
+/** Returns the progress predicted for `targetTimestamp` plus `predictionInterval` seconds.
+ *
+ * The prediction extrapolates the latest input by its velocity
+ * unless `predictionInterval` is less or equal 0.0 or the input
+ * is older than `TGLProgressCoalescerInputTimeout`. The result is
+ * clamped to 0...1.
+ */
+double TGLProgressCoalescerPredictedProgress(const TGLProgressCoalescer *coalescer, double targetTimestamp, double predictionInterval);
+
+/** Called once per frame to be displayed at `targetTimestamp`.
+ *
+ * Returns `true` and stores the predicted progress in `progress`
+ * if it differs from the one returned by the previous tick, i.e.
+ * if the progress has to be applied, `false` otherwise.
+ */
+bool TGLProgressCoalescerTick(TGLProgressCoalescer *coalescer, double targetTimestamp, double predictionInterval, double *progress);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TGLProgressCoalescer_h */
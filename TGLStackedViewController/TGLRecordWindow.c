@@ -0,0 +1,305 @@
+//
+//  TGLRecordWindow.c
+//  TGLStackedViewController
+//
+//  Created by Tim Gleue on 17.10.26.
+//  Copyright (c) 2026 Tim Gleue ( http://gleue-interactive.com )
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+// For madvise() in strict C99 mode
+//
+#define _DEFAULT_SOURCE
+
+#include "TGLRecordWindow.h"
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// MARK: - Record window
+
+bool TGLRecordWindowInit(TGLRecordWindow *window, long recordCount, size_t recordSize, long pageRecordCount, long pageCapacity, TGLRecordWindowReadFunction read, void *context) {
+
+    memset(window, 0, sizeof(TGLRecordWindow));
+
+    if (recordCount < 0 || recordSize == 0 || pageRecordCount <= 0 || pageCapacity <= 0 || read == NULL) return false;
+
+    window->recordCount = recordCount;
+    window->recordSize = recordSize;
+    window->pageRecordCount = pageRecordCount;
+    window->pageCapacity = pageCapacity;
+    window->read = read;
+    window->context = context;
+
+    window->slotPages = malloc(pageCapacity * sizeof(long));
+    window->buffer = malloc(pageCapacity * pageRecordCount * recordSize);
+
+    if (window->slotPages == NULL || window->buffer == NULL) {
+
+        TGLRecordWindowFree(window);
+
+        return false;
+    }
+
+    TGLRecordWindowRemoveAll(window);
+
+    return true;
+}
+
+void TGLRecordWindowFree(TGLRecordWindow *window) {
+
+    free(window->slotPages);
+    free(window->buffer);
+
+    window->slotPages = NULL;
+    window->buffer = NULL;
+    window->pageCapacity = 0;
+}
+
+void TGLRecordWindowRemoveAll(TGLRecordWindow *window) {
+
+    for (long slot = 0; slot < window->pageCapacity; slot++) window->slotPages[slot] = -1;
+}
+
+static long TGLRecordWindowPageDistance(const TGLRecordWindow *window, long page) {
+
+    // Distance in pages from the pages
+    // covering the visible range
+    //
+    long firstPage = window->visibleFirst / window->pageRecordCount;
+    long lastPage = (window->visibleEnd > window->visibleFirst) ? (window->visibleEnd - 1) / window->pageRecordCount : firstPage;
+
+    if (page < firstPage) return firstPage - page;
+    if (page > lastPage) return page - lastPage;
+
+    return 0;
+}
+
+static long TGLRecordWindowFindSlot(const TGLRecordWindow *window, long page) {
+
+    for (long slot = 0; slot < window->pageCapacity; slot++) {
+
+        if (window->slotPages[slot] == page) return slot;
+    }
+
+    return -1;
+}
+
+static long TGLRecordWindowLoadPage(TGLRecordWindow *window, long page, long maxDistance) {
+
+    long slot = TGLRecordWindowFindSlot(window, page);
+
+    if (slot >= 0) return slot;
+
+    // Use a free slot or else the one
+    // farthest from the visible range,
+    // but only if farther than `maxDistance`
+    //
+    long farthestDistance = -1;
+
+    for (long s = 0; s < window->pageCapacity; s++) {
+
+        if (window->slotPages[s] < 0) {
+
+            slot = s;
+            break;
+        }
+
+        long distance = TGLRecordWindowPageDistance(window, window->slotPages[s]);
+
+        if (distance > farthestDistance) {
+
+            farthestDistance = distance;
+            slot = s;
+        }
+    }
+
+    if (window->slotPages[slot] >= 0) {
+
+        if (farthestDistance <= maxDistance) return -1;
+
+        window->evictionCount += 1;
+    }
+
+    long first = page * window->pageRecordCount;
+    long count = window->recordCount - first;
+
+    if (count > window->pageRecordCount) count = window->pageRecordCount;
+
+    window->slotPages[slot] = -1;
+
+    if (!window->read(window->context, first, count, window->buffer + slot * window->pageRecordCount * window->recordSize)) return -1;
+
+    window->slotPages[slot] = page;
+    window->loadCount += 1;
+
+    return slot;
+}
+
+const void *TGLRecordWindowRecord(TGLRecordWindow *window, long record) {
+
+    if (window->pageCapacity <= 0 || record < 0 || record >= window->recordCount) return NULL;
+
+    long page = record / window->pageRecordCount;
+
+    // Records accessed on demand always
+    // get loaded, evicting whatever page
+    // is farthest away
+    //
+    long slot = TGLRecordWindowLoadPage(window, page, -1);
+
+    if (slot < 0) return NULL;
+
+    return window->buffer + (slot * window->pageRecordCount + record - page * window->pageRecordCount) * window->recordSize;
+}
+
+void TGLRecordWindowSetVisibleRange(TGLRecordWindow *window, long first, long end, long prefetchFirst, long prefetchEnd) {
+
+    if (window->pageCapacity <= 0) return;
+
+    if (first < 0) first = 0;
+    if (end > window->recordCount) end = window->recordCount;
+    if (end < first) end = first;
+
+    window->visibleFirst = first;
+    window->visibleEnd = end;
+
+    if (prefetchFirst > first) prefetchFirst = first;
+    if (prefetchEnd < end) prefetchEnd = end;
+    if (prefetchFirst < 0) prefetchFirst = 0;
+    if (prefetchEnd > window->recordCount) prefetchEnd = window->recordCount;
+    if (prefetchEnd <= prefetchFirst) return;
+
+    long firstPage = prefetchFirst / window->pageRecordCount;
+    long lastPage = (prefetchEnd - 1) / window->pageRecordCount;
+    long visibleFirstPage = first / window->pageRecordCount;
+    long visibleLastPage = (end > first) ? (end - 1) / window->pageRecordCount : visibleFirstPage;
+
+    for (long page = visibleFirstPage; page <= visibleLastPage; page++) {
+
+        TGLRecordWindowLoadPage(window, page, 0);
+    }
+
+    // Alternate outwards from the visible
+    // pages, so nearer pages are read first
+    //
+    for (long distance = 1; visibleFirstPage - distance >= firstPage || visibleLastPage + distance <= lastPage; distance++) {
+
+        if (visibleFirstPage - distance >= firstPage) TGLRecordWindowLoadPage(window, visibleFirstPage - distance, distance);
+        if (visibleLastPage + distance <= lastPage) TGLRecordWindowLoadPage(window, visibleLastPage + distance, distance);
+    }
+}
+
+long TGLRecordWindowResidentPageCount(const TGLRecordWindow *window) {
+
+    long count = 0;
+
+    for (long slot = 0; slot < window->pageCapacity; slot++) {
+
+        if (window->slotPages[slot] >= 0) count++;
+    }
+
+    return count;
+}
+
+size_t TGLRecordWindowResidentBytes(const TGLRecordWindow *window) {
+
+    return window->pageCapacity * window->pageRecordCount * window->recordSize + window->pageCapacity * sizeof(long);
+}
+
+// MARK: - Mapped files
+
+bool TGLRecordMappingOpen(TGLRecordMapping *mapping, const char *path, size_t offset, size_t recordSize) {
+
+    memset(mapping, 0, sizeof(TGLRecordMapping));
+
+    if (recordSize == 0) return false;
+
+    int fd = open(path, O_RDONLY);
+
+    if (fd < 0) return false;
+
+    struct stat info;
+
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < offset) {
+
+        close(fd);
+
+        return false;
+    }
+
+    mapping->length = (size_t)info.st_size;
+    mapping->offset = offset;
+    mapping->recordSize = recordSize;
+    mapping->recordCount = (long)((mapping->length - offset) / recordSize);
+
+    if (mapping->length > 0) {
+
+        void *base = mmap(NULL, mapping->length, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (base == MAP_FAILED) {
+
+            close(fd);
+            memset(mapping, 0, sizeof(TGLRecordMapping));
+
+            return false;
+        }
+
+        mapping->base = base;
+    }
+
+    // Mapping stays valid after closing
+    //
+    close(fd);
+
+    return true;
+}
+
+void TGLRecordMappingClose(TGLRecordMapping *mapping) {
+
+    if (mapping->base) munmap(mapping->base, mapping->length);
+
+    memset(mapping, 0, sizeof(TGLRecordMapping));
+}
+
+bool TGLRecordMappingRead(void *context, long first, long count, void *buffer) {
+
+    TGLRecordMapping *mapping = context;
+
+    if (first < 0 || count < 0 || first + count > mapping->recordCount) return false;
+
+    size_t start = mapping->offset + first * mapping->recordSize;
+    size_t length = count * mapping->recordSize;
+
+    memcpy(buffer, (unsigned char *)mapping->base + start, length);
+
+    // Release mapped pages again, since
+    // the window keeps its own copy
+    //
+    size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+    size_t alignedStart = start - start % pageSize;
+
+    madvise((unsigned char *)mapping->base + alignedStart, start + length - alignedStart, MADV_DONTNEED);
+
+    return true;
+}
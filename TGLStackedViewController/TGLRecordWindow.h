@@ -0,0 +1,136 @@
+//
+//  TGLRecordWindow.h
+//  TGLStackedViewController
+//
+//  Created by Tim Gleue on 17.10.26.
+//  Copyright (c) 2026 Tim Gleue ( http://gleue-interactive.com )
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+#ifndef TGLRecordWindow_h
+#define TGLRecordWindow_h
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Platform-neutral window of fixed-size records.
+ *
+ * Records are read in pages of consecutive records from
+ * a paging callback, e.g. one backed by a memory-mapped
+ * file. At most a fixed number of pages are resident.
+ * When a page has to be loaded and all pages are in use,
+ * the one farthest from the visible record range is
+ * evicted. Resident memory therefore depends on page size
+ * and capacity only, not on the number of records.
+ *
+ * Functions in this file do not depend on UIKit or Foundation.
+ */
+
+/** Reads `count` records starting at `first` into `buffer`, returns `false` on error */
+typedef bool (*TGLRecordWindowReadFunction)(void *context, long first, long count, void *buffer);
+
+typedef struct {
+
+    long recordCount;
+    size_t recordSize;
+    long pageRecordCount;       /* Records per page */
+    long pageCapacity;          /* Maximum number of resident pages */
+
+    TGLRecordWindowReadFunction read;
+    void *context;
+
+    long *slotPages;            /* Page resident in each slot or -1 */
+    unsigned char *buffer;      /* `pageCapacity` pages of records */
+
+    long visibleFirst;          /* Visible records `[visibleFirst, visibleEnd)` */
+    long visibleEnd;
+
+    unsigned long loadCount;    /* Number of pages read */
+    unsigned long evictionCount;/* Number of resident pages replaced */
+
+} TGLRecordWindow;
+
+/** Prepares an empty window, returns `false` if memory could not be allocated */
+bool TGLRecordWindowInit(TGLRecordWindow *window, long recordCount, size_t recordSize, long pageRecordCount, long pageCapacity, TGLRecordWindowReadFunction read, void *context);
+
+/** Frees memory used by `window` */
+void TGLRecordWindowFree(TGLRecordWindow *window);
+
+/** Evicts all resident pages, e.g. after records changed */
+void TGLRecordWindowRemoveAll(TGLRecordWindow *window);
+
+/** Returns a pointer to `record`, reading its page if not resident, or `NULL` on error
+ *
+ * The pointer is valid until the next call loading a page.
+ */
+const void *TGLRecordWindowRecord(TGLRecordWindow *window, long record);
+
+/** Sets the visible record range and reads pages of records in `[prefetchFirst, prefetchEnd)` ahead
+ *
+ * Pages closest to the visible range are read first.
+ * Prefetching never evicts a page closer to the
+ * visible range than the one being read.
+ */
+void TGLRecordWindowSetVisibleRange(TGLRecordWindow *window, long first, long end, long prefetchFirst, long prefetchEnd);
+
+/** Returns the number of resident pages */
+long TGLRecordWindowResidentPageCount(const TGLRecordWindow *window);
+
+/** Returns the number of bytes allocated for records, which is independent of `recordCount` */
+size_t TGLRecordWindowResidentBytes(const TGLRecordWindow *window);
+
+// MARK: - Mapped files
+
+/** Read-only memory mapping of a file of fixed-size records */
+typedef struct {
+
+    void *base;
+    size_t length;
+    size_t offset;              /* Bytes preceding the first record, e.g. a header */
+    size_t recordSize;
+    long recordCount;
+
+} TGLRecordMapping;
+
+/** Maps the file at `path`, returns `false` on error
+ *
+ * Records start at byte `offset`. A trailing partial
+ * record is ignored.
+ */
+bool TGLRecordMappingOpen(TGLRecordMapping *mapping, const char *path, size_t offset, size_t recordSize);
+
+/** Unmaps the file */
+void TGLRecordMappingClose(TGLRecordMapping *mapping);
+
+/** Paging callback copying records from a `TGLRecordMapping` passed as `context`
+ *
+ * Mapped pages read are released again right away,
+ * so the mapping's resident memory stays bounded, too.
+ */
+bool TGLRecordMappingRead(void *context, long first, long count, void *buffer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TGLRecordWindow_h */
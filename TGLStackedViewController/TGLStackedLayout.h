@@ -25,6 +25,36 @@
 
 #import <UIKit/UIKit.h>
 
+#import "TGLItemSizeCache.h"
+#import "TGLLayoutAttributesPool.h"
+#import "TGLLayoutMetrics.h"
+
+@class TGLStackedLayout;
+
+/** Methods of the collection view's delegate
+ *  to customize a `TGLStackedLayout`.
+ */
+@protocol TGLStackedLayoutDelegate <UICollectionViewDelegate>
+
+@optional
+
+/** Asks the delegate for the amount to show of the item at `indexPath` when stacked.
+ *
+ * If implemented, the value returned overrides `-topReveal`
+ * for the respective item, unless the layout is filling
+ * the entire height. Values are cached by the layout and
+ * requested again on reload, for items invalidated
+ * explicitly, e.g. via `-invalidateLayoutWithContext:`,
+ * and when the collection view's size changes. Values for
+ * the last few sizes are kept, so rotating back and forth
+ * requests them only once per size.
+ *
+ * @see -[TGLStackedLayout invalidateLayoutCache]
+ */
+- (CGFloat)collectionView:(UICollectionView *)collectionView layout:(TGLStackedLayout *)layout topRevealForItemAtIndexPath:(NSIndexPath *)indexPath;
+
+@end
+
 @interface TGLStackedLayout : UICollectionViewLayout
 
 /** Margins between collection view and items. Default is `UIEdgeInsetsMake(20.0, 0.0, 0.0, 0.0)` */
@@ -39,7 +69,10 @@
  */
 @property (nonatomic, assign) IBInspectable CGSize itemSize;
 
-/** Amount to show of each stacked item. Default is 120.0 */
+/** Amount to show of each stacked item. Default is 120.0
+ *
+ * @see -[TGLStackedLayoutDelegate collectionView:layout:topRevealForItemAtIndexPath:]
+ */
 @property (nonatomic, assign) IBInspectable CGFloat topReveal;
 
 /** Amount of compression/expansing when scrolling bounces. Default is 0.2 */
@@ -60,10 +93,105 @@
 /** Set to YES to enable bouncing even when items do not fill entire height. Default is `NO` */
 @property (nonatomic, assign, getter = isAlwaysBouncing) IBInspectable BOOL alwaysBounce;
 
+/** Minimum height in points an item has to show to not be culled as covered by the item above it, or 0 to keep all unpinned items. Default is 0 */
+@property (nonatomic, assign) IBInspectable CGFloat occlusionThreshold;
+
 /** Use -contentOffset instead of collection view's actual content offset for next layout */
 @property (nonatomic, assign) BOOL overwriteContentOffset;
 
 /** Content offset value to replace actual value when -overwriteContentOffset is `YES` */
 @property (nonatomic, assign) CGPoint contentOffset;
 
+/** Metrics object to record layout performance to or `nil` to record nothing. Default is `nil` */
+@property (nonatomic, strong) TGLLayoutMetrics *metrics;
+
+/** Pool to recycle layout attributes objects to. Default is a private pool, setting `nil` restores one
+ *
+ * Layouts sharing a pool return attributes not used
+ * during their last pass to it, so that spare objects
+ * of all layouts are bounded by the pool's capacity.
+ */
+@property (nonatomic, strong) TGLLayoutAttributesPool *attributesPool;
+
+/** Sizes measured by exposed layouts sharing this cache. Default is an empty cache
+ *
+ * Stacked items keep -itemSize regardless. The layout
+ * only keeps the cache in sync with batch updates, so
+ * sizes remain valid while items are collapsed.
+ */
+@property (nonatomic, strong) TGLItemSizeCache *measuredSizeCache;
+
+/** Returns index paths of items becoming visible within `duration` seconds when scrolling at `velocity`.
+ *
+ * Since items' positions follow from the content offset,
+ * the result is computed from the last layout pass alone,
+ * without querying attributes. Items already visible are
+ * not returned.
+ *
+ * @param velocity Vertical scrolling velocity of content offset in points per second.
+ * @param duration Time ahead to predict in seconds.
+ */
+- (NSArray<NSIndexPath *> *)indexPathsForItemsRevealedWithVelocity:(CGFloat)velocity duration:(NSTimeInterval)duration;
+
+/** Returns the range of items returned by `-indexPathsForItemsRevealedWithVelocity:duration:` as global item indices.
+ *
+ * Items are addressed by their position in the
+ * concatenation of all sections. Returns a range
+ * with location `NSNotFound` if there are none.
+ */
+- (NSRange)itemRangeRevealedWithVelocity:(CGFloat)velocity duration:(NSTimeInterval)duration;
+
+/** Returns the range of items visible in the collection view's bounds as of the last layout pass as global item indices.
+ *
+ * Hidden items are included if they lie between visible
+ * ones. Returns a range with location `NSNotFound` if
+ * there are none.
+ */
+- (NSRange)visibleItemRange;
+
+/** Discards reveal heights kept for previously seen collection view sizes and requests them again on next layout pass.
+ *
+ * The cache is discarded automatically whenever the data
+ * source changes. Call this method if reveal heights
+ * returned by the collection view's delegate changed
+ * for another reason.
+ */
+- (void)invalidateLayoutCache;
+
+/** Marks the item at `indexPath` as being reordered by drag and drop.
+ *
+ * If -movingItemOnTop is `YES` the item floats above all
+ * other items until `-endReordering` is called. Reordering
+ * by interactive movement is tracked automatically.
+ */
+- (void)beginReorderingItemAtIndexPath:(NSIndexPath *)indexPath;
+
+/** Ends reordering started by `-beginReorderingItemAtIndexPath:`, restoring the item's z ordering */
+- (void)endReordering;
+
+@end
+
+/** Invalidation context used by `TGLStackedLayout` when bounds change.
+ *
+ * For plain scrolling, i.e. when the bounds' size does not change,
+ * only items entering or leaving the top overlapping area change
+ * their frames. The layout keeps the attributes of all other items.
+ */
+@interface TGLStackedLayoutInvalidationContext : UICollectionViewLayoutInvalidationContext
+
+/** Content offset before bounds change */
+@property (nonatomic, assign) CGPoint previousContentOffset;
+
+/** Content offset after bounds change */
+@property (nonatomic, assign) CGPoint contentOffset;
+
+/** Set to YES if bounds change is due to scrolling only */
+@property (nonatomic, assign) BOOL invalidateContentOffsetOnly;
+
+/** Set to YES if bounds' size changed */
+@property (nonatomic, assign) BOOL invalidateBoundsSize;
+
+/** Set to YES if only items shifted by reordering are invalidated */
+@property (nonatomic, assign) BOOL invalidateReorderedItemsOnly;
+
 @end
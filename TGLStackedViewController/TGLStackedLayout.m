@@ -24,16 +24,118 @@
 //  THE SOFTWARE.
 
 #import "TGLStackedLayout.h"
+#import "TGLLayoutAttributesStore.h"
+#import "TGLLayoutGeometry.h"
 
-@interface TGLStackedLayout ()
+@interface TGLStackedLayout () {
 
-@property (nonatomic, strong) NSDictionary *layoutAttributes;
+    // Geometry of current layout pass computed in
+    // -prepareLayout. Each item's origin follows in
+    // closed form from it, so attributes are created
+    // on demand for visible items only
+    //
+    TGLStackedGeometry _geometry;
+
+    // Input of current layout pass, kept
+    // to predict items revealed when
+    // scrolling
+    //
+    TGLStackedParameters _parameters;
+
+    // Anchor item while compressing when
+    // bouncing at bottom, kept between
+    // passes
+    //
+    long _firstCompressingItem;
+
+    // Sections are stacked one after another,
+    // items are addressed by global index
+    //
+    TGLSectionTable _sections;
+    TGLSectionTable _previousSections;
+
+    // Per-item reveal heights if provided
+    // by collection view's delegate
+    //
+    TGLRevealTable _revealTable;
+
+    // Reveal tables computed for previously
+    // seen sizes since data last changed
+    //
+    TGLLayoutCache _layoutCache;
+    unsigned long _dataVersion;
+
+    // Reordering model: item picked up, its
+    // current position, and positions whose
+    // occupants changed since last pass
+    //
+    NSInteger _reorderingSourceItem;
+    NSInteger _reorderingTargetItem;
+    NSRange _reorderedItemRange;
+    BOOL _floatingReorderedItem;
+
+    // Buffers used to compute origins and
+    // flags of visible items in one go
+    //
+    double *_originBuffer;
+    TGLLayoutItemFlags *_flagsBuffer;
+    NSInteger _bufferCapacity;
+
+    // Allocations of attributes store
+    // already reported to -metrics
+    //
+    NSUInteger _recordedAllocationCount;
+}
+
+@property (nonatomic, strong) TGLLayoutAttributesStore *attributesStore;
 
 // Set to YES when layout is currently arranging
 // items so that they evenly fill entire height
 //
 @property (nonatomic, assign) BOOL filling;
 
+// Frame of items before being moved vertically
+//
+@property (nonatomic, assign) CGRect itemFrame;
+
+// Set to NO when all invalidations since last
+// layout pass were plain scrolls, allowing to
+// keep attributes of items unaffected by scrolling
+//
+@property (nonatomic, assign) BOOL invalidatingAllItems;
+
+// Set to YES when reveal heights have to be
+// requested from collection view's delegate
+//
+@property (nonatomic, assign) BOOL invalidatingRevealTable;
+@property (nonatomic, assign) BOOL usingRevealTable;
+
+// Set to YES when data source counts changed
+// due to batch updates. Attributes and reveal
+// heights are then updated incrementally in
+// -prepareForCollectionViewUpdates:
+//
+@property (nonatomic, assign) BOOL invalidatingDataSourceCounts;
+@property (nonatomic, assign) BOOL deferringUpdates;
+
+// Items inserted and attributes of items deleted
+// during current batch update
+//
+@property (nonatomic, strong) NSMutableSet *insertedIndexPaths;
+@property (nonatomic, strong) NSMutableDictionary *disappearingAttributes;
+
+@end
+
+// Runs reveal table chunks of large stacks
+// on all cores, waiting for them to finish
+//
+static void TGLStackedLayoutConcurrentApply(size_t iterations, void *context, void (*work)(void *context, size_t iteration)) {
+
+    dispatch_apply_f(iterations, dispatch_get_global_queue(QOS_CLASS_USER_INTERACTIVE, 0), context, work);
+}
+
+@implementation TGLStackedLayoutInvalidationContext
+
 @end
 
 @implementation TGLStackedLayout
@@ -63,10 +165,58 @@
     self.bounceFactor = 0.2;
     self.movingItemScaleFactor = 0.95;
     self.movingItemOnTop = YES;
+
+    self.attributesStore = [[TGLLayoutAttributesStore alloc] init];
+    self.measuredSizeCache = [[TGLItemSizeCache alloc] init];
+    self.invalidatingAllItems = YES;
+    self.invalidatingRevealTable = YES;
+
+    _firstCompressingItem = -1;
+    _reorderingSourceItem = NSNotFound;
+    _reorderingTargetItem = NSNotFound;
+    _reorderedItemRange = NSMakeRange(NSNotFound, 0);
+
+    TGLSectionTableInit(&_sections);
+    TGLSectionTableInit(&_previousSections);
+    TGLRevealTableInit(&_revealTable);
+    TGLLayoutCacheInit(&_layoutCache);
+
+    __weak typeof(self) weakSelf = self;
+
+    self.attributesStore.indexPathForItem = ^NSIndexPath *(NSInteger item) {
+        
+        return [weakSelf indexPathForItem:item];
+    };
+}
+
+- (void)dealloc {
+    
+    TGLSectionTableFree(&_sections);
+    TGLSectionTableFree(&_previousSections);
+    TGLRevealTableFree(&_revealTable);
+    TGLLayoutCacheFree(&_layoutCache);
+
+    free(_originBuffer);
+    free(_flagsBuffer);
 }
 
 #pragma mark - Accessors
 
+- (TGLLayoutAttributesPool *)attributesPool {
+
+    return self.attributesStore.pool;
+}
+
+- (void)setAttributesPool:(TGLLayoutAttributesPool *)attributesPool {
+
+    // Keep attributes of items used during the
+    // last pass only when sharing a pool, and
+    // return all others to it
+    //
+    self.attributesStore.pool = attributesPool ?: [[TGLLayoutAttributesPool alloc] init];
+    self.attributesStore.capacity = attributesPool ? 0 : self.attributesStore.pool.capacity;
+}
+
 - (void)setLayoutMargin:(UIEdgeInsets)margins {
 
     if (!UIEdgeInsetsEqualToEdgeInsets(margins, self.layoutMargin)) {
@@ -107,6 +257,16 @@
     }
 }
 
+- (void)setOcclusionThreshold:(CGFloat)occlusionThreshold {
+
+    if (occlusionThreshold != self.occlusionThreshold) {
+
+        _occlusionThreshold = MAX(occlusionThreshold, 0.0);
+        
+        [self invalidateLayout];
+    }
+}
+
 - (void)setFillHeight:(BOOL)fillHeight {
 
     if (fillHeight != self.isFillingHeight) {
@@ -138,14 +298,106 @@
     return self.overwriteContentOffset ? self.contentOffset : proposedContentOffset;
 }
 
++ (Class)invalidationContextClass {
+    
+    return TGLStackedLayoutInvalidationContext.class;
+}
+
 - (BOOL)shouldInvalidateLayoutForBoundsChange:(CGRect)newBounds {
     
     return YES;
 }
 
+- (UICollectionViewLayoutInvalidationContext *)invalidationContextForBoundsChange:(CGRect)newBounds {
+    
+    TGLStackedLayoutInvalidationContext *context = (TGLStackedLayoutInvalidationContext *)[super invalidationContextForBoundsChange:newBounds];
+    CGRect bounds = self.collectionView.bounds;
+    
+    context.previousContentOffset = bounds.origin;
+    context.contentOffset = newBounds.origin;
+    context.invalidateContentOffsetOnly = CGSizeEqualToSize(bounds.size, newBounds.size);
+    context.invalidateBoundsSize = !context.invalidateContentOffsetOnly;
+    
+    if (context.invalidateContentOffsetOnly && !self.overwriteContentOffset && _geometry.adjustment == TGLStackedAdjustmentNone) {
+        
+        // When scrolling only items entering or
+        // leaving the top overlapping area move,
+        // i.e. the two top visible items while
+        // pinned and those changing pinned state
+        //
+        CGFloat pinningOffset = _geometry.pinningOffset + newBounds.origin.y - bounds.origin.y;
+        NSInteger pinnedItemCount = TGLStackedGeometryPinnedItemCount(&_geometry, pinningOffset);
+        NSInteger firstItem = MAX(MIN(pinnedItemCount, _geometry.pinnedItemCount) - 2, 0);
+        NSInteger lastItem = MAX(pinnedItemCount, _geometry.pinnedItemCount);
+        NSMutableArray *indexPaths = [NSMutableArray arrayWithCapacity:lastItem - firstItem];
+        
+        for (NSInteger item = firstItem; item < lastItem; item++) {
+            
+            [indexPaths addObject:[self indexPathForItem:item]];
+        }
+        
+        if (indexPaths.count > 0) [context invalidateItemsAtIndexPaths:indexPaths];
+    }
+    
+    return context;
+}
+
+- (void)invalidateLayoutWithContext:(UICollectionViewLayoutInvalidationContext *)context {
+    
+    BOOL scrolling = [context isKindOfClass:TGLStackedLayoutInvalidationContext.class] && ((TGLStackedLayoutInvalidationContext *)context).invalidateContentOffsetOnly;
+    BOOL resizing = [context isKindOfClass:TGLStackedLayoutInvalidationContext.class] && ((TGLStackedLayoutInvalidationContext *)context).invalidateBoundsSize;
+    BOOL reordering = [context isKindOfClass:TGLStackedLayoutInvalidationContext.class] && ((TGLStackedLayoutInvalidationContext *)context).invalidateReorderedItemsOnly;
+    
+    if (context.invalidateDataSourceCounts) {
+        
+        // Tables computed for other
+        // sizes are no longer valid
+        //
+        [self invalidateLayoutCache];
+    }
+    
+    if (context.invalidateEverything || context.invalidateDataSourceCounts || !(scrolling || reordering)) {
+        
+        self.invalidatingAllItems = YES;
+    }
+    
+    if (context.invalidateDataSourceCounts && !context.invalidateEverything) {
+        
+        self.invalidatingDataSourceCounts = YES;
+
+    } else if (context.invalidateEverything || (resizing && self.usingRevealTable)) {
+        
+        // Reveal heights may depend on size,
+        // but are restored from cache when
+        // returning to a previous size
+        //
+        self.invalidatingRevealTable = YES;
+
+    } else if (!(scrolling || reordering) && self.usingRevealTable && !self.invalidatingRevealTable) {
+        
+        // Update reveal heights of explicitly
+        // invalidated items only
+        //
+        if (context.invalidatedItemIndexPaths.count > 0) [self invalidateLayoutCache];
+
+        for (NSIndexPath *indexPath in context.invalidatedItemIndexPaths) {
+            
+            NSInteger item = [self itemForIndexPath:indexPath];
+
+            if (item != NSNotFound && item < _revealTable.count) {
+                
+                TGLRevealTableSetValue(&_revealTable, item, [self topRevealForItemAtIndexPath:indexPath]);
+            }
+        }
+    }
+    
+    [super invalidateLayoutWithContext:context];
+}
+
 - (CGSize)collectionViewContentSize {
     
-    CGSize contentSize = CGSizeMake(CGRectGetWidth(self.collectionView.bounds), self.layoutMargin.top + self.topReveal * [self.collectionView numberOfItemsInSection:0] + self.layoutMargin.bottom);
+    CGFloat stackHeight = self.hasValidRevealTable ? TGLRevealTableTotal(&_revealTable) : self.topReveal * TGLSectionTableItemCount(&_sections);
+    CGSize contentSize = CGSizeMake(CGRectGetWidth(self.collectionView.bounds), self.layoutMargin.top + stackHeight + self.layoutMargin.bottom);
     
     if (contentSize.height < CGRectGetHeight(self.collectionView.bounds)) {
 
@@ -168,21 +420,105 @@
 
 - (void)prepareLayout {
 
+    TGLLayoutMetrics *metrics = self.metrics;
+    CFTimeInterval startTime = metrics ? CACurrentMediaTime() : 0.0;
+
+    // Allocations since the last report, e.g. by
+    // item queries, belong to the previous pass
+    //
+    if (metrics) [metrics beginPassWithAllocationCount:[self unrecordedAllocationCount]];
+
+    // Batch updates not finished properly
+    // leave attributes in an unknown state
+    //
+    [self finishDeferredUpdates];
+
+    BOOL updating = self.invalidatingDataSourceCounts;
+
+    self.invalidatingDataSourceCounts = NO;
+
+    if (self.invalidatingAllItems && [self updateSectionTable] && !updating) {
+        
+        // Index paths of stored attributes
+        // are no longer valid
+        //
+        [self.attributesStore removeAllAttributes];
+    }
+
+    if (self.invalidatingRevealTable) {
+        
+        [self updateRevealTable];
+
+        self.invalidatingRevealTable = NO;
+    }
+
+    TGLStackedAdjustment previousAdjustment = _geometry.adjustment;
+    NSInteger previousPinnedItemCount = _geometry.pinnedItemCount;
+    NSInteger itemCount = TGLSectionTableItemCount(&_sections);
+    BOOL scrolling = !self.invalidatingAllItems && itemCount == _geometry.itemCount;
+
+    [self prepareGeometry];
+
+    if (updating) {
+        
+        // Stored attributes are moved to their new
+        // items as soon as updates are known
+        //
+        self.deferringUpdates = YES;
+
+    } else {
+
+        [self.attributesStore prepareForItemCount:itemCount];
+    }
+
+    if (scrolling && previousAdjustment == TGLStackedAdjustmentNone && _geometry.adjustment == TGLStackedAdjustmentNone) {
+        
+        // Items unpinned before and after scrolling
+        // keep their frames, so there's no need to
+        // recompute their attributes
+        //
+        // When reordering only positions whose
+        // occupants changed are recomputed
+        //
+        NSInteger firstItem = MAX(previousPinnedItemCount, _geometry.pinnedItemCount);
+        NSInteger firstReorderedItem = MAX(firstItem, (NSInteger)_reorderedItemRange.location);
+        NSInteger endReorderedItem = MIN(itemCount, (NSInteger)NSMaxRange(_reorderedItemRange));
+
+        if (_reorderedItemRange.location != NSNotFound && firstReorderedItem < endReorderedItem) {
+            
+            [self.attributesStore preserveAttributesForItemsInRange:NSMakeRange(firstItem, firstReorderedItem - firstItem)];
+            [self.attributesStore preserveAttributesForItemsInRange:NSMakeRange(endReorderedItem, itemCount - endReorderedItem)];
+
+        } else {
+
+            [self.attributesStore preserveAttributesForItemsInRange:NSMakeRange(firstItem, itemCount - firstItem)];
+        }
+    }
+    
+    _reorderedItemRange = NSMakeRange(NSNotFound, 0);
+    
+    self.invalidatingAllItems = NO;
+
+    if (metrics) [metrics recordPassWithDuration:CACurrentMediaTime() - startTime allocationCount:[self unrecordedAllocationCount]];
+}
+
+- (void)prepareGeometry {
+    
     // Force update of property -filling
     // used to decide whether to arrange
     // items evenly in collection view's
     // full height
     //
-    [self collectionViewContentSize];
-    
+    CGSize contentSize = [self collectionViewContentSize];
     CGSize layoutSize = CGSizeMake(CGRectGetWidth(self.collectionView.bounds) - self.layoutMargin.left - self.layoutMargin.right,
                                    CGRectGetHeight(self.collectionView.bounds) - self.layoutMargin.top - self.layoutMargin.bottom);
 
+    NSInteger itemCount = TGLSectionTableItemCount(&_sections);
     CGFloat itemReveal = self.topReveal;
     
-    if (self.filling) {
+    if (self.filling && itemCount > 0) {
         
-        itemReveal = floor(layoutSize.height / [self.collectionView numberOfItemsInSection:0]);
+        itemReveal = floor(layoutSize.height / itemCount);
     }
 
     CGSize itemSize = self.itemSize;
@@ -191,116 +527,273 @@
     if (itemSize.height == 0.0) itemSize.height = layoutSize.height;
     
     CGFloat itemHorizontalOffset = 0.5 * (layoutSize.width - itemSize.width);
-    CGPoint itemOrigin = CGPointMake(self.layoutMargin.left + floor(itemHorizontalOffset), 0.0);
 
     // Honor overwritten contentOffset
     //
     CGPoint contentOffset = self.overwriteContentOffset ? self.contentOffset : self.collectionView.contentOffset;
 
-    NSMutableDictionary *layoutAttributes = [NSMutableDictionary dictionary];
-    UICollectionViewLayoutAttributes *previousTopOverlappingAttributes[2] = { nil, nil };
-    NSInteger itemCount = [self.collectionView numberOfItemsInSection:0];
+    _parameters = (TGLStackedParameters){
+        
+        .itemCount = itemCount,
+        .itemReveal = itemReveal,
+        .itemHeight = itemSize.height,
+        .revealTable = (self.hasValidRevealTable && !self.filling) ? &_revealTable : NULL,
+        .marginTop = self.layoutMargin.top,
+        .layoutHeight = layoutSize.height,
+        .boundsHeight = CGRectGetHeight(self.collectionView.bounds),
+        .contentHeight = contentSize.height,
+        .contentOffset = contentOffset.y,
+        .contentInsetTop = self.collectionView.contentInset.top,
+        .bounceFactor = self.bounceFactor,
+        .centerSingleItem = self.isCenteringSingleItem,
+        .occlusionThreshold = self.occlusionThreshold
+    };
+    
+    TGLStackedGeometryPrepare(&_geometry, &_parameters, &_firstCompressingItem);
+
+    self.itemFrame = CGRectMake(self.layoutMargin.left + floor(itemHorizontalOffset), self.layoutMargin.top, itemSize.width, itemSize.height);
+}
 
-    static NSInteger firstCompressingItem = -1;
+- (void)prepareForCollectionViewUpdates:(NSArray<UICollectionViewUpdateItem *> *)updateItems {
+    
+    [super prepareForCollectionViewUpdates:updateItems];
     
-    for (NSInteger item = 0; item < itemCount; item++) {
+    self.insertedIndexPaths = [NSMutableSet set];
+    self.disappearingAttributes = [NSMutableDictionary dictionary];
+
+    NSMutableIndexSet *deletedItems = [NSMutableIndexSet indexSet];
+    NSMutableIndexSet *insertedItems = [NSMutableIndexSet indexSet];
+    NSMutableArray *reloadedIndexPaths = [NSMutableArray array];
+    NSMutableDictionary<NSNumber *, NSNumber *> *movedItems = [NSMutableDictionary dictionary];
+    BOOL updatingSections = NO;
+
+    for (UICollectionViewUpdateItem *updateItem in updateItems) {
         
-        NSIndexPath *indexPath = [NSIndexPath indexPathForItem:item inSection:0];
-        UICollectionViewLayoutAttributes *attributes = [UICollectionViewLayoutAttributes layoutAttributesForCellWithIndexPath:indexPath];
+        NSIndexPath *indexPathBeforeUpdate = updateItem.indexPathBeforeUpdate;
+        NSIndexPath *indexPathAfterUpdate = updateItem.indexPathAfterUpdate;
+
+        if ((indexPathBeforeUpdate && indexPathBeforeUpdate.item == NSNotFound) || (indexPathAfterUpdate && indexPathAfterUpdate.item == NSNotFound)) {
+            
+            updatingSections = YES;
+            continue;
+        }
         
-        // By default all items are layed
-        // out evenly with each revealing
-        // only top part ...
-        //
-        attributes.frame = CGRectMake(itemOrigin.x, self.layoutMargin.top + itemReveal * item, itemSize.width, itemSize.height);
+        switch (updateItem.updateAction) {
+                
+            case UICollectionUpdateActionInsert:
+                
+                [insertedItems addIndex:[self itemForIndexPath:indexPathAfterUpdate inSections:&_sections]];
+                [self.insertedIndexPaths addObject:indexPathAfterUpdate];
+                break;
+                
+            case UICollectionUpdateActionDelete: {
 
-        // Cards overlap each other
-        // via z depth AND transform
-        //
-        // See http://stackoverflow.com/questions/12659301/uicollectionview-setlayoutanimated-not-preserving-zindex
-        //
-        // KLUDGE: translation is along negative
-        //         z axis as not to block scroll
-        //         indicators
-        //
-        attributes.zIndex = item;
-        attributes.transform3D = CATransform3DMakeTranslation(0, 0, item - itemCount);
+                NSInteger item = [self itemForIndexPath:indexPathBeforeUpdate inSections:&_previousSections];
+                UICollectionViewLayoutAttributes *attributes = self.deferringUpdates ? [self.attributesStore attributesForItem:item] : nil;
 
-        if (itemCount == 1 && self.isCenteringSingleItem) {
-            
-            // Center single item if necessary
-            //
-            CGRect frame = attributes.frame;
+                if (attributes && !attributes.hidden) {
+                    
+                    // Let visible cards fade out in place
+                    //
+                    attributes = [attributes copy];
+                    attributes.alpha = 0.0;
+                    
+                    self.disappearingAttributes[indexPathBeforeUpdate] = attributes;
+                }
 
-            frame.origin.y = self.layoutMargin.top + 0.5 * (layoutSize.height - itemSize.height);
+                [deletedItems addIndex:item];
+                break;
+            }
 
-            attributes.frame = frame;
-            
-        } else if (contentOffset.y + self.collectionView.contentInset.top < 0.0) {
+            case UICollectionUpdateActionMove: {
+                
+                NSInteger item = [self itemForIndexPath:indexPathBeforeUpdate inSections:&_previousSections];
+                NSInteger targetItem = [self itemForIndexPath:indexPathAfterUpdate inSections:&_sections];
 
-            // Expand cells when reaching top
-            // and user scrolls further down,
-            // i.e. when bouncing
-            //
-            CGRect frame = attributes.frame;
-            
-            frame.origin.y -= self.bounceFactor * (contentOffset.y + self.collectionView.contentInset.top) * item;
+                [deletedItems addIndex:item];
+                [insertedItems addIndex:targetItem];
+
+                if (item != NSNotFound && targetItem != NSNotFound) movedItems[@(item)] = @(targetItem);
+                break;
+            }
+                
+            case UICollectionUpdateActionReload:
+                
+                if (indexPathAfterUpdate) [reloadedIndexPaths addObject:indexPathAfterUpdate];
+                break;
+                
+            default:
+                break;
+        }
+    }
+    
+    [deletedItems removeIndex:NSNotFound];
+    [insertedItems removeIndex:NSNotFound];
+
+    BOOL trackingItems = !updatingSections && TGLSectionTableItemCount(&_previousSections) - (NSInteger)deletedItems.count + (NSInteger)insertedItems.count == TGLSectionTableItemCount(&_sections);
+
+    // Measured sizes follow moved items, while
+    // reloaded items have to be measured again
+    //
+    if (trackingItems) {
+        
+        [self.measuredSizeCache updateWithDeletedItems:deletedItems insertedItems:insertedItems movedItems:movedItems];
+        
+        for (NSIndexPath *indexPath in reloadedIndexPaths) {
             
-            attributes.frame = frame;
+            [self.measuredSizeCache removeSizeForItem:[self itemForIndexPath:indexPath]];
+        }
+        
+    } else {
+        
+        [self.measuredSizeCache removeAllSizes];
+    }
+
+    if (!self.deferringUpdates) return;
+
+    if (!trackingItems) {
+        
+        // Section updates shift index paths
+        // in ways not worth tracking
+        //
+        [self finishDeferredUpdates];
 
-        } else if (CGRectGetMinY(attributes.frame) < contentOffset.y + self.layoutMargin.top) {
+        return;
+    }
+
+    long *deleted = malloc(MAX(deletedItems.count, 1) * sizeof(long));
+    long *inserted = malloc(MAX(insertedItems.count, 1) * sizeof(long));
+    long deletedCount = 0;
+    long insertedCount = 0;
 
-            // Topmost cells overlap stack, but
-            // are placed directly above each
-            // other such that only one cell
-            // is visible
-            //
-            CGRect frame = attributes.frame;
+    for (NSUInteger item = deletedItems.firstIndex; item != NSNotFound; item = [deletedItems indexGreaterThanIndex:item]) deleted[deletedCount++] = item;
+    for (NSUInteger item = insertedItems.firstIndex; item != NSNotFound; item = [insertedItems indexGreaterThanIndex:item]) inserted[insertedCount++] = item;
+
+    // Only attributes of items resident in
+    // the store are touched, so cost scales
+    // with the visible window not item count
+    //
+    NSInteger itemCount = TGLSectionTableItemCount(&_sections);
+
+    [self.attributesStore updateItemCount:itemCount usingBlock:^NSInteger(NSInteger item) {
+        
+        long result = TGLItemUpdateMap(deleted, deletedCount, inserted, insertedCount, item);
+        
+        return (result < 0) ? NSNotFound : result;
+    }];
+    
+    [self.attributesStore prepareForItemCount:itemCount];
+
+    if (self.usingRevealTable) {
+
+        // Request reveal heights of new
+        // and reloaded items only
+        //
+        double *values = malloc(MAX(insertedCount, 1) * sizeof(double));
+        
+        for (long i = 0; i < insertedCount; i++) {
             
-            frame.origin.y = contentOffset.y + self.layoutMargin.top;
+            values[i] = [self topRevealForItemAtIndexPath:[self indexPathForItem:inserted[i]]];
+        }
+        
+        TGLRevealTableUpdate(&_revealTable, deleted, deletedCount, inserted, values, insertedCount);
+        
+        for (NSIndexPath *indexPath in reloadedIndexPaths) {
             
-            attributes.frame = frame;
-
-            // Keep queue of last two items'
-            // attributes and hide any item
-            // below top overlapping item to
-            // improve performance
-            //
-            if (previousTopOverlappingAttributes[1]) previousTopOverlappingAttributes[1].hidden = YES;
+            NSInteger item = [self itemForIndexPath:indexPath];
             
-            previousTopOverlappingAttributes[1] = previousTopOverlappingAttributes[0];
-            previousTopOverlappingAttributes[0] = attributes;
+            if (item != NSNotFound) TGLRevealTableSetValue(&_revealTable, item, [self topRevealForItemAtIndexPath:indexPath]);
+        }
+        
+        free(values);
 
-        } else if (self.collectionViewContentSize.height > CGRectGetHeight(self.collectionView.bounds) && contentOffset.y > self.collectionViewContentSize.height - CGRectGetHeight(self.collectionView.bounds)) {
+        [self prepareGeometry];
+    }
+    
+    free(deleted);
+    free(inserted);
 
-            // Compress cells when reaching bottom
-            // and user scrolls further up,
-            // i.e. when bouncing
-            //
-            if (firstCompressingItem < 0) {
-                
-                firstCompressingItem = item;
+    self.deferringUpdates = NO;
+}
 
-            } else {
+- (void)finalizeCollectionViewUpdates {
+    
+    [super finalizeCollectionViewUpdates];
+    
+    self.insertedIndexPaths = nil;
+    self.disappearingAttributes = nil;
+}
 
-                CGRect frame = attributes.frame;
-                CGFloat delta = contentOffset.y + CGRectGetHeight(self.collectionView.bounds) - self.collectionViewContentSize.height;
-                
-                frame.origin.y += self.bounceFactor * delta * (firstCompressingItem - item);
-                frame.origin.y = MAX(frame.origin.y, contentOffset.y + self.layoutMargin.top);
+- (UICollectionViewLayoutAttributes *)initialLayoutAttributesForAppearingItemAtIndexPath:(NSIndexPath *)itemIndexPath {
+    
+    if ([self.insertedIndexPaths containsObject:itemIndexPath]) {
+        
+        // Let inserted cards fade in place
+        //
+        UICollectionViewLayoutAttributes *attributes = [[self layoutAttributesForItemAtIndexPath:itemIndexPath] copy];
+        
+        attributes.alpha = 0.0;
+        
+        return attributes;
+    }
+    
+    return [super initialLayoutAttributesForAppearingItemAtIndexPath:itemIndexPath];
+}
 
-                attributes.frame = frame;
-            }
+- (UICollectionViewLayoutAttributes *)finalLayoutAttributesForDisappearingItemAtIndexPath:(NSIndexPath *)itemIndexPath {
+    
+    UICollectionViewLayoutAttributes *attributes = self.disappearingAttributes[itemIndexPath];
+    
+    return attributes ?: [super finalLayoutAttributesForDisappearingItemAtIndexPath:itemIndexPath];
+}
 
-        } else {
-            
-            firstCompressingItem = -1;
-        }
+- (UICollectionViewLayoutInvalidationContext *)invalidationContextForInteractivelyMovingItems:(NSArray<NSIndexPath *> *)targetIndexPaths withTargetPosition:(CGPoint)targetPosition previousIndexPaths:(NSArray<NSIndexPath *> *)previousIndexPaths previousPosition:(CGPoint)previousPosition {
+    
+    TGLStackedLayoutInvalidationContext *context = (TGLStackedLayoutInvalidationContext *)[super invalidationContextForInteractivelyMovingItems:targetIndexPaths withTargetPosition:targetPosition previousIndexPaths:previousIndexPaths previousPosition:previousPosition];
+    
+    if (_reorderingSourceItem == NSNotFound) {
         
-        layoutAttributes[indexPath] = attributes;
+        _reorderingSourceItem = [self itemForIndexPath:previousIndexPaths.firstObject];
+        _reorderingTargetItem = _reorderingSourceItem;
+    }
+    
+    [self moveReorderedItemToItem:[self itemForIndexPath:targetIndexPaths.firstObject] context:context];
+
+    return context;
+}
+
+- (UICollectionViewLayoutInvalidationContext *)invalidationContextForEndingInteractiveMovementOfItemsToFinalIndexPaths:(NSArray<NSIndexPath *> *)indexPaths previousIndexPaths:(NSArray<NSIndexPath *> *)previousIndexPaths movementCancelled:(BOOL)movementCancelled {
+    
+    TGLStackedLayoutInvalidationContext *context = (TGLStackedLayoutInvalidationContext *)[super invalidationContextForEndingInteractiveMovementOfItemsToFinalIndexPaths:indexPaths previousIndexPaths:previousIndexPaths movementCancelled:movementCancelled];
+    
+    // When cancelled final index path
+    // is the item's original one
+    //
+    if (_reorderingSourceItem != NSNotFound) [self moveReorderedItemToItem:[self itemForIndexPath:indexPaths.firstObject] context:context];
+
+    NSInteger item = _reorderingTargetItem;
+
+    if (_floatingReorderedItem && item != NSNotFound && item < TGLSectionTableItemCount(&_sections)) {
+
+        // Dropped item stops floating even if
+        // it did not move, so its z ordering
+        // has to be recomputed
+        //
+        context.invalidateReorderedItemsOnly = YES;
+
+        [context invalidateItemsAtIndexPaths:@[[self indexPathForItem:item]]];
+
+        _reorderedItemRange = (_reorderedItemRange.location == NSNotFound) ? NSMakeRange(item, 1) : NSUnionRange(_reorderedItemRange, NSMakeRange(item, 1));
     }
 
-    self.layoutAttributes = layoutAttributes;
+    _floatingReorderedItem = NO;
+
+    if (!movementCancelled) [self invalidateLayoutCache];
+
+    _reorderingSourceItem = NSNotFound;
+    _reorderingTargetItem = NSNotFound;
+
+    return context;
 }
 
 - (UICollectionViewLayoutAttributes *)layoutAttributesForInteractivelyMovingItemAtIndexPath:(NSIndexPath *)indexPath withTargetPosition:(CGPoint)position {
@@ -328,22 +821,421 @@
 
 - (NSArray *)layoutAttributesForElementsInRect:(CGRect)rect {
 
-    NSMutableArray *layoutAttributes = [NSMutableArray array];
+    [self finishDeferredUpdates];
+
+    long firstItem, endItem;
+    
+    TGLStackedGeometryItemRange(&_geometry, CGRectGetMinY(rect), CGRectGetMaxY(rect), &firstItem, &endItem);
+
+    NSInteger count = endItem - firstItem;
+    NSMutableArray *layoutAttributes = [NSMutableArray arrayWithCapacity:count];
+
+    [self reserveBufferCapacity:count];
+
+    TGLStackedGeometryGetItems(&_geometry, firstItem, count, _originBuffer, _flagsBuffer);
     
-    [self.layoutAttributes enumerateKeysAndObjectsUsingBlock:^(NSIndexPath *indexPath, UICollectionViewLayoutAttributes *attributes, BOOL *stop) {
+    NSUInteger visibleCount = 0;
+    NSUInteger hiddenCount = 0;
+
+    for (NSInteger i = 0; i < count; i++) {
         
-        if (CGRectIntersectsRect(rect, attributes.frame)) {
+        NSInteger item = firstItem + i;
+        UICollectionViewLayoutAttributes *attributes = [self.attributesStore attributesForItem:item];
+        
+        if (attributes == nil) {
+            
+            attributes = [self dequeueAttributesForItem:item originY:_originBuffer[i] flags:_flagsBuffer[i]];
+
+            hiddenCount += attributes.hidden;
+            visibleCount += !attributes.hidden;
+        }
+
+        // Hidden items are either pinned below or
+        // covered by other items, so don't even
+        // let collection view create cells
+        //
+        if (!attributes.hidden && CGRectIntersectsRect(rect, attributes.frame)) {
             
             [layoutAttributes addObject:attributes];
         }
-    }];
+    }
+    
+    TGLLayoutMetrics *metrics = self.metrics;
+
+    if (metrics) {
+        
+        [metrics recordItemsWithVisibleCount:visibleCount hiddenCount:hiddenCount];
+        [metrics recordQueryWithReturnedCount:layoutAttributes.count allocationCount:[self unrecordedAllocationCount]];
+    }
     
     return layoutAttributes;
 }
 
 - (UICollectionViewLayoutAttributes *)layoutAttributesForItemAtIndexPath:(NSIndexPath *)indexPath {
     
-    return self.layoutAttributes[indexPath];
+    [self finishDeferredUpdates];
+
+    NSInteger item = [self itemForIndexPath:indexPath];
+
+    if (item == NSNotFound || item >= _geometry.itemCount) return nil;
+
+    UICollectionViewLayoutAttributes *attributes = [self.attributesStore attributesForItem:item];
+
+    if (attributes) return attributes;
+
+    attributes = [self dequeueAttributesForItem:item originY:TGLStackedGeometryOriginY(&_geometry, item) flags:TGLStackedGeometryFlags(&_geometry, item)];
+
+    [self.metrics recordItemsWithVisibleCount:!attributes.hidden hiddenCount:attributes.hidden];
+
+    return attributes;
+}
+
+#pragma mark - Methods
+
+- (void)beginReorderingItemAtIndexPath:(NSIndexPath *)indexPath {
+    
+    NSInteger item = [self itemForIndexPath:indexPath];
+    
+    if (item == NSNotFound || _reorderingSourceItem != NSNotFound) return;
+    
+    _reorderingSourceItem = item;
+    _reorderingTargetItem = item;
+    _floatingReorderedItem = YES;
+
+    [self invalidateReorderedItem:item];
+}
+
+- (void)endReordering {
+    
+    NSInteger item = _reorderingTargetItem;
+    BOOL floating = _floatingReorderedItem;
+
+    _reorderingSourceItem = NSNotFound;
+    _reorderingTargetItem = NSNotFound;
+    _floatingReorderedItem = NO;
+
+    if (!floating || item == NSNotFound) return;
+
+    // Changed z ordering makes collection
+    // view apply attributes to cell again
+    //
+    if (item < TGLSectionTableItemCount(&_sections)) [self invalidateReorderedItem:item];
+}
+
+- (void)invalidateLayoutCache {
+    
+    _dataVersion++;
+    
+    TGLLayoutCacheRemoveAll(&_layoutCache);
+}
+
+- (NSArray<NSIndexPath *> *)indexPathsForItemsRevealedWithVelocity:(CGFloat)velocity duration:(NSTimeInterval)duration {
+    
+    NSRange range = [self itemRangeRevealedWithVelocity:velocity duration:duration];
+
+    if (range.location == NSNotFound) return @[];
+    
+    NSMutableArray *indexPaths = [NSMutableArray arrayWithCapacity:range.length];
+
+    for (NSInteger item = range.location; item < NSMaxRange(range); item++) {
+
+        [indexPaths addObject:[self indexPathForItem:item]];
+    }
+
+    return indexPaths;
+}
+
+- (NSRange)itemRangeRevealedWithVelocity:(CGFloat)velocity duration:(NSTimeInterval)duration {
+    
+    if (velocity == 0.0 || duration <= 0.0 || ![self hasCurrentParameters]) return NSMakeRange(NSNotFound, 0);
+    
+    long firstItem, endItem;
+
+    TGLStackedGeometryPredictItemRange(&_parameters, velocity, duration, &firstItem, &endItem);
+    
+    return (firstItem < endItem) ? NSMakeRange(firstItem, endItem - firstItem) : NSMakeRange(NSNotFound, 0);
+}
+
+- (NSRange)visibleItemRange {
+    
+    if (![self hasCurrentParameters]) return NSMakeRange(NSNotFound, 0);
+    
+    long firstItem, endItem;
+    
+    TGLStackedGeometryItemRange(&_geometry, _parameters.contentOffset, _parameters.contentOffset + _parameters.boundsHeight, &firstItem, &endItem);
+    
+    return (firstItem < endItem) ? NSMakeRange(firstItem, endItem - firstItem) : NSMakeRange(NSNotFound, 0);
+}
+
+#pragma mark - Helpers
+
+- (BOOL)hasCurrentParameters {
+    
+    if (_parameters.itemCount == 0) return NO;
+    
+    // Don't report anything from a pass that
+    // became stale by updates not laid out yet
+    //
+    if (TGLSectionTableItemCount(&_sections) != _parameters.itemCount) return NO;
+    if (_parameters.revealTable && _revealTable.count != _parameters.itemCount) return NO;
+    
+    return YES;
+}
+
+- (NSUInteger)unrecordedAllocationCount {
+    
+    NSUInteger allocationCount = self.attributesStore.allocationCount;
+    NSUInteger count = allocationCount - _recordedAllocationCount;
+    
+    _recordedAllocationCount = allocationCount;
+    
+    return count;
+}
+
+- (BOOL)hasValidRevealTable {
+    
+    // Reveal table is out of sync while
+    // batch updates are pending
+    //
+    return self.usingRevealTable && _revealTable.count == TGLSectionTableItemCount(&_sections);
+}
+
+- (void)finishDeferredUpdates {
+    
+    if (!self.deferringUpdates) return;
+
+    self.deferringUpdates = NO;
+
+    [self.attributesStore removeAllAttributes];
+    [self.attributesStore prepareForItemCount:TGLSectionTableItemCount(&_sections)];
+    
+    if (self.usingRevealTable) {
+        
+        [self updateRevealTable];
+        [self prepareGeometry];
+    }
+}
+
+- (BOOL)updateSectionTable {
+    
+    NSInteger sectionCount = self.collectionView.numberOfSections;
+    long *itemCounts = malloc(MAX(sectionCount, 1) * sizeof(long));
+    
+    for (NSInteger section = 0; section < sectionCount; section++) {
+        
+        itemCounts[section] = [self.collectionView numberOfItemsInSection:section];
+    }
+    
+    // Keep previous sections to map index
+    // paths before batch updates
+    //
+    TGLSectionTable sections = _previousSections;
+
+    _previousSections = _sections;
+    _sections = sections;
+
+    TGLSectionTableReset(&_sections, itemCounts, sectionCount);
+    
+    free(itemCounts);
+    
+    return !TGLSectionTableEqual(&_sections, &_previousSections);
+}
+
+- (NSInteger)itemForIndexPath:(NSIndexPath *)indexPath {
+    
+    return [self itemForIndexPath:indexPath inSections:&_sections];
+}
+
+- (NSInteger)itemForIndexPath:(NSIndexPath *)indexPath inSections:(const TGLSectionTable *)sections {
+    
+    if (indexPath == nil || indexPath.section < 0 || indexPath.section >= sections->count || indexPath.item < 0) return NSNotFound;
+    
+    NSInteger item = TGLSectionTableStart(sections, indexPath.section) + indexPath.item;
+    
+    return (item < TGLSectionTableStart(sections, indexPath.section + 1)) ? item : NSNotFound;
+}
+
+- (NSIndexPath *)indexPathForItem:(NSInteger)item {
+    
+    NSInteger section = TGLSectionTableSection(&_sections, item);
+    
+    return [NSIndexPath indexPathForItem:item - TGLSectionTableStart(&_sections, section) inSection:section];
+}
+
+- (CGFloat)topRevealForItemAtIndexPath:(NSIndexPath *)indexPath {
+    
+    id<TGLStackedLayoutDelegate> delegate = (id<TGLStackedLayoutDelegate>)self.collectionView.delegate;
+
+    // Reveal heights must not be negative
+    // to keep items in order
+    //
+    return MAX([delegate collectionView:self.collectionView layout:self topRevealForItemAtIndexPath:indexPath], 0.0);
+}
+
+- (void)updateRevealTable {
+    
+    self.usingRevealTable = [self.collectionView.delegate respondsToSelector:@selector(collectionView:layout:topRevealForItemAtIndexPath:)];
+
+    if (!self.usingRevealTable) {
+        
+        TGLRevealTableFree(&_revealTable);
+        
+        return;
+    }
+
+    TGLLayoutCacheKey key = [self layoutCacheKey];
+    const TGLLayoutCacheEntry *entry = TGLLayoutCacheLookup(&_layoutCache, &key);
+    
+    if (entry) {
+        
+        TGLRevealTableCopy(&_revealTable, &entry->revealTable);
+        
+        return;
+    }
+
+    NSInteger itemCount = TGLSectionTableItemCount(&_sections);
+    double *values = malloc(MAX(itemCount, 1) * sizeof(double));
+    
+    for (NSInteger section = 0; section < _sections.count; section++) {
+        
+        NSInteger start = TGLSectionTableStart(&_sections, section);
+        NSInteger end = TGLSectionTableStart(&_sections, section + 1);
+
+        for (NSInteger item = start; item < end; item++) {
+            
+            values[item] = [self topRevealForItemAtIndexPath:[NSIndexPath indexPathForItem:item - start inSection:section]];
+        }
+    }
+    
+    // Delegate has to be asked on main thread,
+    // but tree can be built concurrently
+    //
+    TGLRevealTableResetConcurrently(&_revealTable, values, itemCount, TGLStackedLayoutConcurrentApply);
+    TGLRevealTableCopy(&TGLLayoutCacheInsert(&_layoutCache, &key)->revealTable, &_revealTable);
+    
+    free(values);
+}
+
+- (TGLLayoutCacheKey)layoutCacheKey {
+    
+    CGSize size = self.collectionView.bounds.size;
+    
+    return (TGLLayoutCacheKey){
+        
+        .boundsWidth = size.width,
+        .boundsHeight = size.height,
+        .marginTop = self.layoutMargin.top,
+        .marginLeft = self.layoutMargin.left,
+        .marginBottom = self.layoutMargin.bottom,
+        .marginRight = self.layoutMargin.right,
+        .itemWidth = self.itemSize.width,
+        .itemHeight = self.itemSize.height,
+        .itemReveal = self.topReveal,
+        .itemCount = TGLSectionTableItemCount(&_sections),
+        .dataVersion = _dataVersion
+    };
+}
+
+- (void)moveReorderedItemToItem:(NSInteger)targetItem context:(TGLStackedLayoutInvalidationContext *)context {
+    
+    NSInteger previousItem = _reorderingTargetItem;
+    NSInteger itemCount = TGLSectionTableItemCount(&_sections);
+    
+    context.invalidateReorderedItemsOnly = YES;
+
+    if (targetItem == NSNotFound || previousItem == NSNotFound || targetItem == previousItem || targetItem >= itemCount || previousItem >= itemCount) return;
+    
+    // Only items between previous and new
+    // position shift by one, taking their
+    // reveal heights along
+    //
+    NSInteger firstItem = MIN(previousItem, targetItem);
+    NSInteger lastItem = MAX(previousItem, targetItem);
+    
+    if (self.hasValidRevealTable) {
+        
+        double reveal = TGLRevealTableValue(&_revealTable, previousItem);
+
+        TGLRevealTableRemove(&_revealTable, previousItem);
+        TGLRevealTableInsert(&_revealTable, targetItem, reveal);
+    }
+    
+    NSMutableArray *indexPaths = [NSMutableArray arrayWithCapacity:lastItem - firstItem + 1];
+    
+    for (NSInteger item = firstItem; item <= lastItem; item++) {
+        
+        [indexPaths addObject:[self indexPathForItem:item]];
+    }
+    
+    [context invalidateItemsAtIndexPaths:indexPaths];
+
+    _reorderedItemRange = (_reorderedItemRange.location == NSNotFound) ? NSMakeRange(firstItem, lastItem - firstItem + 1) : NSUnionRange(_reorderedItemRange, NSMakeRange(firstItem, lastItem - firstItem + 1));
+    _reorderingTargetItem = targetItem;
+}
+
+- (void)invalidateReorderedItem:(NSInteger)item {
+    
+    TGLStackedLayoutInvalidationContext *context = [[TGLStackedLayoutInvalidationContext alloc] init];
+    
+    context.invalidateReorderedItemsOnly = YES;
+
+    [context invalidateItemsAtIndexPaths:@[[self indexPathForItem:item]]];
+
+    _reorderedItemRange = (_reorderedItemRange.location == NSNotFound) ? NSMakeRange(item, 1) : NSUnionRange(_reorderedItemRange, NSMakeRange(item, 1));
+
+    [self invalidateLayoutWithContext:context];
+}
+
+- (void)reserveBufferCapacity:(NSInteger)capacity {
+    
+    if (capacity <= _bufferCapacity) return;
+    
+    _bufferCapacity = MAX(capacity, 2 * _bufferCapacity);
+    _originBuffer = realloc(_originBuffer, _bufferCapacity * sizeof(double));
+    _flagsBuffer = realloc(_flagsBuffer, _bufferCapacity * sizeof(TGLLayoutItemFlags));
+}
+
+- (UICollectionViewLayoutAttributes *)dequeueAttributesForItem:(NSInteger)item originY:(CGFloat)originY flags:(TGLLayoutItemFlags)flags {
+    
+    UICollectionViewLayoutAttributes *attributes = [self.attributesStore dequeueAttributesForItem:item];
+
+    // By default all items are layed
+    // out evenly with each revealing
+    // only top part ...
+    //
+    CGRect frame = self.itemFrame;
+    
+    frame.origin.y = originY;
+    
+    attributes.frame = frame;
+    
+    // Cards overlap each other
+    // via z depth AND transform
+    //
+    // See http://stackoverflow.com/questions/12659301/uicollectionview-setlayoutanimated-not-preserving-zindex
+    //
+    // KLUDGE: translation is along negative
+    //         z axis as not to block scroll
+    //         indicators
+    //
+    attributes.zIndex = item;
+    attributes.transform3D = CATransform3DMakeTranslation(0, 0, item - _geometry.itemCount);
+
+    if (_floatingReorderedItem && item == _reorderingTargetItem && self.movingItemOnTop) {
+        
+        // Item being dragged floats
+        // above all other items
+        //
+        attributes.zIndex = NSIntegerMax;
+        attributes.transform3D = CATransform3DMakeTranslation(0.0, 0.0, 1.0);
+    }
+
+    // Items below the two top overlapping
+    // items are hidden to improve performance
+    //
+    attributes.hidden = (flags & TGLLayoutItemFlagHidden) != 0;
+
+    return attributes;
 }
 
 @end
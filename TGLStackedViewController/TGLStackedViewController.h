@@ -30,6 +30,10 @@ FOUNDATION_EXPORT const unsigned char TGLStackedViewControllerVersionString[];
 
 #import "TGLStackedLayout.h"
 #import "TGLExposedLayout.h"
+#import "TGLTransitionLayout.h"
+#import "TGLLayoutAttributesPool.h"
+#import "TGLLayoutMetrics.h"
+#import "TGLWindowedDataSource.h"
 
 @interface TGLStackedViewController : UICollectionViewController <UICollectionViewDragDelegate>
 
@@ -181,6 +185,19 @@ FOUNDATION_EXPORT const unsigned char TGLStackedViewControllerVersionString[];
  */
 @property (nonatomic, assign) IBInspectable BOOL unexposedItemsAreSelectable;
 
+/** Size exposed item to fit its content.
+ *
+ * If set to `YES` the exposed item's cell is asked for
+ * its preferred height once and the result is kept
+ * in the stacked layout's -measuredSizeCache until the
+ * item is reloaded. Stacked items are never measured.
+ *
+ * See -[TGLExposedLayout shouldMeasureItemAtIndexPath:]
+ *
+ * Default value is `NO`
+ */
+@property (nonatomic, assign) IBInspectable BOOL exposedItemSizesToFit;
+
 /** Factor used to scale items while being moved interactively.
  *
  * Default value is 0.95
@@ -215,6 +232,79 @@ FOUNDATION_EXPORT const unsigned char TGLStackedViewControllerVersionString[];
  */
 @property (nonatomic, assign) IBInspectable CGFloat collapsePinchMinimumThreshold;
 
+/** Interval in seconds to predict collapse gesture progress ahead by its velocity.
+ *
+ * Collapse gesture input is coalesced and applied to the
+ * transition layout once per displayed frame. If the value
+ * is greater than 0.0 progress is extrapolated to the time
+ * the frame is displayed plus this interval, which hides
+ * input latency at the risk of overshooting.
+ *
+ * Default value is 0.0, i.e. no prediction
+ */
+@property (nonatomic, assign) IBInspectable NSTimeInterval collapsePredictionInterval;
+
+/** Metrics object the stacked and exposed layouts record their performance to.
+ *
+ * Recording is disabled when `nil`.
+ *
+ * Default value is `nil`
+ */
+@property (nonatomic, strong, nullable) TGLLayoutMetrics *layoutMetrics;
+
+/** Pool the stacked and exposed layouts recycle layout attributes objects to.
+ *
+ * Assign the same pool to several controllers, e.g. many
+ * small stacks in a scrolling feed, to bound the number
+ * of spare attributes objects of all their layouts. Layouts
+ * use private pools when `nil`.
+ *
+ * Default value is `nil`
+ */
+@property (nonatomic, strong, nullable) TGLLayoutAttributesPool *attributesPool;
+
+/** Number of frames ahead to prefetch items about to become visible while scrolling.
+ *
+ * When the collection view's `prefetchDataSource` is set
+ * the controller predicts which items are revealed within
+ * this number of frames at the current scroll velocity,
+ * and asks the prefetch data source to prefetch them, or
+ * to cancel prefetching once they are no longer predicted
+ * before becoming visible. This complements prefetching
+ * by the collection view, which does not know how items
+ * overlap in the stacked layout.
+ *
+ * Subclasses overriding `-scrollViewDidScroll:` have to
+ * call `super`. Set to 0 to disable prediction.
+ *
+ * Default value is 30
+ */
+@property (nonatomic, assign) IBInspectable NSUInteger prefetchFrameCount;
+
+/** Current vertical scroll velocity in points per second as estimated from content offset changes. */
+@property (nonatomic, readonly) CGFloat scrollVelocity;
+
+/** Windowed data source whose resident records follow the stacked layout's visible items.
+ *
+ * While scrolling the window is moved to the visible items
+ * and pages of items predicted to be revealed within
+ * -prefetchFrameCount frames are read ahead. Pages farthest
+ * away are evicted, so memory use stays bounded regardless
+ * of the number of items.
+ *
+ * Subclasses overriding `-scrollViewDidScroll:` have to
+ * call `super`.
+ *
+ * Default value is `nil`
+ */
+@property (nonatomic, strong, nullable) TGLWindowedDataSource *windowedDataSource;
+
+/** `YES` while a layout trace is being recorded.
+ *
+ * @see -startRecordingLayoutTrace
+ */
+@property (nonatomic, readonly, getter=isRecordingLayoutTrace) BOOL recordingLayoutTrace;
+
 /** Returns the class to use when creating the exposed layout.
  *
  * If you subclass `TGLExposedLayout` overwrite this method
@@ -222,6 +312,45 @@ FOUNDATION_EXPORT const unsigned char TGLStackedViewControllerVersionString[];
  */
 + (nonnull Class)exposedLayoutClass;
 
+/** Returns the class to use when creating interactive transition layouts.
+ *
+ * If you subclass `TGLTransitionLayout` overwrite this method
+ * and return your subclass.
+ */
++ (nonnull Class)transitionLayoutClass;
+
+/** Returns index paths of items predicted to become visible within the next `frameCount` frames.
+ *
+ * The prediction is based on the current `-scrollVelocity`
+ * and the stacked layout's geometry. Items already visible
+ * are not returned. While an item is exposed the result is
+ * empty.
+ *
+ * @param frameCount The number of display frames to look ahead.
+ *
+ * @see -prefetchFrameCount
+ */
+- (nonnull NSArray<NSIndexPath *> *)indexPathsForItemsRevealedWithinFrameCount:(NSUInteger)frameCount;
+
+/** Starts recording the layouts' input in every display frame.
+ *
+ * The trace holds the stacked and exposed layout configuration,
+ * and per frame the collection view's content offset, bounds,
+ * content insets and item count, the progress of interactive
+ * collapse transitions, the exposed item, and the target
+ * position of an item being moved. Frames are only recorded
+ * if any of these changed.
+ *
+ * Replay traces headlessly with `Benchmarks/TGLTraceReplay.c`
+ * to reproduce layout cost of real user input. The controller
+ * is retained while recording, so call `-stopRecordingLayoutTrace`
+ * when done. Starting again discards the current trace.
+ */
+- (void)startRecordingLayoutTrace;
+
+/** Stops recording and returns the trace recorded since `-startRecordingLayoutTrace`, or `nil` if not recording. */
+- (nullable NSData *)stopRecordingLayoutTrace;
+
 /** Sets the currently exposed item.
  *
  * Expose the item at a valid index path location
@@ -258,4 +387,26 @@ FOUNDATION_EXPORT const unsigned char TGLStackedViewControllerVersionString[];
  */
 - (void)setExposedItemIndexPath:(nullable NSIndexPath *)exposedItemIndexPath animated:(BOOL)animated completion:(nullable void (^)(void))completion;
 
+/** Updates the items of a section by diffing their identifiers.
+ *
+ * Computes the inserts, deletes and a minimal set of moves
+ * turning `oldIdentifiers` into `newIdentifiers` and applies
+ * them in a single call to `-performBatchUpdates:completion:`,
+ * so that only affected cells are updated and animated instead
+ * of reloading the collection view. Identifiers must be unique
+ * within a section and implement `-isEqual:` and `-hash`, e.g.
+ * strings or numbers.
+ *
+ * If the exposed item is part of the update it stays exposed
+ * as long as its identifier is contained in `newIdentifiers`.
+ * Otherwise all items are collapsed before applying updates.
+ *
+ * @param oldIdentifiers The identifiers of items currently in `section`.
+ * @param newIdentifiers The identifiers of items in `section` after the update.
+ * @param section The section to update.
+ * @param updates The block to update the data source's model in, called from within the batch update.
+ * @param completion The block to execute after all batch updates are finished.
+ */
+- (void)performUpdatesFromIdentifiers:(nonnull NSArray *)oldIdentifiers toIdentifiers:(nonnull NSArray *)newIdentifiers inSection:(NSInteger)section updates:(nullable void (^)(void))updates completion:(nullable void (^)(BOOL finished))completion;
+
 @end
@@ -24,13 +24,32 @@
 //  THE SOFTWARE.
 
 #import "TGLStackedViewController.h"
+#import "TGLLayoutGeometry.h"
+#import "TGLLayoutTrace.h"
+#import "TGLProgressCoalescer.h"
 
-@interface TGLStackedViewController () <UICollectionViewDelegate, UICollectionViewDataSource, UICollectionViewDropDelegate,UIGestureRecognizerDelegate>
+@interface TGLStackedViewController () <UICollectionViewDelegate, UICollectionViewDataSource, UICollectionViewDropDelegate,UIGestureRecognizerDelegate> {
+
+    // Collapse gesture input collected
+    // between display link ticks
+    //
+    TGLProgressCoalescer _collapseProgressCoalescer;
+
+    // Last frame written to layout
+    // trace while recording
+    //
+    TGLLayoutTraceFrame _layoutTraceFrame;
+}
 
 @property (nonatomic, strong) TGLStackedLayout *stackedLayout;
 @property (nonatomic, strong) TGLExposedLayout *exposedLayout;
 @property (nonatomic, weak) UICollectionViewTransitionLayout *transitionLayout;
 
+// Exposed layout prepared when an item is
+// touched, before it's actually selected
+//
+@property (nonatomic, strong) TGLExposedLayout *preparedExposedLayout;
+
 @property (nonatomic, strong) UILongPressGestureRecognizer *moveGestureRecognizer;
 @property (nonatomic, strong) NSIndexPath *movingIndexPath;
 @property (nonatomic, strong) NSIndexPath *dragSourceIndexPath;
@@ -40,8 +59,28 @@
 @property (nonatomic, readonly) UIPinchGestureRecognizer *collapsePinchGestureRecognizer;
 
 @property (nonatomic, assign, getter=isFinishingInteractiveTransition) BOOL finishingInteractiveTransition;
+@property (nonatomic, strong) CADisplayLink *collapseDisplayLink;
 @property (nonatomic, assign, getter=isDragging) BOOL dragging;
 
+@property (nonatomic, assign) CGFloat scrollVelocity;
+@property (nonatomic, assign) CGFloat lastScrollOffset;
+@property (nonatomic, assign) CFTimeInterval lastScrollTimestamp;
+@property (nonatomic, strong) NSMutableSet<NSIndexPath *> *prefetchedIndexPaths;
+
+// Gesture state kept between
+// recognizer callbacks
+//
+@property (nonatomic, assign) CGPoint moveStartLocation;
+@property (nonatomic, assign) CGPoint moveStartTargetPosition;
+@property (nonatomic, assign) CGFloat collapsePanMinimumTranslation;
+@property (nonatomic, assign) CGFloat collapsePanMaximumTranslation;
+@property (nonatomic, assign) CGFloat collapsePinchMaximumScale;
+
+@property (nonatomic, assign) CGPoint moveTargetPosition;
+@property (nonatomic, strong) NSMutableData *layoutTrace;
+@property (nonatomic, strong) CADisplayLink *layoutTraceDisplayLink;
+@property (nonatomic, assign) CFTimeInterval layoutTraceStartTime;
+
 @end
 
 @implementation TGLStackedViewController
@@ -54,6 +93,11 @@
     return TGLExposedLayout.class;
 }
 
++ (Class)transitionLayoutClass {
+
+    return TGLTransitionLayout.class;
+}
+
 - (instancetype)initWithCoder:(NSCoder *)aDecoder {
 
     self = [super initWithCoder:aDecoder];
@@ -105,6 +149,10 @@
     _collapsePanMinimumThreshold = 120.0;
     _collapsePanMaximumThreshold = 0.0;
     _collapsePinchMinimumThreshold = 0.25;
+    _collapsePredictionInterval = 0.0;
+
+    _prefetchFrameCount = 30;
+    _prefetchedIndexPaths = [NSMutableSet set];
 }
 
 #pragma mark - View life cycle
@@ -116,6 +164,8 @@
     NSAssert([self.collectionViewLayout isKindOfClass:TGLStackedLayout.class], @"TGLStackedViewController collection view layout is not a TGLStackedLayout");
     
     self.stackedLayout = (TGLStackedLayout *)self.collectionViewLayout;
+    self.stackedLayout.metrics = self.layoutMetrics;
+    self.stackedLayout.attributesPool = self.attributesPool;
 
     if (@available(iOS 11, *)) {
 
@@ -140,6 +190,34 @@
 
 #pragma mark - Accessors
 
+- (void)setLayoutMetrics:(TGLLayoutMetrics *)layoutMetrics {
+    
+    _layoutMetrics = layoutMetrics;
+    
+    self.stackedLayout.metrics = layoutMetrics;
+    self.exposedLayout.metrics = layoutMetrics;
+}
+
+- (void)setAttributesPool:(TGLLayoutAttributesPool *)attributesPool {
+    
+    _attributesPool = attributesPool;
+    
+    self.stackedLayout.attributesPool = attributesPool;
+    self.exposedLayout.attributesPool = attributesPool;
+}
+
+- (void)setWindowedDataSource:(TGLWindowedDataSource *)windowedDataSource {
+    
+    _windowedDataSource = windowedDataSource;
+    
+    [self updateWindowedDataSource];
+}
+
+- (BOOL)isRecordingLayoutTrace {
+    
+    return self.layoutTrace != nil;
+}
+
 - (UIGestureRecognizer *)collapseGestureRecognizer {
 
     if (self.exposedLayout == nil || !self.exposedItemsAreCollapsible) return nil;
@@ -194,17 +272,15 @@
         //
         self.stackedLayout.contentOffset = self.collectionView.contentOffset;
         
-        TGLExposedLayout *exposedLayout = [[[self.class exposedLayoutClass] alloc] initWithExposedItemIndex:exposedItemIndexPath.item];
-        
-        exposedLayout.layoutMargin = self.exposedLayoutMargin;
-        exposedLayout.itemSize = self.exposedItemSize;
-        exposedLayout.topOverlap = self.exposedTopOverlap;
-        exposedLayout.bottomOverlap = self.exposedBottomOverlap;
-        exposedLayout.bottomOverlapCount = self.exposedBottomOverlapCount;
-        
-        exposedLayout.pinningMode = self.exposedPinningMode;
-        exposedLayout.topPinningCount = self.exposedTopPinningCount;
-        exposedLayout.bottomPinningCount = self.exposedBottomPinningCount;
+        // Use layout prepared on touch down
+        // if it's for the same item and
+        // still up to date
+        //
+        TGLExposedLayout *exposedLayout = self.preparedExposedLayout;
+
+        if (![self isExposedLayout:exposedLayout currentForItemAtIndexPath:exposedItemIndexPath]) exposedLayout = [self exposedLayoutForItemAtIndexPath:exposedItemIndexPath];
+
+        self.preparedExposedLayout = nil;
         
         void (^layoutcompletion) (BOOL) = ^ (BOOL finished) {
 
@@ -238,7 +314,7 @@
             layoutcompletion(YES);
         }
         
-    } else if (self.exposedItemIndexPath && exposedItemIndexPath && (exposedItemIndexPath.item != self.exposedItemIndexPath.item || self.unexposedItemsAreSelectable)) {
+    } else if (self.exposedItemIndexPath && exposedItemIndexPath && (![exposedItemIndexPath isEqual:self.exposedItemIndexPath] || self.unexposedItemsAreSelectable)) {
         
         // We have another exposed item and we expose the new one instead
         //
@@ -246,17 +322,7 @@
         
         [self removeCollapseGestureRecognizersFromView:exposedCell];
         
-        TGLExposedLayout *exposedLayout = [[TGLExposedLayout alloc] initWithExposedItemIndex:exposedItemIndexPath.item];
-        
-        exposedLayout.layoutMargin = self.exposedLayout.layoutMargin;
-        exposedLayout.itemSize = self.exposedLayout.itemSize;
-        exposedLayout.topOverlap = self.exposedLayout.topOverlap;
-        exposedLayout.bottomOverlap = self.exposedLayout.bottomOverlap;
-        exposedLayout.bottomOverlapCount = self.exposedLayout.bottomOverlapCount;
-        
-        exposedLayout.pinningMode = self.exposedLayout.pinningMode;
-        exposedLayout.topPinningCount = self.exposedLayout.topPinningCount;
-        exposedLayout.bottomPinningCount = self.exposedLayout.bottomPinningCount;
+        TGLExposedLayout *exposedLayout = [self exposedLayoutForItemAtIndexPath:exposedItemIndexPath];
         
         void (^layoutcompletion) (BOOL) = ^ (BOOL finished) {
 
@@ -336,6 +402,52 @@
     }
 }
 
+- (TGLExposedLayout *)exposedLayoutForItemAtIndexPath:(NSIndexPath *)indexPath {
+    
+    TGLExposedLayout *exposedLayout = [[[self.class exposedLayoutClass] alloc] initWithExposedItemIndexPath:indexPath];
+    
+    exposedLayout.layoutMargin = self.exposedLayoutMargin;
+    exposedLayout.itemSize = self.exposedItemSize;
+    exposedLayout.topOverlap = self.exposedTopOverlap;
+    exposedLayout.bottomOverlap = self.exposedBottomOverlap;
+    exposedLayout.bottomOverlapCount = self.exposedBottomOverlapCount;
+    
+    exposedLayout.pinningMode = self.exposedPinningMode;
+    exposedLayout.topPinningCount = self.exposedTopPinningCount;
+    exposedLayout.bottomPinningCount = self.exposedBottomPinningCount;
+    
+    exposedLayout.sizesExposedItemToFit = self.exposedItemSizesToFit;
+    exposedLayout.measuredSizeCache = self.stackedLayout.measuredSizeCache;
+
+    exposedLayout.metrics = self.layoutMetrics;
+    exposedLayout.attributesPool = self.attributesPool;
+    
+    return exposedLayout;
+}
+
+- (BOOL)isExposedLayout:(TGLExposedLayout *)exposedLayout currentForItemAtIndexPath:(NSIndexPath *)indexPath {
+
+    // Layout prepared in advance is stale
+    // if configuration changed since, while
+    // changes to the collection view are
+    // detected by the layout itself
+    //
+    return exposedLayout &&
+           [exposedLayout.exposedItemIndexPath isEqual:indexPath] &&
+           [exposedLayout isMemberOfClass:[self.class exposedLayoutClass]] &&
+           UIEdgeInsetsEqualToEdgeInsets(exposedLayout.layoutMargin, self.exposedLayoutMargin) &&
+           CGSizeEqualToSize(exposedLayout.itemSize, self.exposedItemSize) &&
+           exposedLayout.topOverlap == self.exposedTopOverlap &&
+           exposedLayout.bottomOverlap == self.exposedBottomOverlap &&
+           exposedLayout.bottomOverlapCount == self.exposedBottomOverlapCount &&
+           exposedLayout.pinningMode == self.exposedPinningMode &&
+           exposedLayout.topPinningCount == self.exposedTopPinningCount &&
+           exposedLayout.bottomPinningCount == self.exposedBottomPinningCount &&
+           exposedLayout.sizesExposedItemToFit == self.exposedItemSizesToFit &&
+           exposedLayout.measuredSizeCache == self.stackedLayout.measuredSizeCache &&
+           exposedLayout.metrics == self.layoutMetrics;
+}
+
 - (void)resetExposedItemIndexPath {
 
     // Set -exposedItemIndexPath to `nil` w/o triggering
@@ -344,20 +456,198 @@
     _exposedItemIndexPath = nil;
 }
 
+#pragma mark - Updates
+
+- (void)performUpdatesFromIdentifiers:(NSArray *)oldIdentifiers toIdentifiers:(NSArray *)newIdentifiers inSection:(NSInteger)section updates:(void (^)(void))updates completion:(void (^)(BOOL))completion {
+    
+    NSInteger oldCount = oldIdentifiers.count;
+    NSInteger newCount = newIdentifiers.count;
+    NSMutableDictionary *oldItems = [NSMutableDictionary dictionaryWithCapacity:oldCount];
+    
+    for (NSInteger item = 0; item < oldCount; item++) {
+        
+        oldItems[oldIdentifiers[item]] = @(item);
+    }
+    
+    // Match items by identifier in linear time,
+    // collecting kept items' old indices in
+    // their new order
+    //
+    long *newItems = malloc(MAX(oldCount, 1) * sizeof(long));
+    long *keptOldItems = malloc(MAX(newCount, 1) * sizeof(long));
+    long *keptNewItems = malloc(MAX(newCount, 1) * sizeof(long));
+    long keptCount = 0;
+    
+    for (NSInteger item = 0; item < oldCount; item++) newItems[item] = -1;
+
+    NSMutableArray *insertedIndexPaths = [NSMutableArray array];
+    NSMutableArray *deletedIndexPaths = [NSMutableArray array];
+    
+    for (NSInteger item = 0; item < newCount; item++) {
+        
+        NSNumber *oldItem = oldItems[newIdentifiers[item]];
+        
+        if (oldItem && newItems[oldItem.integerValue] < 0) {
+            
+            newItems[oldItem.integerValue] = item;
+            keptOldItems[keptCount] = oldItem.integerValue;
+            keptNewItems[keptCount] = item;
+            keptCount++;
+            
+        } else {
+            
+            [insertedIndexPaths addObject:[NSIndexPath indexPathForItem:item inSection:section]];
+        }
+    }
+    
+    for (NSInteger item = 0; item < oldCount; item++) {
+        
+        if (newItems[item] < 0) [deletedIndexPaths addObject:[NSIndexPath indexPathForItem:item inSection:section]];
+    }
+    
+    // Kept items not in order relative
+    // to each other have to be moved
+    //
+    bool *inOrder = malloc(MAX(keptCount, 1) * sizeof(bool));
+    NSMutableArray *movedIndexPaths = [NSMutableArray array];
+
+    TGLItemLongestIncreasingSubsequence(keptOldItems, keptCount, inOrder);
+    
+    for (long i = 0; i < keptCount; i++) {
+        
+        if (!inOrder[i]) [movedIndexPaths addObject:@[[NSIndexPath indexPathForItem:keptOldItems[i] inSection:section], [NSIndexPath indexPathForItem:keptNewItems[i] inSection:section]]];
+    }
+    
+    // Keep exposed item exposed if it
+    // survives, collapse otherwise
+    //
+    NSIndexPath *exposedItemIndexPath = self.exposedItemIndexPath;
+
+    if (exposedItemIndexPath && exposedItemIndexPath.section == section && exposedItemIndexPath.item < oldCount) {
+        
+        long newItem = newItems[exposedItemIndexPath.item];
+        
+        exposedItemIndexPath = (newItem >= 0) ? [NSIndexPath indexPathForItem:newItem inSection:section] : nil;
+    }
+
+    free(newItems);
+    free(keptOldItems);
+    free(keptNewItems);
+    free(inOrder);
+
+    if (self.exposedItemIndexPath && exposedItemIndexPath == nil) {
+        
+        [self setExposedItemIndexPath:nil animated:NO];
+    }
+    
+    if (insertedIndexPaths.count == 0 && deletedIndexPaths.count == 0 && movedIndexPaths.count == 0) {
+        
+        if (updates) updates();
+        if (completion) completion(YES);
+        
+        return;
+    }
+    
+    [self.collectionView performBatchUpdates:^ (void) {
+        
+        if (updates) updates();
+        
+        [self.collectionView deleteItemsAtIndexPaths:deletedIndexPaths];
+        [self.collectionView insertItemsAtIndexPaths:insertedIndexPaths];
+        
+        for (NSArray *move in movedIndexPaths) {
+            
+            [self.collectionView moveItemAtIndexPath:move.firstObject toIndexPath:move.lastObject];
+        }
+        
+        if (self.exposedItemIndexPath && ![exposedItemIndexPath isEqual:self.exposedItemIndexPath]) {
+            
+            self.exposedLayout.exposedItemIndexPath = exposedItemIndexPath;
+            
+            self->_exposedItemIndexPath = exposedItemIndexPath;
+        }
+        
+    } completion:completion];
+}
+
+#pragma mark - Prefetching
+
+- (NSArray<NSIndexPath *> *)indexPathsForItemsRevealedWithinFrameCount:(NSUInteger)frameCount {
+    
+    if (self.stackedLayout == nil || self.collectionView.collectionViewLayout != self.stackedLayout) return @[];
+    
+    return [self.stackedLayout indexPathsForItemsRevealedWithVelocity:self.scrollVelocity duration:[self durationOfFrameCount:frameCount]];
+}
+
+#pragma mark - Layout traces
+
+- (void)startRecordingLayoutTrace {
+    
+    [self stopRecordingLayoutTrace];
+    
+    TGLStackedLayout *stackedLayout = self.stackedLayout;
+    TGLLayoutTraceHeader header = {
+        
+        .marginTop = stackedLayout.layoutMargin.top,
+        .marginBottom = stackedLayout.layoutMargin.bottom,
+        .itemHeight = stackedLayout.itemSize.height,
+        .itemReveal = stackedLayout.topReveal,
+        .bounceFactor = stackedLayout.bounceFactor,
+        .occlusionThreshold = stackedLayout.occlusionThreshold,
+        .fillHeight = stackedLayout.isFillingHeight,
+        .centerSingleItem = stackedLayout.isCenteringSingleItem,
+        .alwaysBounce = stackedLayout.isAlwaysBouncing,
+        
+        .exposedMarginTop = self.exposedLayoutMargin.top,
+        .exposedMarginBottom = self.exposedLayoutMargin.bottom,
+        .exposedItemHeight = self.exposedItemSize.height,
+        .exposedTopOverlap = self.exposedTopOverlap,
+        .exposedBottomOverlap = self.exposedBottomOverlap,
+        .exposedBottomOverlapCount = self.exposedBottomOverlapCount,
+        .exposedPinning = (TGLExposedPinning)self.exposedPinningMode,
+        .exposedTopPinningCount = (NSInteger)self.exposedTopPinningCount,
+        .exposedBottomPinningCount = (NSInteger)self.exposedBottomPinningCount
+    };
+    
+    unsigned char bytes[TGLLayoutTraceHeaderSize];
+    
+    TGLLayoutTraceEncodeHeader(&header, bytes);
+    TGLLayoutTraceFrameInit(&_layoutTraceFrame);
+    
+    self.layoutTrace = [NSMutableData dataWithBytes:bytes length:sizeof(bytes)];
+    self.layoutTraceStartTime = CACurrentMediaTime();
+    
+    // Display link retains the controller
+    // until `-stopRecordingLayoutTrace`
+    //
+    self.layoutTraceDisplayLink = [CADisplayLink displayLinkWithTarget:self selector:@selector(handleLayoutTraceDisplayLink:)];
+    
+    [self.layoutTraceDisplayLink addToRunLoop:NSRunLoop.mainRunLoop forMode:NSRunLoopCommonModes];
+}
+
+- (NSData *)stopRecordingLayoutTrace {
+    
+    NSData *trace = self.layoutTrace;
+    
+    [self.layoutTraceDisplayLink invalidate];
+    
+    self.layoutTraceDisplayLink = nil;
+    self.layoutTrace = nil;
+    
+    return trace;
+}
+
 #pragma mark - Actions
 
 - (IBAction)handleMovePressGesture:(UILongPressGestureRecognizer *)recognizer {
     
-    static CGPoint startLocation;
-    static CGPoint targetPosition;
-    
     switch (recognizer.state) {
             
         case UIGestureRecognizerStateBegan: {
             
-            startLocation = [recognizer locationInView:self.collectionView];
+            self.moveStartLocation = [recognizer locationInView:self.collectionView];
 
-            NSIndexPath *indexPath = [self.collectionView indexPathForItemAtPoint:startLocation];
+            NSIndexPath *indexPath = [self.collectionView indexPathForItemAtPoint:self.moveStartLocation];
 
             self.stackedLayout.movingItemScaleFactor = self.movingItemScaleFactor;
             self.stackedLayout.movingItemOnTop = self.movingItemOnTop;
@@ -366,9 +656,11 @@
 
                 UICollectionViewCell *movingCell = [self.collectionView cellForItemAtIndexPath:indexPath];
                 
-                targetPosition = movingCell.center;
+                self.moveStartTargetPosition = movingCell.center;
 
-                [self.collectionView updateInteractiveMovementTargetPosition:targetPosition];
+                [self.collectionView updateInteractiveMovementTargetPosition:self.moveStartTargetPosition];
+                
+                self.moveTargetPosition = self.moveStartTargetPosition;
                 
                 self.movingIndexPath = indexPath;
             }
@@ -381,11 +673,13 @@
             if (self.movingIndexPath) {
 
                 CGPoint currentLocation = [recognizer locationInView:self.collectionView];
-                CGPoint newTargetPosition = targetPosition;
+                CGPoint newTargetPosition = self.moveStartTargetPosition;
                 
-                newTargetPosition.y += (currentLocation.y - startLocation.y);
+                newTargetPosition.y += (currentLocation.y - self.moveStartLocation.y);
 
                 [self.collectionView updateInteractiveMovementTargetPosition:newTargetPosition];
+                
+                self.moveTargetPosition = newTargetPosition;
             }
 
             break;
@@ -396,7 +690,6 @@
             if (self.movingIndexPath) {
 
                 [self.collectionView endInteractiveMovement];
-                [self.stackedLayout invalidateLayout];
                 
                 self.movingIndexPath = nil;
             }
@@ -409,7 +702,6 @@
             if (self.movingIndexPath) {
 
                 [self.collectionView cancelInteractiveMovement];
-                [self.stackedLayout invalidateLayout];
                 
                 self.movingIndexPath = nil;
             }
@@ -425,9 +717,6 @@
 
 - (IBAction)handleCollapsePanGesture:(UIPanGestureRecognizer *)recognizer {
     
-    static CGFloat transitionMaxThreshold;
-    static CGFloat transitionMinThreshold;
-    
     switch (recognizer.state) {
             
         case UIGestureRecognizerStateBegan: {
@@ -456,6 +745,8 @@
                         [weakSelf resetExposedItemIndexPath];
                     }
                     
+                    [weakSelf stopCollapseProgressUpdates];
+
                     // Issue #37: Re-allow item interaction when
                     //            interactive transition is done
                     //
@@ -463,8 +754,10 @@
                     weakSelf.finishingInteractiveTransition = NO;
                 }];
                 
-                transitionMaxThreshold = (self.collapsePanMaximumThreshold > 0.0) ? self.collapsePanMaximumThreshold : CGRectGetHeight(exposedCell.bounds);
-                transitionMinThreshold = MAX(self.collapsePanMinimumThreshold, 0.0);
+                self.collapsePanMaximumTranslation = (self.collapsePanMaximumThreshold > 0.0) ? self.collapsePanMaximumThreshold : CGRectGetHeight(exposedCell.bounds);
+                self.collapsePanMinimumTranslation = MAX(self.collapsePanMinimumThreshold, 0.0);
+
+                [self startCollapseProgressUpdates];
             }
 
             break;
@@ -478,7 +771,7 @@
 
                 if (currentOffset.y >= 0.0) {
                     
-                    self.transitionLayout.transitionProgress = MIN(currentOffset.y, transitionMaxThreshold) / transitionMaxThreshold;
+                    [self addCollapseProgress:MIN(currentOffset.y, self.collapsePanMaximumTranslation) / self.collapsePanMaximumTranslation];
                 }
             }
 
@@ -489,6 +782,8 @@
             
             if (self.transitionLayout && self.collectionView.collectionViewLayout == self.transitionLayout && !self.isFinishingInteractiveTransition) {
                 
+                [self stopCollapseProgressUpdates];
+
                 // Issue #37: Prevent item interaction while
                 //            interactive transition is finishing
                 //
@@ -497,7 +792,7 @@
                 CGPoint currentOffset = [recognizer translationInView:self.collectionView];
                 CGPoint currentSpeed = [recognizer velocityInView:self.collectionView];
                 
-                if (currentOffset.y >= transitionMinThreshold && currentSpeed.y >= 0.0) {
+                if (currentOffset.y >= self.collapsePanMinimumTranslation && currentSpeed.y >= 0.0) {
                     
                     [self.collectionView deselectItemAtIndexPath:self.exposedItemIndexPath animated:YES];
                     [self.collectionView finishInteractiveTransition];
@@ -515,6 +810,8 @@
             
             if (self.transitionLayout && self.collectionView.collectionViewLayout == self.transitionLayout && !self.isFinishingInteractiveTransition) {
                 
+                [self stopCollapseProgressUpdates];
+
                 // Issue #37: Prevent item interaction while
                 //            interactive transition is finishing
                 //
@@ -534,8 +831,6 @@
 
 - (IBAction)handleCollapsePinchGesture:(UIPinchGestureRecognizer *)recognizer {
     
-    static CGFloat transitionMinThreshold;
-
     switch (recognizer.state) {
             
         case UIGestureRecognizerStateBegan: {
@@ -564,6 +859,8 @@
                         [weakSelf resetExposedItemIndexPath];
                     }
                     
+                    [weakSelf stopCollapseProgressUpdates];
+
                     // Issue #37: Re-allow item selection when
                     //            interactive transition is done
                     //
@@ -571,11 +868,13 @@
                     weakSelf.finishingInteractiveTransition = NO;
                 }];
                 
-                transitionMinThreshold = weakSelf.collapsePinchMinimumThreshold;
+                CGFloat minimumThreshold = weakSelf.collapsePinchMinimumThreshold;
                 
-                if (transitionMinThreshold < 0.0) transitionMinThreshold = 0.0; else if (transitionMinThreshold > 1.0) transitionMinThreshold = 1.0;
+                if (minimumThreshold < 0.0) minimumThreshold = 0.0; else if (minimumThreshold > 1.0) minimumThreshold = 1.0;
+
+                self.collapsePinchMaximumScale = 1.0 - minimumThreshold;
 
-                transitionMinThreshold = 1.0 - transitionMinThreshold;
+                [self startCollapseProgressUpdates];
             }
 
             break;
@@ -589,7 +888,7 @@
 
                 if (currentScale >= 0.0 && currentScale <= 1.0) {
                     
-                    self.transitionLayout.transitionProgress = 1.0 - currentScale;
+                    [self addCollapseProgress:1.0 - currentScale];
                 }
             }
             
@@ -600,6 +899,8 @@
             
             if (self.transitionLayout && self.collectionView.collectionViewLayout == self.transitionLayout && !self.isFinishingInteractiveTransition) {
                 
+                [self stopCollapseProgressUpdates];
+
                 // Issue #37: Prevent item interaction while
                 //            interactive transition is finishing
                 //
@@ -608,7 +909,7 @@
                 CGFloat currentScale = recognizer.scale;
                 CGFloat currentSpeed = recognizer.velocity;
 
-                if (currentScale <= transitionMinThreshold && currentSpeed <= 0.0) {
+                if (currentScale <= self.collapsePinchMaximumScale && currentSpeed <= 0.0) {
                 
                     [self.collectionView deselectItemAtIndexPath:self.exposedItemIndexPath animated:YES];
                     [self.collectionView finishInteractiveTransition];
@@ -626,6 +927,8 @@
             
             if (self.transitionLayout && self.collectionView.collectionViewLayout == self.transitionLayout && !self.isFinishingInteractiveTransition) {
                 
+                [self stopCollapseProgressUpdates];
+
                 // Issue #37: Prevent item interaction while
                 //            interactive transition is finishing
                 //
@@ -643,6 +946,54 @@
     }
 }
 
+- (void)handleCollapseDisplayLink:(CADisplayLink *)displayLink {
+
+    CFTimeInterval targetTimestamp = displayLink.timestamp + displayLink.duration;
+
+    if (@available(iOS 10, *)) {
+
+        targetTimestamp = displayLink.targetTimestamp;
+    }
+
+    double progress;
+
+    if (TGLProgressCoalescerTick(&_collapseProgressCoalescer, targetTimestamp, self.collapsePredictionInterval, &progress)) {
+
+        if (self.transitionLayout && self.collectionView.collectionViewLayout == self.transitionLayout && !self.isFinishingInteractiveTransition) {
+
+            self.transitionLayout.transitionProgress = progress;
+        }
+    }
+}
+
+- (void)handleLayoutTraceDisplayLink:(CADisplayLink *)displayLink {
+    
+    UICollectionView *collectionView = self.collectionView;
+    NSIndexPath *movingIndexPath = self.movingIndexPath ?: (self.isDragging ? self.dragSourceIndexPath : nil);
+    BOOL transitioning = (self.transitionLayout && collectionView.collectionViewLayout == self.transitionLayout);
+    
+    TGLLayoutTraceFrame frame = {
+        
+        .time = displayLink.timestamp - self.layoutTraceStartTime,
+        .contentOffset = collectionView.contentOffset.y,
+        .boundsWidth = CGRectGetWidth(collectionView.bounds),
+        .boundsHeight = CGRectGetHeight(collectionView.bounds),
+        .contentInsetTop = collectionView.contentInset.top,
+        .contentInsetBottom = collectionView.contentInset.bottom,
+        .itemCount = [self numberOfItems],
+        .transitionProgress = transitioning ? self.transitionLayout.transitionProgress : -1.0,
+        .exposedItem = [self layoutTraceItemForIndexPath:self.exposedItemIndexPath],
+        .movingItem = [self layoutTraceItemForIndexPath:movingIndexPath],
+        .moveTargetX = self.moveTargetPosition.x,
+        .moveTargetY = self.moveTargetPosition.y
+    };
+    
+    unsigned char bytes[TGLLayoutTraceMaxFrameSize];
+    size_t length = TGLLayoutTraceEncodeFrame(&frame, &_layoutTraceFrame, bytes);
+    
+    if (length > 0) [self.layoutTrace appendBytes:bytes length:length];
+}
+
 #pragma mark - UICollectionViewDelegate protocol
 
 - (BOOL)collectionView:(UICollectionView *)collectionView shouldHighlightItemAtIndexPath:(NSIndexPath *)indexPath {
@@ -655,7 +1006,41 @@
     //
     //      NOTE: Prevent selection while drag is in progress, too.
     //
-    return (self.exposedItemIndexPath == nil || indexPath.item == self.exposedItemIndexPath.item || self.unexposedItemsAreSelectable) && self.transitionLayout == nil && !self.isDragging;
+    return (self.exposedItemIndexPath == nil || [indexPath isEqual:self.exposedItemIndexPath] || self.unexposedItemsAreSelectable) && self.transitionLayout == nil && !self.isDragging;
+}
+
+- (void)collectionView:(UICollectionView *)collectionView didHighlightItemAtIndexPath:(NSIndexPath *)indexPath {
+    
+    // Item is highlighted on touch down, so
+    // prepare exposed layout while waiting
+    // for touch up to select it
+    //
+    if (self.exposedItemIndexPath == nil && collectionView.collectionViewLayout == self.stackedLayout) {
+        
+        self.preparedExposedLayout = [self exposedLayoutForItemAtIndexPath:indexPath];
+        
+        [self.preparedExposedLayout prepareLayoutForCollectionView:collectionView];
+    }
+}
+
+- (void)collectionView:(UICollectionView *)collectionView didUnhighlightItemAtIndexPath:(NSIndexPath *)indexPath {
+
+    // Item is unhighlighted right before it is
+    // selected on touch up, so keep the layout
+    // prepared on touch down until selection
+    // was handled, but no longer when the touch
+    // was cancelled
+    //
+    TGLExposedLayout *preparedExposedLayout = self.preparedExposedLayout;
+
+    if (preparedExposedLayout == nil) return;
+
+    __weak typeof(self) weakSelf = self;
+
+    dispatch_async(dispatch_get_main_queue(), ^{
+
+        if (weakSelf.preparedExposedLayout == preparedExposedLayout) weakSelf.preparedExposedLayout = nil;
+    });
 }
 
 - (void)collectionView:(UICollectionView *)collectionView didDeselectItemAtIndexPath:(NSIndexPath *)indexPath {
@@ -664,7 +1049,7 @@
     // make sure the currently exposed item remains
     // selected
     //
-    if (self.exposedItemIndexPath && indexPath.item == self.exposedItemIndexPath.item) {
+    if (self.exposedItemIndexPath && [indexPath isEqual:self.exposedItemIndexPath]) {
         
         [collectionView selectItemAtIndexPath:indexPath animated:NO scrollPosition:UICollectionViewScrollPositionNone];
     }
@@ -672,7 +1057,7 @@
 
 - (void)collectionView:(UICollectionView *)collectionView didSelectItemAtIndexPath:(NSIndexPath *)indexPath {
     
-    if (self.exposedItemIndexPath && indexPath.item == self.exposedItemIndexPath.item) {
+    if (self.exposedItemIndexPath && [indexPath isEqual:self.exposedItemIndexPath]) {
 
         self.exposedItemIndexPath = nil;
 
@@ -682,26 +1067,75 @@
     }
 }
 
+- (UICollectionViewTransitionLayout *)collectionView:(UICollectionView *)collectionView transitionLayoutForOldLayout:(UICollectionViewLayout *)fromLayout newLayout:(UICollectionViewLayout *)toLayout {
+    
+    // Interpolate moving items only when
+    // collapsing interactively
+    //
+    return [[[self.class transitionLayoutClass] alloc] initWithCurrentLayout:fromLayout nextLayout:toLayout];
+}
+
+#pragma mark - UIScrollViewDelegate protocol
+
+- (void)scrollViewDidScroll:(UIScrollView *)scrollView {
+    
+    // Estimate velocity from content offset
+    // changes, since pan gesture's velocity
+    // is not available while decelerating
+    //
+    CFTimeInterval timestamp = CACurrentMediaTime();
+    CFTimeInterval interval = timestamp - self.lastScrollTimestamp;
+    CGFloat offset = scrollView.contentOffset.y;
+
+    if (interval > 0.0 && interval < 0.1) {
+        
+        // Smooth out uneven frame intervals
+        //
+        self.scrollVelocity = 0.5 * self.scrollVelocity + 0.5 * (offset - self.lastScrollOffset) / interval;
+
+    } else {
+        
+        self.scrollVelocity = 0.0;
+    }
+    
+    self.lastScrollOffset = offset;
+    self.lastScrollTimestamp = timestamp;
+
+    [self updatePrefetching];
+    [self updateWindowedDataSource];
+}
+
+- (void)scrollViewDidEndDecelerating:(UIScrollView *)scrollView {
+    
+    self.scrollVelocity = 0.0;
+}
+
+- (void)scrollViewDidEndDragging:(UIScrollView *)scrollView willDecelerate:(BOOL)decelerate {
+    
+    if (!decelerate) self.scrollVelocity = 0.0;
+}
+
 #pragma mark - UICollectionViewDataSource protocol
 
 - (NSInteger)numberOfSectionsInCollectionView:(UICollectionView *)collectionView {
     
-    // Currently, only one single section is
-    // supported, therefore MUST NOT be != 1
+    // Default to one single section, subclasses
+    // may return more which are then stacked one
+    // after another
     //
     return 1;
 }
 
 - (BOOL)collectionView:(UICollectionView *)collectionView canMoveItemAtIndexPath:(NSIndexPath *)indexPath {
 
-    return (self.exposedLayout == nil && [self collectionView:self.collectionView numberOfItemsInSection:0] > 1);
+    return (self.exposedLayout == nil && [self numberOfItems] > 1);
 }
 
 #pragma mark - UICollectionViewDragDelegate protocol
 
 - (NSArray<UIDragItem *> *)collectionView:(UICollectionView *)collectionView itemsForBeginningDragSession:(id<UIDragSession>)session atIndexPath:(NSIndexPath *)indexPath NS_AVAILABLE_IOS(11) {
 
-    if (self.exposedLayout == nil && [self collectionView:self.collectionView numberOfItemsInSection:0] > 1) {
+    if (self.exposedLayout == nil && [self numberOfItems] > 1) {
 
         self.dragSourceIndexPath = indexPath;
 
@@ -719,11 +1153,17 @@
 - (void)collectionView:(UICollectionView *)collectionView dragSessionWillBegin:(id<UIDragSession>)session NS_AVAILABLE_IOS(11) {
 
     self.dragging = YES;
+
+    self.stackedLayout.movingItemOnTop = self.movingItemOnTop;
+
+    [self.stackedLayout beginReorderingItemAtIndexPath:self.dragSourceIndexPath];
 }
 
 - (void)collectionView:(UICollectionView *)collectionView dragSessionDidEnd:(id<UIDragSession>)session NS_AVAILABLE_IOS(11) {
 
     self.dragging = NO;
+
+    [self.stackedLayout endReordering];
 }
 
 #pragma mark - UICollectionViewDropDelegate protocol
@@ -732,6 +1172,8 @@
 
     UIDropOperation operation = session.localDragSession ? UIDropOperationMove : UIDropOperationCopy;
 
+    self.moveTargetPosition = [session locationInView:collectionView];
+
     return [[UICollectionViewDropProposal alloc] initWithDropOperation:operation intent:UICollectionViewDropIntentInsertAtDestinationIndexPath];
 }
 
@@ -760,6 +1202,8 @@
             destinationIndexPath = [NSIndexPath indexPathForItem:([collectionView numberOfItemsInSection:destinationIndexPath.section] - 1) inSection:destinationIndexPath.section];
         }
 
+        [self.stackedLayout endReordering];
+
         [collectionView performBatchUpdates:^() {
 
             [collectionView deleteItemsAtIndexPaths:@[item.sourceIndexPath]];
@@ -783,16 +1227,154 @@
     //
     if (self.dragSourceIndexPath != nil) {
 
-        // KLUDGE: Reload item to force correct layout
-        //         -- esp. regarding zIndex
+        // Restoring item's z ordering changes
+        // its attributes, so that they are
+        // applied to its cell again
         //
-        [self.collectionView reloadItemsAtIndexPaths:@[self.dragSourceIndexPath]];
+        [self.stackedLayout endReordering];
+
         self.dragSourceIndexPath = nil;
     }
 }
 
 #pragma mark - Helpers
 
+- (NSInteger)numberOfItems {
+    
+    NSInteger numberOfSections = [self numberOfSectionsInCollectionView:self.collectionView];
+    NSInteger numberOfItems = 0;
+    
+    for (NSInteger section = 0; section < numberOfSections; section++) {
+        
+        numberOfItems += [self collectionView:self.collectionView numberOfItemsInSection:section];
+    }
+    
+    return numberOfItems;
+}
+
+- (long)layoutTraceItemForIndexPath:(NSIndexPath *)indexPath {
+    
+    if (indexPath == nil) return -1;
+    
+    // Global index, i.e. position in
+    // concatenation of all sections
+    //
+    long item = indexPath.item;
+    
+    for (NSInteger section = 0; section < indexPath.section; section++) {
+        
+        item += [self.collectionView numberOfItemsInSection:section];
+    }
+    
+    return item;
+}
+
+- (void)updatePrefetching {
+    
+    if (@available(iOS 10, *)) {
+        
+        id<UICollectionViewDataSourcePrefetching> prefetchDataSource = self.collectionView.prefetchDataSource;
+
+        if (prefetchDataSource == nil || self.prefetchFrameCount == 0) return;
+        
+        NSArray *predictedIndexPaths = [self indexPathsForItemsRevealedWithinFrameCount:self.prefetchFrameCount];
+        NSMutableArray *prefetchIndexPaths = [NSMutableArray array];
+        NSMutableArray *cancelIndexPaths = [NSMutableArray array];
+
+        for (NSIndexPath *indexPath in predictedIndexPaths) {
+            
+            if (![self.prefetchedIndexPaths containsObject:indexPath]) [prefetchIndexPaths addObject:indexPath];
+        }
+        
+        // Items no longer predicted either became
+        // visible, then prefetching is complete,
+        // or scrolling changed direction
+        //
+        NSSet *predictedSet = [NSSet setWithArray:predictedIndexPaths];
+
+        for (NSIndexPath *indexPath in self.prefetchedIndexPaths) {
+            
+            if (![predictedSet containsObject:indexPath] && [self.collectionView cellForItemAtIndexPath:indexPath] == nil) [cancelIndexPaths addObject:indexPath];
+        }
+        
+        [self.prefetchedIndexPaths setSet:predictedSet];
+
+        if (cancelIndexPaths.count > 0 && [prefetchDataSource respondsToSelector:@selector(collectionView:cancelPrefetchingForItemsAtIndexPaths:)]) {
+            
+            [prefetchDataSource collectionView:self.collectionView cancelPrefetchingForItemsAtIndexPaths:cancelIndexPaths];
+        }
+
+        if (prefetchIndexPaths.count > 0) {
+            
+            [prefetchDataSource collectionView:self.collectionView prefetchItemsAtIndexPaths:prefetchIndexPaths];
+        }
+    }
+}
+
+- (void)startCollapseProgressUpdates {
+
+    [self.collapseDisplayLink invalidate];
+
+    TGLProgressCoalescerReset(&_collapseProgressCoalescer, self.transitionLayout.transitionProgress);
+
+    // Display link retains the controller
+    // until `-stopCollapseProgressUpdates`
+    //
+    self.collapseDisplayLink = [CADisplayLink displayLinkWithTarget:self selector:@selector(handleCollapseDisplayLink:)];
+
+    [self.collapseDisplayLink addToRunLoop:NSRunLoop.mainRunLoop forMode:NSRunLoopCommonModes];
+}
+
+- (void)addCollapseProgress:(CGFloat)progress {
+
+    TGLProgressCoalescerAddInput(&_collapseProgressCoalescer, progress, CACurrentMediaTime());
+}
+
+- (void)stopCollapseProgressUpdates {
+
+    if (self.collapseDisplayLink == nil) return;
+
+    [self.collapseDisplayLink invalidate];
+    self.collapseDisplayLink = nil;
+
+    // Finish or cancel from the actual gesture
+    // progress instead of a predicted one
+    //
+    if (self.transitionLayout && self.collectionView.collectionViewLayout == self.transitionLayout && self.transitionLayout.transitionProgress != _collapseProgressCoalescer.progress) {
+
+        self.transitionLayout.transitionProgress = _collapseProgressCoalescer.progress;
+    }
+}
+
+- (NSTimeInterval)durationOfFrameCount:(NSUInteger)frameCount {
+    
+    NSInteger framesPerSecond = 60;
+    
+    if (@available(iOS 10.3, *)) {
+        
+        if (self.view.window.screen.maximumFramesPerSecond > 0) framesPerSecond = self.view.window.screen.maximumFramesPerSecond;
+    }
+    
+    return (NSTimeInterval)frameCount / framesPerSecond;
+}
+
+- (void)updateWindowedDataSource {
+    
+    if (self.windowedDataSource == nil || self.stackedLayout == nil || self.collectionView.collectionViewLayout != self.stackedLayout) return;
+    
+    NSRange visibleRange = [self.stackedLayout visibleItemRange];
+    NSRange prefetchRange = visibleRange;
+    
+    if (visibleRange.location != NSNotFound && self.prefetchFrameCount > 0) {
+        
+        NSRange revealedRange = [self.stackedLayout itemRangeRevealedWithVelocity:self.scrollVelocity duration:[self durationOfFrameCount:self.prefetchFrameCount]];
+        
+        if (revealedRange.location != NSNotFound) prefetchRange = NSUnionRange(visibleRange, revealedRange);
+    }
+    
+    [self.windowedDataSource updateVisibleItemRange:visibleRange prefetchItemRange:prefetchRange];
+}
+
 - (void)addCollapseGestureRecognizerToView:(UIView *)view {
     
     UIGestureRecognizer *recognizer = self.collapseGestureRecognizer;
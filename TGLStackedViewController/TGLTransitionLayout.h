@@ -0,0 +1,45 @@
+//
+//  TGLTransitionLayout.h
+//  TGLStackedViewController
+//
+//  Created by Tim Gleue on 17.10.26.
+//  Copyright (c) 2026 Tim Gleue ( http://gleue-interactive.com )
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+#import <UIKit/UIKit.h>
+
+/** Transition layout interpolating only items that
+ *  actually change between both layouts.
+ *
+ * Items visible in either layout are collected once when
+ * the transition starts. Start and end frames, alphas,
+ * transforms and z-indices of items where any of them
+ * differ are kept in flat arrays and are interpolated on
+ * every change of `-transitionProgress`. Items hidden at
+ * one end fade in or out. All other items keep their
+ * final attributes, and items invisible in both layouts
+ * are skipped entirely.
+ */
+@interface TGLTransitionLayout : UICollectionViewTransitionLayout
+
+/** Number of items whose attributes are interpolated */
+@property (nonatomic, readonly) NSUInteger interpolatedItemCount;
+
+@end
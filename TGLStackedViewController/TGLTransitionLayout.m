@@ -0,0 +1,257 @@
+//
+//  TGLTransitionLayout.m
+//  TGLStackedViewController
+//
+//  Created by Tim Gleue on 17.10.26.
+//  Copyright (c) 2026 Tim Gleue ( http://gleue-interactive.com )
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+#import "TGLTransitionLayout.h"
+
+// Attributes of an item interpolated
+// during transition
+//
+typedef struct {
+
+    CGRect frame;
+    CGFloat alpha;              // 0.0 if hidden
+    CATransform3D transform;
+    NSInteger zIndex;
+
+} TGLTransitionItemState;
+
+@interface TGLTransitionLayout () {
+
+    // Start and end states of items changing
+    // during transition, i.e. the first
+    // -interpolatedItemCount in -itemAttributes
+    //
+    TGLTransitionItemState *_startStates;
+    TGLTransitionItemState *_endStates;
+}
+
+@property (nonatomic, assign) NSUInteger interpolatedItemCount;
+
+// Attributes of all items visible in either
+// layout, changing items first. Attributes of
+// changing items are interpolated in place
+//
+@property (nonatomic, copy) NSArray *itemAttributes;
+@property (nonatomic, copy) NSDictionary *itemIndices;
+
+@property (nonatomic, assign) BOOL preparedItems;
+@property (nonatomic, assign) CGFloat interpolatedProgress;
+
+@end
+
+@implementation TGLTransitionLayout
+
+- (void)dealloc {
+
+    free(_startStates);
+    free(_endStates);
+}
+
+#pragma mark - Layout computation
+
+- (void)prepareLayout {
+
+    [super prepareLayout];
+
+    if (!self.preparedItems) {
+
+        [self prepareItems];
+
+        self.preparedItems = YES;
+    }
+
+    [self interpolateItems];
+}
+
+- (NSArray *)layoutAttributesForElementsInRect:(CGRect)rect {
+
+    NSMutableArray *layoutAttributes = [NSMutableArray arrayWithCapacity:self.itemAttributes.count];
+
+    for (UICollectionViewLayoutAttributes *attributes in self.itemAttributes) {
+
+        if (CGRectIntersectsRect(rect, attributes.frame)) {
+
+            [layoutAttributes addObject:attributes];
+        }
+    }
+
+    return layoutAttributes;
+}
+
+- (UICollectionViewLayoutAttributes *)layoutAttributesForItemAtIndexPath:(NSIndexPath *)indexPath {
+
+    NSNumber *index = self.itemIndices[indexPath];
+
+    if (index) return self.itemAttributes[index.unsignedIntegerValue];
+
+    // Items invisible at both ends are
+    // not animated, so they may as well
+    // jump to their final attributes
+    //
+    return [self.nextLayout layoutAttributesForItemAtIndexPath:indexPath];
+}
+
+#pragma mark - Helpers
+
+- (void)prepareItems {
+
+    UICollectionViewLayout *currentLayout = self.currentLayout;
+    UICollectionViewLayout *nextLayout = self.nextLayout;
+
+    // Collect items visible in either layout
+    // where layouts may overwrite content
+    // offset, e.g. the exposed layout
+    //
+    CGRect currentRect = self.collectionView.bounds;
+    CGRect nextRect = currentRect;
+
+    nextRect.origin = [nextLayout targetContentOffsetForProposedContentOffset:currentRect.origin];
+
+    NSMutableOrderedSet *indexPaths = [NSMutableOrderedSet orderedSet];
+
+    for (UICollectionViewLayoutAttributes *attributes in [currentLayout layoutAttributesForElementsInRect:currentRect]) {
+
+        if (attributes.representedElementCategory == UICollectionElementCategoryCell && !attributes.hidden) [indexPaths addObject:attributes.indexPath];
+    }
+
+    for (UICollectionViewLayoutAttributes *attributes in [nextLayout layoutAttributesForElementsInRect:nextRect]) {
+
+        if (attributes.representedElementCategory == UICollectionElementCategoryCell && !attributes.hidden) [indexPaths addObject:attributes.indexPath];
+    }
+
+    NSMutableArray *changingAttributes = [NSMutableArray arrayWithCapacity:indexPaths.count];
+    NSMutableArray *staticAttributes = [NSMutableArray arrayWithCapacity:indexPaths.count];
+
+    free(_startStates);
+    free(_endStates);
+
+    _startStates = malloc(MAX(indexPaths.count, 1) * sizeof(TGLTransitionItemState));
+    _endStates = malloc(MAX(indexPaths.count, 1) * sizeof(TGLTransitionItemState));
+
+    for (NSIndexPath *indexPath in indexPaths) {
+
+        UICollectionViewLayoutAttributes *startAttributes = [currentLayout layoutAttributesForItemAtIndexPath:indexPath];
+        UICollectionViewLayoutAttributes *endAttributes = [nextLayout layoutAttributesForItemAtIndexPath:indexPath];
+
+        if (endAttributes == nil) endAttributes = startAttributes;
+        if (startAttributes == nil) startAttributes = endAttributes;
+
+        // Copy since layouts recycle their
+        // attributes between passes. Items
+        // hidden at one end fade in or out
+        // instead
+        //
+        UICollectionViewLayoutAttributes *attributes = [endAttributes copy];
+        TGLTransitionItemState startState = [self stateOfAttributes:startAttributes];
+        TGLTransitionItemState endState = [self stateOfAttributes:endAttributes];
+
+        attributes.hidden = startAttributes.hidden && endAttributes.hidden;
+
+        if (CGRectEqualToRect(startState.frame, endState.frame) && startState.alpha == endState.alpha && CATransform3DEqualToTransform(startState.transform, endState.transform) && startState.zIndex == endState.zIndex) {
+
+            [staticAttributes addObject:attributes];
+
+        } else {
+
+            _startStates[changingAttributes.count] = startState;
+            _endStates[changingAttributes.count] = endState;
+
+            [changingAttributes addObject:attributes];
+        }
+    }
+
+    NSMutableDictionary *itemIndices = [NSMutableDictionary dictionaryWithCapacity:indexPaths.count];
+
+    self.interpolatedItemCount = changingAttributes.count;
+    self.itemAttributes = [changingAttributes arrayByAddingObjectsFromArray:staticAttributes];
+
+    [self.itemAttributes enumerateObjectsUsingBlock:^(UICollectionViewLayoutAttributes *attributes, NSUInteger index, BOOL *stop) {
+
+        itemIndices[attributes.indexPath] = @(index);
+    }];
+
+    self.itemIndices = itemIndices;
+
+    // Force interpolation on first pass
+    //
+    self.interpolatedProgress = -1.0;
+}
+
+- (TGLTransitionItemState)stateOfAttributes:(UICollectionViewLayoutAttributes *)attributes {
+
+    TGLTransitionItemState state;
+
+    state.frame = attributes.frame;
+    state.alpha = attributes.hidden ? 0.0 : attributes.alpha;
+    state.transform = attributes.transform3D;
+    state.zIndex = attributes.zIndex;
+
+    return state;
+}
+
+- (void)interpolateItems {
+
+    CGFloat progress = self.transitionProgress;
+
+    if (progress == self.interpolatedProgress) return;
+
+    NSUInteger count = self.interpolatedItemCount;
+
+    for (NSUInteger i = 0; i < count; i++) {
+
+        const TGLTransitionItemState *start = &_startStates[i];
+        const TGLTransitionItemState *end = &_endStates[i];
+        UICollectionViewLayoutAttributes *attributes = self.itemAttributes[i];
+
+        attributes.frame = CGRectMake(start->frame.origin.x + progress * (end->frame.origin.x - start->frame.origin.x),
+                                      start->frame.origin.y + progress * (end->frame.origin.y - start->frame.origin.y),
+                                      start->frame.size.width + progress * (end->frame.size.width - start->frame.size.width),
+                                      start->frame.size.height + progress * (end->frame.size.height - start->frame.size.height));
+
+        attributes.alpha = start->alpha + progress * (end->alpha - start->alpha);
+
+        // Transforms are interpolated component
+        // wise, which is exact for translations
+        // and scales as used by layouts
+        //
+        const CGFloat *startTransform = (const CGFloat *)&start->transform;
+        const CGFloat *endTransform = (const CGFloat *)&end->transform;
+        CATransform3D transform;
+        CGFloat *components = (CGFloat *)&transform;
+
+        for (NSUInteger j = 0; j < 16; j++) components[j] = startTransform[j] + progress * (endTransform[j] - startTransform[j]);
+
+        attributes.transform3D = transform;
+
+        // Items keep their stacking order until
+        // half way, then switch to the final one
+        //
+        attributes.zIndex = (progress < 0.5) ? start->zIndex : end->zIndex;
+    }
+
+    self.interpolatedProgress = progress;
+}
+
+@end
@@ -0,0 +1,90 @@
+//
+//  TGLWindowedDataSource.h
+//  TGLStackedViewController
+//
+//  Created by Tim Gleue on 17.10.26.
+//  Copyright (c) 2026 Tim Gleue ( http://gleue-interactive.com )
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/** Reads `count` records starting at `firstRecord` into `buffer`, returns `NO` on error */
+typedef BOOL (^TGLWindowedDataSourceReadBlock)(NSInteger firstRecord, NSInteger count, void *buffer);
+
+/** Window of fixed-size records for stacks too large to keep in memory.
+ *
+ * Records are read in pages from a memory-mapped file or
+ * a paging block. Only `-pageCapacity` pages are resident,
+ * and pages farthest from the visible item range are
+ * evicted first, so memory use does not depend on the
+ * number of records.
+ *
+ * Records are addressed by global item index, i.e. their
+ * position in the concatenation of all sections. Set the
+ * instance as `TGLStackedViewController`'s -windowedDataSource
+ * to move the window along with the stacked layout's
+ * visible items. Use from the main thread only.
+ */
+@interface TGLWindowedDataSource : NSObject
+
+/** Number of records */
+@property (nonatomic, readonly) NSInteger recordCount;
+
+/** Size of each record in bytes */
+@property (nonatomic, readonly) NSUInteger recordLength;
+
+/** Number of records per page. Default is 64
+ *
+ * Changing page size or capacity evicts all pages.
+ */
+@property (nonatomic, assign) NSInteger pageRecordCount;
+
+/** Maximum number of resident pages. Default is 16 */
+@property (nonatomic, assign) NSInteger pageCapacity;
+
+/** Number of bytes allocated for resident records */
+@property (nonatomic, readonly) NSUInteger residentLength;
+
+/** Reads records from a memory-mapped file.
+ *
+ * Records start after `headerLength` bytes. Returns `nil`
+ * if the file cannot be mapped.
+ */
+- (nullable instancetype)initWithContentsOfFile:(NSString *)path headerLength:(NSUInteger)headerLength recordLength:(NSUInteger)recordLength;
+
+/** Reads records from `readBlock` */
+- (instancetype)initWithRecordCount:(NSInteger)recordCount recordLength:(NSUInteger)recordLength readBlock:(TGLWindowedDataSourceReadBlock)readBlock;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/** Returns a copy of the record at `index`, reading its page if not resident, or `nil` on error */
+- (nullable NSData *)recordAtIndex:(NSInteger)index;
+
+/** Moves the window to items in `visibleRange` and reads pages of items in `prefetchRange` ahead */
+- (void)updateVisibleItemRange:(NSRange)visibleRange prefetchItemRange:(NSRange)prefetchRange;
+
+/** Evicts all resident pages, e.g. after the underlying records changed */
+- (void)removeAllRecords;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,157 @@
+//
+//  TGLWindowedDataSource.m
+//  TGLStackedViewController
+//
+//  Created by Tim Gleue on 17.10.26.
+//  Copyright (c) 2026 Tim Gleue ( http://gleue-interactive.com )
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+#import "TGLWindowedDataSource.h"
+#import "TGLRecordWindow.h"
+
+@interface TGLWindowedDataSource () {
+
+    TGLRecordWindow _window;
+    TGLRecordMapping _mapping;
+}
+
+@property (nonatomic, copy) TGLWindowedDataSourceReadBlock readBlock;
+
+@end
+
+static bool TGLWindowedDataSourceRead(void *context, long first, long count, void *buffer) {
+
+    TGLWindowedDataSource *dataSource = (__bridge TGLWindowedDataSource *)context;
+
+    return dataSource.readBlock(first, count, buffer);
+}
+
+@implementation TGLWindowedDataSource
+
+- (instancetype)initWithContentsOfFile:(NSString *)path headerLength:(NSUInteger)headerLength recordLength:(NSUInteger)recordLength {
+
+    self = [super init];
+
+    if (self) {
+
+        if (!TGLRecordMappingOpen(&_mapping, path.fileSystemRepresentation, headerLength, recordLength)) return nil;
+
+        _recordCount = _mapping.recordCount;
+        _recordLength = recordLength;
+        _pageRecordCount = 64;
+        _pageCapacity = 16;
+
+        if (![self resetWindow]) return nil;
+    }
+
+    return self;
+}
+
+- (instancetype)initWithRecordCount:(NSInteger)recordCount recordLength:(NSUInteger)recordLength readBlock:(TGLWindowedDataSourceReadBlock)readBlock {
+
+    NSAssert(recordCount >= 0 && recordLength > 0, @"Invalid record count %ld or length %lu", (long)recordCount, (unsigned long)recordLength);
+
+    self = [super init];
+
+    if (self) {
+
+        _readBlock = [readBlock copy];
+        _recordCount = recordCount;
+        _recordLength = recordLength;
+        _pageRecordCount = 64;
+        _pageCapacity = 16;
+
+        [self resetWindow];
+    }
+
+    return self;
+}
+
+- (void)dealloc {
+
+    TGLRecordWindowFree(&_window);
+    TGLRecordMappingClose(&_mapping);
+}
+
+#pragma mark - Accessors
+
+- (void)setPageRecordCount:(NSInteger)pageRecordCount {
+
+    if (pageRecordCount > 0 && pageRecordCount != self.pageRecordCount) {
+
+        _pageRecordCount = pageRecordCount;
+
+        [self resetWindow];
+    }
+}
+
+- (void)setPageCapacity:(NSInteger)pageCapacity {
+
+    if (pageCapacity > 0 && pageCapacity != self.pageCapacity) {
+
+        _pageCapacity = pageCapacity;
+
+        [self resetWindow];
+    }
+}
+
+- (NSUInteger)residentLength {
+
+    return TGLRecordWindowResidentBytes(&_window);
+}
+
+#pragma mark - Methods
+
+- (NSData *)recordAtIndex:(NSInteger)index {
+
+    const void *record = TGLRecordWindowRecord(&_window, index);
+
+    return record ? [NSData dataWithBytes:record length:self.recordLength] : nil;
+}
+
+- (void)updateVisibleItemRange:(NSRange)visibleRange prefetchItemRange:(NSRange)prefetchRange {
+
+    if (visibleRange.location == NSNotFound) return;
+
+    if (prefetchRange.location == NSNotFound) prefetchRange = visibleRange;
+
+    TGLRecordWindowSetVisibleRange(&_window, visibleRange.location, NSMaxRange(visibleRange), prefetchRange.location, NSMaxRange(prefetchRange));
+}
+
+- (void)removeAllRecords {
+
+    TGLRecordWindowRemoveAll(&_window);
+}
+
+#pragma mark - Helpers
+
+- (BOOL)resetWindow {
+
+    TGLRecordWindowFree(&_window);
+
+    if (self.readBlock) {
+
+        return TGLRecordWindowInit(&_window, self.recordCount, self.recordLength, self.pageRecordCount, self.pageCapacity, TGLWindowedDataSourceRead, (__bridge void *)self);
+    }
+
+    return TGLRecordWindowInit(&_window, self.recordCount, self.recordLength, self.pageRecordCount, self.pageCapacity, TGLRecordMappingRead, &_mapping);
+}
+
+@end
@@ -198,11 +198,30 @@
 
     if (cardCount != _cardCount) {
         
-        _cardCount = cardCount;
-        
-        _cards = nil;
-        
-        if (self.isViewLoaded) [self.collectionView reloadData];
+        if (self.isViewLoaded && _cards) {
+            
+            // Keep existing cards and only insert
+            // or delete those at the end
+            //
+            NSArray *oldCards = _cards;
+            NSMutableArray *newCards = [self cardsWithCount:cardCount keepingCards:oldCards];
+
+            [self performUpdatesFromIdentifiers:[oldCards valueForKey:@"name"]
+                                  toIdentifiers:[newCards valueForKey:@"name"]
+                                      inSection:0
+                                        updates:^ (void) {
+                                            
+                                            self->_cardCount = cardCount;
+                                            self->_cards = newCards;
+                                        }
+                                     completion:nil];
+            
+        } else {
+            
+            _cardCount = cardCount;
+            
+            _cards = nil;
+        }
     }
 }
 
@@ -210,20 +229,33 @@
 
     if (_cards == nil) {
         
-        _cards = [NSMutableArray array];
+        _cards = [self cardsWithCount:self.cardCount keepingCards:nil];
+    }
+    
+    return _cards;
+}
+
+- (NSMutableArray *)cardsWithCount:(NSInteger)cardCount keepingCards:(NSArray *)cards {
+    
+    NSMutableArray *result = [NSMutableArray arrayWithArray:[cards subarrayWithRange:NSMakeRange(0, MIN(cards.count, cardCount))]];
+    
+    // Adjust the number of cards here, keeping
+    // names unique even after reordering
+    //
+    NSSet *names = [NSSet setWithArray:[result valueForKey:@"name"]];
+
+    for (NSInteger i = 1; result.count < cardCount; i++) {
         
-        // Adjust the number of cards here
-        //
-        for (NSInteger i = 1; i <= self.cardCount; i++) {
-            
-            NSDictionary *card = @{ @"name" : [NSString stringWithFormat:@"Card #%d", (int)i], @"color" : [UIColor randomColor] };
-            
-            [_cards addObject:card];
-        }
+        NSString *name = [NSString stringWithFormat:@"Card #%d", (int)i];
+        
+        if ([names containsObject:name]) continue;
         
+        NSDictionary *card = @{ @"name" : name, @"color" : [UIColor randomColor] };
+        
+        [result addObject:card];
     }
     
-    return _cards;
+    return result;
 }
 
 #pragma mark - Key-Value Coding
@@ -0,0 +1,438 @@
+//
+//  TGLAttributesSlotsTests.c
+//  TGLStackedViewController
+//
+//  Created by Tim Gleue on 17.10.26.
+//  Copyright (c) 2026 Tim Gleue ( http://gleue-interactive.com )
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+/* Headless tests of attribute slot bookkeeping.
+ *
+ * Drives slots the way layouts drive their attributes
+ * store, with synthetic objects recycled to a bounded
+ * pool. Checks that objects handed out during a pass
+ * are neither handed out again nor recycled as reusable
+ * during the next one, also by other layouts sharing the
+ * pool, that scrolling allocates nothing once warm, and
+ * that memory follows resident items.
+ */
+
+#include "TGLAttributesSlots.h"
+#include "TGLTestAssertions.h"
+
+#include <stdlib.h>
+
+// MARK: - Helpers
+
+#define TGLTestPoolCapacity 256
+
+typedef struct TGLTestContext TGLTestContext;
+
+typedef struct {
+
+    long item;
+    long pass;                  /* Pass of `owner` the object was last handed out in or -1 */
+    TGLTestContext *owner;
+
+} TGLTestObject;
+
+typedef struct {
+
+    TGLTestObject *objects[TGLTestPoolCapacity];
+    long count;
+
+} TGLTestPool;
+
+struct TGLTestContext {
+
+    long pass;
+    long allocationCount;
+    long copyCount;
+    long liveCount;
+
+    TGLTestPool *pool;
+
+};
+
+static bool TGLTestIsReleased(const TGLTestObject *object) {
+
+    // UIKit may still hold objects handed
+    // out during the current or previous
+    // pass of the layout owning them
+    //
+    return object->owner == NULL || object->pass + 2 <= object->owner->pass;
+}
+
+static void *TGLTestCreate(void *context, long item) {
+
+    TGLTestContext *test = context;
+    TGLTestObject *object;
+
+    if (test->pool->count > 0) {
+
+        object = test->pool->objects[--test->pool->count];
+
+        TGLTestAssert(TGLTestIsReleased(object));
+
+    } else {
+
+        object = malloc(sizeof(TGLTestObject));
+        object->pass = -1;
+        object->owner = NULL;
+
+        test->allocationCount++;
+        test->liveCount++;
+    }
+
+    object->item = item;
+
+    return object;
+}
+
+static void TGLTestRecycle(void *context, void *object, bool reusable) {
+
+    TGLTestContext *test = context;
+    TGLTestObject *recycled = object;
+
+    if (reusable) TGLTestAssert(TGLTestIsReleased(recycled));
+
+    if (reusable && test->pool->count < TGLTestPoolCapacity) {
+
+        test->pool->objects[test->pool->count++] = recycled;
+
+    } else {
+
+        free(recycled);
+
+        test->liveCount--;
+    }
+}
+
+static void *TGLTestRelabel(void *context, void *object, long item, bool reusable) {
+
+    TGLTestContext *test = context;
+    TGLTestObject *relabeled = object;
+
+    if (!reusable) {
+
+        relabeled = malloc(sizeof(TGLTestObject));
+        relabeled->pass = ((TGLTestObject *)object)->pass;
+        relabeled->owner = ((TGLTestObject *)object)->owner;
+
+        TGLTestRecycle(context, object, false);
+
+        test->allocationCount++;
+        test->copyCount++;
+        test->liveCount++;
+
+    } else {
+
+        TGLTestAssert(TGLTestIsReleased(relabeled));
+    }
+
+    relabeled->item = item;
+
+    return relabeled;
+}
+
+static long TGLTestDeleteFirst(void *context, long item) {
+
+    long deleted = *(long *)context;
+
+    if (item == deleted) return -1;
+
+    return (item > deleted) ? item - 1 : item;
+}
+
+static void TGLTestPrepare(TGLAttributesSlots *slots, TGLTestContext *test, long itemCount) {
+
+    test->pass++;
+
+    TGLAttributesSlotsPrepare(slots, itemCount);
+}
+
+static void TGLTestLayOut(TGLAttributesSlots *slots, TGLTestContext *test, long first, long count) {
+
+    for (long item = first; item < first + count; item++) {
+
+        TGLTestObject *object = TGLAttributesSlotsDequeue(slots, item);
+
+        TGLTestAssertEqualLong(object->item, item);
+
+        // Never hand out an object
+        // from the previous pass
+        //
+        TGLTestAssert(object->owner != test || object->pass != test->pass - 1);
+
+        object->pass = test->pass;
+        object->owner = test;
+
+        TGLTestAssert(TGLAttributesSlotsObject(slots, item) == object);
+    }
+}
+
+static void TGLTestFree(TGLAttributesSlots *slots, TGLTestContext *test) {
+
+    TGLAttributesSlotsFree(slots);
+
+    while (test->pool->count > 0) {
+
+        free(test->pool->objects[--test->pool->count]);
+
+        test->liveCount--;
+    }
+
+    TGLTestAssertEqualLong(test->liveCount, 0);
+}
+
+// MARK: - Tests
+
+static void TGLTestSteadyScrolling(void) {
+
+    const long itemCount = 100000;
+    const long visibleCount = 40;
+    const long capacity = 64;
+
+    TGLTestPool pool = { .count = 0 };
+    TGLTestContext test = { .pool = &pool };
+    TGLAttributesSlots slots;
+
+    TGLAttributesSlotsInit(&slots, capacity, TGLTestCreate, TGLTestRelabel, TGLTestRecycle, &test);
+
+    long first = 0;
+
+    // Warm up until objects of items
+    // scrolled past get recycled
+    //
+    for (int frame = 0; frame < 100; frame++, first += 3) {
+
+        TGLTestPrepare(&slots, &test, itemCount);
+        TGLTestLayOut(&slots, &test, first, visibleCount);
+    }
+
+    long allocationCount = test.allocationCount;
+
+    for (int frame = 0; frame < 2000; frame++, first += 3) {
+
+        TGLTestPrepare(&slots, &test, itemCount);
+        TGLTestLayOut(&slots, &test, first, visibleCount);
+    }
+
+    TGLTestAssertEqualLong(test.allocationCount, allocationCount);
+
+    // Scrolling back faster takes objects
+    // for more items from the pool, before
+    // recycling catches up again
+    //
+    for (int frame = 0; frame < 100; frame++, first -= 5) {
+
+        TGLTestPrepare(&slots, &test, itemCount);
+        TGLTestLayOut(&slots, &test, first, visibleCount);
+    }
+
+    allocationCount = test.allocationCount;
+
+    for (int frame = 0; frame < 1000; frame++, first -= 5) {
+
+        TGLTestPrepare(&slots, &test, itemCount);
+        TGLTestLayOut(&slots, &test, first, visibleCount);
+    }
+
+    TGLTestAssertEqualLong(test.allocationCount, allocationCount);
+
+    // Resident items and the window stay
+    // bounded by visible items and capacity
+    //
+    TGLTestAssert(slots.slotCount <= visibleCount + 2 * capacity + 5);
+    TGLTestAssert(slots.windowMask + 1 <= 1024);
+
+    TGLTestFree(&slots, &test);
+}
+
+static void TGLTestPasses(void) {
+
+    TGLTestPool pool = { .count = 0 };
+    TGLTestContext test = { .pool = &pool };
+    TGLAttributesSlots slots;
+
+    TGLAttributesSlotsInit(&slots, 16, TGLTestCreate, TGLTestRelabel, TGLTestRecycle, &test);
+
+    TGLTestAssert(TGLAttributesSlotsObject(&slots, 0) == NULL);
+
+    TGLTestPrepare(&slots, &test, 1000);
+    TGLTestLayOut(&slots, &test, 100, 10);
+
+    TGLTestObject *first = TGLAttributesSlotsObject(&slots, 100);
+
+    // Objects of the last pass are not valid
+    // in the next one unless preserved, then
+    // dequeueing switches to spare objects
+    //
+    TGLTestPrepare(&slots, &test, 1000);
+
+    TGLTestAssert(TGLAttributesSlotsObject(&slots, 100) == NULL);
+
+    TGLAttributesSlotsPreserve(&slots, 105, 100);
+
+    TGLTestAssert(TGLAttributesSlotsObject(&slots, 104) == NULL);
+    TGLTestAssert(TGLAttributesSlotsObject(&slots, 105) != NULL);
+
+    TGLTestLayOut(&slots, &test, 100, 5);
+
+    TGLTestAssert(TGLAttributesSlotsObject(&slots, 100) != first);
+    TGLTestAssertEqualLong(test.allocationCount, 15);
+
+    // The first object is used again two
+    // passes later, without allocations
+    //
+    TGLTestPrepare(&slots, &test, 1000);
+    TGLTestLayOut(&slots, &test, 100, 10);
+
+    TGLTestAssert(TGLAttributesSlotsObject(&slots, 100) == first);
+    TGLTestAssertEqualLong(test.allocationCount, 20);
+
+    // Jumping far recycles objects of
+    // items far away and keeps the
+    // window small
+    //
+    TGLTestPrepare(&slots, &test, 1000);
+    TGLTestLayOut(&slots, &test, 900, 10);
+    TGLTestPrepare(&slots, &test, 1000);
+    TGLTestLayOut(&slots, &test, 900, 10);
+
+    TGLTestAssertEqualLong(slots.slotCount, 10);
+    TGLTestAssertEqualLong(slots.windowFirst, 900);
+    TGLTestAssertEqualLong(slots.windowEnd, 910);
+    TGLTestAssert(TGLAttributesSlotsObject(&slots, 100) == NULL);
+
+    // Changing the item count
+    // recycles everything
+    //
+    TGLTestPrepare(&slots, &test, 999);
+
+    TGLTestAssertEqualLong(slots.slotCount, 0);
+    TGLTestAssert(TGLAttributesSlotsObject(&slots, 900) == NULL);
+
+    TGLTestFree(&slots, &test);
+}
+
+static void TGLTestUpdate(void) {
+
+    TGLTestPool pool = { .count = 0 };
+    TGLTestContext test = { .pool = &pool };
+    TGLAttributesSlots slots;
+
+    TGLAttributesSlotsInit(&slots, 16, TGLTestCreate, TGLTestRelabel, TGLTestRecycle, &test);
+
+    TGLTestPrepare(&slots, &test, 100);
+    TGLTestLayOut(&slots, &test, 10, 10);
+    TGLTestPrepare(&slots, &test, 100);
+    TGLTestLayOut(&slots, &test, 20, 10);
+    TGLTestPrepare(&slots, &test, 100);
+    TGLTestLayOut(&slots, &test, 20, 10);
+
+    // Items 10...19 were handed out two passes
+    // ago and are relabeled in place, items
+    // 20...29 during the current pass are copied
+    //
+    long deleted = 15;
+
+    TGLAttributesSlotsUpdate(&slots, 99, TGLTestDeleteFirst, &deleted);
+
+    TGLTestAssertEqualLong(slots.slotCount, 19);
+    TGLTestAssertEqualLong(test.copyCount, 10);
+
+    TGLTestPrepare(&slots, &test, 99);
+
+    for (long item = 10; item < 28; item++) {
+
+        TGLTestObject *object = TGLAttributesSlotsDequeue(&slots, item);
+
+        TGLTestAssertEqualLong(object->item, item);
+        TGLTestAssert(object->pass != test.pass - 1);
+
+        object->pass = test.pass;
+        object->owner = &test;
+    }
+
+    TGLTestFree(&slots, &test);
+}
+
+static void TGLTestSharedPool(void) {
+
+    const long itemCount = 100000;
+    const long visibleCount = 30;
+
+    // Layouts sharing a pool keep objects of
+    // items used during their last pass only
+    // and take objects recycled by each other
+    //
+    TGLTestPool pool = { .count = 0 };
+    TGLTestContext tests[2] = { { .pool = &pool }, { .pool = &pool } };
+    TGLAttributesSlots slots[2];
+
+    TGLAttributesSlotsInit(&slots[0], 0, TGLTestCreate, TGLTestRelabel, TGLTestRecycle, &tests[0]);
+    TGLAttributesSlotsInit(&slots[1], 0, TGLTestCreate, TGLTestRelabel, TGLTestRecycle, &tests[1]);
+
+    long allocationCount = 0;
+    long first = 0;
+
+    for (int frame = 0; frame < 2000; frame++) {
+
+        // Layouts take turns, the first
+        // one scrolling faster at times
+        //
+        first += (frame / 100) % 2 ? 4 : 1;
+
+        TGLTestPrepare(&slots[0], &tests[0], itemCount);
+        TGLTestLayOut(&slots[0], &tests[0], first, visibleCount);
+        TGLTestPrepare(&slots[1], &tests[1], itemCount);
+        TGLTestLayOut(&slots[1], &tests[1], 2 * frame, visibleCount);
+
+        if (frame == 99) allocationCount = tests[0].allocationCount + tests[1].allocationCount;
+    }
+
+    TGLTestAssert(slots[0].slotCount <= visibleCount + 4);
+    TGLTestAssert(slots[1].slotCount <= visibleCount + 2);
+
+    // Spare objects of both layouts are bounded
+    // by the pool, and allocations level off
+    //
+    TGLTestAssert(tests[0].liveCount + tests[1].liveCount <= 2 * (2 * visibleCount + 8) + TGLTestPoolCapacity);
+    TGLTestAssert(tests[0].allocationCount + tests[1].allocationCount - allocationCount <= 8);
+
+    TGLAttributesSlotsFree(&slots[0]);
+
+    tests[1].liveCount += tests[0].liveCount;
+
+    TGLTestFree(&slots[1], &tests[1]);
+}
+
+// MARK: - Main
+
+int main(void) {
+
+    TGLTestSteadyScrolling();
+    TGLTestPasses();
+    TGLTestUpdate();
+    TGLTestSharedPool();
+
+    return TGLTestFinish("TGLAttributesSlotsTests");
+}
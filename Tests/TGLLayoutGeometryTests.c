@@ -0,0 +1,1389 @@
+//
+//  TGLLayoutGeometryTests.c
+//  TGLStackedViewController
+//
+//  Created by Tim Gleue on 17.10.26.
+//  Copyright (c) 2026 Tim Gleue ( http://gleue-interactive.com )
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+/* Headless tests of the platform-neutral layout geometry.
+ *
+ * Checks stacked and exposed item origins, flags and item
+ * ranges, as well as reveal table sums, against values
+ * computed by hand from the layouts' rules. Build and run
+ * from the repository root with `make test`.
+ */
+
+#include "TGLLayoutGeometry.h"
+#include "TGLTestAssertions.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// MARK: - Helpers
+
+/** Stack of 10 items revealing 100pt each, scrollable by 220pt */
+static TGLStackedParameters TGLTestStackedParameters(double contentOffset) {
+
+    TGLStackedParameters parameters = {
+
+        .itemCount = 10,
+        .itemReveal = 100.0,
+        .itemHeight = 500.0,
+        .marginTop = 20.0,
+        .layoutHeight = 780.0,
+        .boundsHeight = 800.0,
+        .contentHeight = 1020.0,
+        .contentOffset = contentOffset,
+        .contentInsetTop = 0.0,
+        .bounceFactor = 0.2
+    };
+
+    return parameters;
+}
+
+/** Stack of 10 items exposing item 4 with 10pt overlaps */
+static TGLExposedParameters TGLTestExposedParameters(TGLExposedPinning pinning) {
+
+    TGLExposedParameters parameters = {
+
+        .itemCount = 10,
+        .exposedItem = 4,
+        .itemHeight = 500.0,
+        .marginTop = 40.0,
+        .marginBottom = 0.0,
+        .boundsHeight = 800.0,
+        .contentHeight = 800.0,
+        .topOverlap = 10.0,
+        .bottomOverlap = 10.0,
+        .bottomOverlapCount = 1,
+        .pinning = pinning,
+        .topPinningCount = -1,
+        .bottomPinningCount = -1
+    };
+
+    return parameters;
+}
+
+/** Checks that single item queries agree with batch queries */
+static void TGLTestStackedConsistency(const TGLStackedGeometry *geometry) {
+
+    double originY[10];
+    TGLLayoutItemFlags flags[10];
+
+    TGLStackedGeometryGetItems(geometry, 0, geometry->itemCount, originY, flags);
+
+    for (long item = 0; item < geometry->itemCount; item++) {
+
+        TGLTestAssertEqualDouble(TGLStackedGeometryOriginY(geometry, item), originY[item]);
+        TGLTestAssertEqualLong(TGLStackedGeometryFlags(geometry, item), flags[item]);
+    }
+}
+
+/** Returns a pseudo-random number in `[0, bound)`, reproducible for the same `state` */
+static long TGLTestRandom(unsigned long *state, long bound) {
+
+    *state = *state * 6364136223846793005ul + 1442695040888963407ul;
+
+    return (long)((*state >> 33) % (unsigned long)bound);
+}
+
+/** Fills `selected` with `selectedCount` distinct pseudo-random indices in `[0, count)` sorted ascending */
+static void TGLTestRandomSelection(unsigned long *state, long count, long *selected, long selectedCount) {
+
+    for (long item = 0, remaining = selectedCount; item < count && remaining > 0; item++) {
+
+        if (TGLTestRandom(state, count - item) < remaining) selected[selectedCount - remaining--] = item;
+    }
+}
+
+/** Checks that `table` agrees with a table freshly built from `values` */
+static void TGLTestRevealTableMatches(const TGLRevealTable *table, const double *values, long count) {
+
+    TGLRevealTable reference;
+    double *tableValues = malloc((count > 0 ? count : 1) * sizeof(double));
+
+    TGLRevealTableInit(&reference);
+    TGLRevealTableReset(&reference, values, count);
+    TGLRevealTableGetValues(table, 0, count, tableValues);
+
+    TGLTestAssertEqualLong(table->count, count);
+
+    for (long item = 0; item <= count; item++) {
+
+        TGLTestAssertEqualDouble(TGLRevealTablePrefix(table, item), TGLRevealTablePrefix(&reference, item));
+
+        if (item < count) TGLTestAssertEqualDouble(tableValues[item], values[item]);
+    }
+
+    double total = TGLRevealTableTotal(&reference);
+
+    for (double offset = -1.0; offset <= total + 1.0; offset += 7.5) {
+
+        TGLTestAssertEqualLong(TGLRevealTableCountBelow(table, offset), TGLRevealTableCountBelow(&reference, offset));
+    }
+
+    TGLRevealTableFree(&reference);
+
+    free(tableValues);
+}
+
+// MARK: - Section table
+
+static void TGLTestSectionTable(void) {
+
+    // Empty sections at the start,
+    // in between and at the end
+    //
+    const long itemCounts[] = { 0, 3, 0, 0, 5, 0, 2, 0 };
+    const long sections[] = { 1, 1, 1, 4, 4, 4, 4, 4, 6, 6 };
+    TGLSectionTable table;
+
+    TGLSectionTableInit(&table);
+
+    TGLTestAssertEqualLong(TGLSectionTableItemCount(&table), 0);
+    TGLTestAssert(TGLSectionTableReset(&table, itemCounts, 8));
+
+    TGLTestAssertEqualLong(TGLSectionTableItemCount(&table), 10);
+    TGLTestAssertEqualLong(TGLSectionTableStart(&table, 0), 0);
+    TGLTestAssertEqualLong(TGLSectionTableStart(&table, 2), 3);
+    TGLTestAssertEqualLong(TGLSectionTableStart(&table, 3), 3);
+    TGLTestAssertEqualLong(TGLSectionTableStart(&table, 4), 3);
+    TGLTestAssertEqualLong(TGLSectionTableStart(&table, 7), 10);
+
+    // Items map to non-empty sections
+    // only, and back to the same index
+    //
+    for (long item = 0; item < 10; item++) {
+
+        long section = TGLSectionTableSection(&table, item);
+
+        TGLTestAssertEqualLong(section, sections[item]);
+        TGLTestAssert(item - TGLSectionTableStart(&table, section) < itemCounts[section]);
+    }
+
+    // Resetting to the same sections changes
+    // nothing, emptying a section does
+    //
+    TGLSectionTable other;
+    long otherCounts[] = { 0, 3, 0, 0, 5, 0, 2, 0 };
+
+    TGLSectionTableInit(&other);
+
+    TGLTestAssert(!TGLSectionTableReset(&table, itemCounts, 8));
+    TGLTestAssert(TGLSectionTableReset(&other, otherCounts, 8));
+    TGLTestAssert(TGLSectionTableEqual(&table, &other));
+
+    otherCounts[1] = 0;
+
+    TGLTestAssert(TGLSectionTableReset(&other, otherCounts, 8));
+    TGLTestAssert(!TGLSectionTableEqual(&table, &other));
+    TGLTestAssertEqualLong(TGLSectionTableItemCount(&other), 7);
+    TGLTestAssertEqualLong(TGLSectionTableSection(&other, 0), 4);
+    TGLTestAssertEqualLong(TGLSectionTableSection(&other, 6), 6);
+
+    // Moving items between sections keeps
+    // the item count, but changes the table
+    //
+    otherCounts[1] = 1;
+    otherCounts[6] = 1;
+
+    TGLTestAssert(TGLSectionTableReset(&other, otherCounts, 8));
+    TGLTestAssertEqualLong(TGLSectionTableItemCount(&other), 7);
+    TGLTestAssertEqualLong(TGLSectionTableSection(&other, 0), 1);
+    TGLTestAssertEqualLong(TGLSectionTableSection(&other, 1), 4);
+
+    TGLSectionTableFree(&other);
+    TGLSectionTableFree(&table);
+}
+
+// MARK: - Item updates
+
+static void TGLTestItemUpdateMap(void) {
+
+    // Items 1 and 4 deleted, item 6 moved to
+    // the top and new items inserted at 3 and 7:
+    // [0 1 2 3 4 5 6 7] -> [6 0 2 n 3 5 7 n]
+    //
+    const long deletedItems[] = { 1, 4, 6 };
+    const long insertedItems[] = { 0, 3, 7 };
+    const long expected[] = { 1, -1, 2, 4, -1, 5, -1, 6 };
+
+    for (long item = 0; item < 8; item++) {
+
+        TGLTestAssertEqualLong(TGLItemUpdateMap(deletedItems, 3, insertedItems, 3, item), expected[item]);
+    }
+
+    // Without edits indices are kept, as
+    // they are when inserting at the end
+    //
+    const long endItems[] = { 8 };
+    const long expectedDeleted[] = { 0, -1, 1, 2, -1, 3, -1, 4 };
+
+    for (long item = 0; item < 8; item++) {
+
+        TGLTestAssertEqualLong(TGLItemUpdateMap(NULL, 0, NULL, 0, item), item);
+        TGLTestAssertEqualLong(TGLItemUpdateMap(NULL, 0, endItems, 1, item), item);
+        TGLTestAssertEqualLong(TGLItemUpdateMap(deletedItems, 3, NULL, 0, item), expectedDeleted[item]);
+    }
+
+    // Random batches checked against
+    // items spread out one by one
+    //
+    long count = 500;
+    long *deleted = malloc(count * sizeof(long));
+    long *inserted = malloc(count * sizeof(long));
+    long *positions = malloc(count * sizeof(long));
+    unsigned long state = 3;
+
+    for (long batch = 0; batch < 50; batch++) {
+
+        long deletedCount = TGLTestRandom(&state, count / 2);
+        long insertedCount = TGLTestRandom(&state, count / 2);
+        long newCount = count - deletedCount + insertedCount;
+
+        TGLTestRandomSelection(&state, count, deleted, deletedCount);
+        TGLTestRandomSelection(&state, newCount, inserted, insertedCount);
+
+        for (long item = 0, d = 0, i = 0, newItem = 0; item < count; item++) {
+
+            if (d < deletedCount && deleted[d] == item) {
+
+                positions[item] = -1;
+                d++;
+
+            } else {
+
+                while (i < insertedCount && inserted[i] == newItem) {
+
+                    newItem++;
+                    i++;
+                }
+
+                positions[item] = newItem++;
+            }
+        }
+
+        for (long item = 0; item < count; item++) {
+
+            TGLTestAssertEqualLong(TGLItemUpdateMap(deleted, deletedCount, inserted, insertedCount, item), positions[item]);
+        }
+    }
+
+    free(deleted);
+    free(inserted);
+    free(positions);
+}
+
+/** Checks that `members` marks a strictly increasing subsequence of `length` values */
+static void TGLTestIncreasingMembers(const long *values, const bool *members, long count, long length) {
+
+    long memberCount = 0;
+    long last = -1;
+
+    for (long i = 0; i < count; i++) {
+
+        if (!members[i]) continue;
+
+        if (memberCount > 0) TGLTestAssert(values[i] > last);
+
+        last = values[i];
+        memberCount++;
+    }
+
+    TGLTestAssertEqualLong(memberCount, length);
+}
+
+static void TGLTestLongestIncreasingSubsequence(void) {
+
+    long count = 200;
+    long *values = malloc(count * sizeof(long));
+    long *lengths = malloc(count * sizeof(long));
+    bool *members = malloc(count * sizeof(bool));
+    unsigned long state = 7;
+
+    // Sorted items all stay, reversed
+    // ones all but a single one move
+    //
+    for (long i = 0; i < count; i++) values[i] = i;
+
+    TGLTestAssertEqualLong(TGLItemLongestIncreasingSubsequence(values, 0, members), 0);
+    TGLTestAssertEqualLong(TGLItemLongestIncreasingSubsequence(values, count, members), count);
+    TGLTestIncreasingMembers(values, members, count, count);
+
+    for (long i = 0; i < count; i++) values[i] = count - 1 - i;
+
+    TGLTestAssertEqualLong(TGLItemLongestIncreasingSubsequence(values, count, members), 1);
+    TGLTestIncreasingMembers(values, members, count, 1);
+
+    // Random permutations checked
+    // against quadratic search
+    //
+    for (long round = 0; round < 20; round++) {
+
+        for (long i = 0; i < count; i++) {
+
+            long j = TGLTestRandom(&state, i + 1);
+
+            values[i] = values[j];
+            values[j] = i;
+        }
+
+        long expected = 0;
+
+        for (long i = 0; i < count; i++) {
+
+            lengths[i] = 1;
+
+            for (long j = 0; j < i; j++) {
+
+                if (values[j] < values[i] && lengths[j] + 1 > lengths[i]) lengths[i] = lengths[j] + 1;
+            }
+
+            if (lengths[i] > expected) expected = lengths[i];
+        }
+
+        long length = TGLItemLongestIncreasingSubsequence(values, count, members);
+
+        TGLTestAssertEqualLong(length, expected);
+        TGLTestIncreasingMembers(values, members, count, length);
+    }
+
+    free(values);
+    free(lengths);
+    free(members);
+}
+
+// MARK: - Reveal table
+
+static void TGLTestRevealTable(void) {
+
+    const double values[] = { 10.0, 20.0, 30.0, 40.0, 50.0 };
+    TGLRevealTable table;
+
+    TGLRevealTableInit(&table);
+    TGLRevealTableReset(&table, values, 5);
+
+    TGLTestAssertEqualDouble(TGLRevealTablePrefix(&table, 0), 0.0);
+    TGLTestAssertEqualDouble(TGLRevealTablePrefix(&table, 3), 60.0);
+    TGLTestAssertEqualDouble(TGLRevealTablePrefix(&table, 10), 150.0);
+    TGLTestAssertEqualDouble(TGLRevealTableTotal(&table), 150.0);
+
+    // Items 0...2 are located at 0, 10
+    // and 30, i.e. above offset 60
+    //
+    TGLTestAssertEqualLong(TGLRevealTableCountBelow(&table, 0.0), 0);
+    TGLTestAssertEqualLong(TGLRevealTableCountBelow(&table, 60.0), 3);
+    TGLTestAssertEqualLong(TGLRevealTableCountBelow(&table, 60.5), 4);
+    TGLTestAssertEqualLong(TGLRevealTableCountBelow(&table, 1000.0), 5);
+
+    TGLRevealTableSetValue(&table, 2, 35.0);
+
+    TGLTestAssertEqualDouble(TGLRevealTablePrefix(&table, 3), 65.0);
+    TGLTestAssertEqualDouble(TGLRevealTableTotal(&table), 155.0);
+
+    TGLRevealTableInsert(&table, 1, 5.0);
+
+    TGLTestAssertEqualLong(table.count, 6);
+    TGLTestAssertEqualDouble(TGLRevealTablePrefix(&table, 2), 15.0);
+    TGLTestAssertEqualDouble(TGLRevealTableTotal(&table), 160.0);
+
+    TGLRevealTableRemove(&table, 0);
+
+    TGLTestAssertEqualLong(table.count, 5);
+    TGLTestAssertEqualDouble(TGLRevealTablePrefix(&table, 1), 5.0);
+    TGLTestAssertEqualDouble(TGLRevealTableTotal(&table), 150.0);
+
+    TGLRevealTableFree(&table);
+}
+
+static void TGLTestRevealTableEdits(void) {
+
+    // Integral reveal heights keep sums exact,
+    // whatever order they are added in
+    //
+    long capacity = 8192;
+    long count = 3000;
+    double *values = malloc(capacity * sizeof(double));
+    unsigned long state = 1;
+    TGLRevealTable table;
+
+    TGLRevealTableInit(&table);
+
+    // Inserting into and removing from full
+    // leaves at every position of a table
+    // of two branch levels
+    //
+    long fullCount = 4 * TGLRevealTableLeafCapacity * TGLRevealTableBranchCapacity;
+    double fullTotal = 0.0;
+    double prefix = 0.0;
+
+    for (long item = 0; item < fullCount; item++) {
+
+        values[item] = 1 + item % 16;
+        fullTotal += values[item];
+    }
+
+    for (long item = 0; item <= fullCount; item++) {
+
+        TGLRevealTableReset(&table, values, fullCount);
+        TGLRevealTableInsert(&table, item, 100.0);
+
+        TGLTestAssertEqualLong(table.count, fullCount + 1);
+        TGLTestAssertEqualDouble(TGLRevealTableValue(&table, item), 100.0);
+        TGLTestAssertEqualDouble(TGLRevealTablePrefix(&table, item), prefix);
+        TGLTestAssertEqualDouble(TGLRevealTableTotal(&table), fullTotal + 100.0);
+
+        if (item < fullCount) {
+
+            TGLTestAssertEqualDouble(TGLRevealTableValue(&table, item + 1), values[item]);
+
+            // Remove inserted and original item
+            //
+            TGLRevealTableRemove(&table, item);
+            TGLRevealTableRemove(&table, item);
+
+            TGLTestAssertEqualLong(table.count, fullCount - 1);
+            TGLTestAssertEqualDouble(TGLRevealTablePrefix(&table, item), prefix);
+            TGLTestAssertEqualDouble(TGLRevealTableTotal(&table), fullTotal - values[item]);
+
+            if (item + 1 < fullCount) TGLTestAssertEqualDouble(TGLRevealTableValue(&table, item), values[item + 1]);
+
+            prefix += values[item];
+        }
+    }
+
+    for (long item = 0; item < count; item++) values[item] = 1 + TGLTestRandom(&state, 16);
+
+    TGLRevealTableReset(&table, values, count);
+
+    // Random inserts, removes and changes
+    // split leaves and branches
+    //
+    for (long edit = 1; edit <= 6000; edit++) {
+
+        long kind = TGLTestRandom(&state, 10);
+
+        if (kind < 5 && count < capacity) {
+
+            long item = TGLTestRandom(&state, count + 1);
+            double value = 1 + TGLTestRandom(&state, 16);
+
+            memmove(values + item + 1, values + item, (count - item) * sizeof(double));
+
+            values[item] = value;
+            count += 1;
+
+            TGLRevealTableInsert(&table, item, value);
+
+        } else if (kind < 9 && count > 0) {
+
+            long item = TGLTestRandom(&state, count);
+
+            memmove(values + item, values + item + 1, (count - item - 1) * sizeof(double));
+
+            count -= 1;
+
+            TGLRevealTableRemove(&table, item);
+
+        } else if (count > 0) {
+
+            long item = TGLTestRandom(&state, count);
+
+            values[item] = 1 + TGLTestRandom(&state, 16);
+
+            TGLRevealTableSetValue(&table, item, values[item]);
+        }
+
+        if (edit % 1000 == 0) TGLTestRevealTableMatches(&table, values, count);
+    }
+
+    // Inserting at the top over and over
+    // grows the tree by another level
+    //
+    long height = table.height;
+
+    for (long edit = 0; edit < 4000; edit++) {
+
+        memmove(values + 1, values, count * sizeof(double));
+
+        values[0] = 1 + (edit % 16);
+        count += 1;
+
+        TGLRevealTableInsert(&table, 0, values[0]);
+    }
+
+    TGLTestAssert(table.height > height);
+    TGLTestRevealTableMatches(&table, values, count);
+
+    // Removing most items rebuilds the
+    // tree rather than keeping leaves
+    // mostly empty
+    //
+    while (count > 100) {
+
+        long item = TGLTestRandom(&state, count);
+
+        memmove(values + item, values + item + 1, (count - item - 1) * sizeof(double));
+
+        count -= 1;
+
+        TGLRevealTableRemove(&table, item);
+    }
+
+    TGLTestAssert(table.leafCount <= 2 * ((count + TGLRevealTableLeafCapacity - 1) / TGLRevealTableLeafCapacity) + 2);
+    TGLTestRevealTableMatches(&table, values, count);
+
+    // Tables never reset are filled on insert
+    //
+    TGLRevealTable empty;
+
+    TGLRevealTableInit(&empty);
+    TGLRevealTableInsert(&empty, 0, 5.0);
+    TGLRevealTableInsert(&empty, 0, 3.0);
+
+    TGLTestAssertEqualDouble(TGLRevealTableValue(&empty, 0), 3.0);
+    TGLTestAssertEqualDouble(TGLRevealTableTotal(&empty), 8.0);
+
+    TGLRevealTableFree(&empty);
+    TGLRevealTableFree(&table);
+
+    free(values);
+}
+
+static void TGLTestRevealTableUpdate(void) {
+
+    // Integral reveal heights keep sums exact,
+    // whatever order they are added in
+    //
+    long count = 3000;
+    double *values = malloc(count * sizeof(double));
+    double *updated = malloc(2 * count * sizeof(double));
+    double *insertedValues = malloc(count * sizeof(double));
+    long *deleted = malloc(count * sizeof(long));
+    long *inserted = malloc(count * sizeof(long));
+    unsigned long state = 5;
+    TGLRevealTable table;
+
+    TGLRevealTableInit(&table);
+
+    // Batches only inserting into a table
+    // never reset fill it
+    //
+    for (long item = 0; item < count; item++) {
+
+        inserted[item] = item;
+        values[item] = 1 + TGLTestRandom(&state, 16);
+    }
+
+    TGLRevealTableUpdate(&table, NULL, 0, inserted, values, count);
+    TGLTestRevealTableMatches(&table, values, count);
+
+    // Alternating small batches applied edit
+    // by edit and large ones rebuilding the
+    // table, moving deleted items back in
+    //
+    for (long batch = 0; batch < 40; batch++) {
+
+        long limit = (batch % 2 == 0) ? count / TGLRevealTableLeafCapacity / 2 : count / 2;
+        long deletedCount = TGLTestRandom(&state, limit);
+        long insertedCount = TGLTestRandom(&state, limit);
+        long newCount = count - deletedCount + insertedCount;
+
+        TGLTestRandomSelection(&state, count, deleted, deletedCount);
+        TGLTestRandomSelection(&state, newCount, inserted, insertedCount);
+
+        for (long i = 0; i < insertedCount; i++) {
+
+            insertedValues[i] = (i < deletedCount) ? values[deleted[i]] : 1 + TGLTestRandom(&state, 16);
+        }
+
+        for (long newItem = 0, item = 0, d = 0, i = 0; newItem < newCount; newItem++) {
+
+            if (i < insertedCount && inserted[i] == newItem) {
+
+                updated[newItem] = insertedValues[i++];
+
+            } else {
+
+                while (d < deletedCount && deleted[d] == item) {
+
+                    item++;
+                    d++;
+                }
+
+                updated[newItem] = values[item++];
+            }
+        }
+
+        TGLRevealTableUpdate(&table, deleted, deletedCount, inserted, insertedValues, insertedCount);
+        TGLTestRevealTableMatches(&table, updated, newCount);
+
+        // Keep the table size steady, so
+        // scratch buffers stay large enough
+        //
+        memcpy(values, updated, count * sizeof(double));
+
+        if (newCount != count) {
+
+            long extra = (newCount > count) ? newCount - count : count - newCount;
+
+            for (long i = 0; i < extra; i++) {
+
+                deleted[i] = count + i;
+                inserted[i] = newCount + i;
+                insertedValues[i] = 1 + TGLTestRandom(&state, 16);
+            }
+
+            if (newCount > count) {
+
+                TGLRevealTableUpdate(&table, deleted, extra, NULL, NULL, 0);
+
+            } else {
+
+                memcpy(values + newCount, insertedValues, extra * sizeof(double));
+
+                TGLRevealTableUpdate(&table, NULL, 0, inserted, insertedValues, extra);
+            }
+        }
+
+        TGLTestRevealTableMatches(&table, values, count);
+    }
+
+    TGLRevealTableFree(&table);
+
+    free(values);
+    free(updated);
+    free(insertedValues);
+    free(deleted);
+    free(inserted);
+}
+
+/** Runs all iterations serially in reverse order, counting them in `TGLTestApplyCount` */
+static long TGLTestApplyCount = 0;
+
+static void TGLTestSerialApply(size_t iterations, void *context, void (*work)(void *context, size_t iteration)) {
+
+    TGLTestApplyCount += (long)iterations;
+
+    for (size_t i = iterations; i > 0; i--) work(context, i - 1);
+}
+
+static void TGLTestRevealTableConcurrentReset(void) {
+
+    // Sizes around one, two and three chunks
+    // and a partial chunk after many full ones
+    //
+    const long counts[] = { 1, TGLRevealTableChunkSize - 1, TGLRevealTableChunkSize, TGLRevealTableChunkSize + 1, 2 * TGLRevealTableChunkSize - 1, 2 * TGLRevealTableChunkSize, 2 * TGLRevealTableChunkSize + 1, 3 * TGLRevealTableChunkSize - 1, 3 * TGLRevealTableChunkSize, 3 * TGLRevealTableChunkSize + 1, 17 * TGLRevealTableChunkSize + 5 };
+    const long maxCount = 17 * TGLRevealTableChunkSize + 5;
+
+    // Fractional heights make sums depend
+    // on the order they are added in
+    //
+    double *values = malloc(maxCount * sizeof(double));
+
+    for (long item = 0; item < maxCount; item++) values[item] = 1.0 + (item % 7) * 0.37;
+
+    for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++) {
+
+        long count = counts[i];
+        TGLRevealTable serial, concurrent;
+
+        TGLRevealTableInit(&serial);
+        TGLRevealTableInit(&concurrent);
+
+        TGLTestApplyCount = 0;
+
+        TGLRevealTableReset(&serial, values, count);
+        TGLRevealTableResetConcurrently(&concurrent, values, count, TGLTestSerialApply);
+
+        // Only tables of two chunks and
+        // more are built in chunks
+        //
+        TGLTestAssertEqualLong(TGLTestApplyCount, (count < 2 * TGLRevealTableChunkSize) ? 0 : (count + TGLRevealTableChunkSize - 1) / TGLRevealTableChunkSize);
+
+        TGLTestAssertEqualLong(concurrent.count, serial.count);
+        TGLTestAssertEqualLong(concurrent.height, serial.height);
+        TGLTestAssertEqualLong(concurrent.root, serial.root);
+        TGLTestAssertEqualLong(concurrent.leafCount, serial.leafCount);
+        TGLTestAssertEqualLong(concurrent.branchCount, serial.branchCount);
+
+        for (long leaf = 0; leaf < serial.leafCount && leaf < concurrent.leafCount; leaf++) {
+
+            TGLTestAssertEqualLong(concurrent.leafSizes[leaf], serial.leafSizes[leaf]);
+
+            for (long i = 0; i < serial.leafSizes[leaf] && i < concurrent.leafSizes[leaf]; i++) {
+
+                TGLTestAssert(concurrent.leafValues[leaf * TGLRevealTableLeafCapacity + i] == serial.leafValues[leaf * TGLRevealTableLeafCapacity + i]);
+            }
+        }
+
+        for (long branch = 0; branch < serial.branchCount && branch < concurrent.branchCount; branch++) {
+
+            const TGLRevealTableBranch *a = &concurrent.branches[branch];
+            const TGLRevealTableBranch *b = &serial.branches[branch];
+
+            TGLTestAssertEqualLong(a->childCount, b->childCount);
+
+            for (long child = 0; child < a->childCount && child < b->childCount; child++) {
+
+                TGLTestAssertEqualLong(a->children[child], b->children[child]);
+                TGLTestAssertEqualLong(a->counts[child], b->counts[child]);
+                TGLTestAssert(a->sums[child] == b->sums[child]);
+            }
+        }
+
+        // Prefixes are identical, not
+        // just equal within tolerance
+        //
+        for (long item = 0; item <= count; item += (item < 100 || count - item < 100) ? 1 : 97) {
+
+            TGLTestAssert(TGLRevealTablePrefix(&concurrent, item) == TGLRevealTablePrefix(&serial, item));
+        }
+
+        TGLTestAssert(TGLRevealTablePrefix(&concurrent, count) == TGLRevealTablePrefix(&serial, count));
+
+        TGLRevealTableFree(&serial);
+        TGLRevealTableFree(&concurrent);
+    }
+
+    free(values);
+}
+
+// MARK: - Layout cache
+
+/** Key of a stack of 10 items in a collection view `width` points wide */
+static TGLLayoutCacheKey TGLTestLayoutCacheKey(double width) {
+
+    TGLLayoutCacheKey key = {
+
+        .boundsWidth = width,
+        .boundsHeight = 800.0,
+        .marginTop = 20.0,
+        .itemWidth = width,
+        .itemHeight = 500.0,
+        .itemReveal = 100.0,
+        .itemCount = 10,
+        .dataVersion = 1
+    };
+
+    return key;
+}
+
+static void TGLTestLayoutCache(void) {
+
+    TGLLayoutCache cache;
+    TGLLayoutCacheKey keys[TGLLayoutCacheCapacity + 1];
+    double values[10];
+
+    TGLLayoutCacheInit(&cache);
+
+    // Fill cache with tables telling
+    // their keys apart by values
+    //
+    for (long i = 0; i <= TGLLayoutCacheCapacity; i++) keys[i] = TGLTestLayoutCacheKey(300.0 + 100.0 * i);
+
+    for (long i = 0; i < TGLLayoutCacheCapacity; i++) {
+
+        TGLTestAssert(TGLLayoutCacheLookup(&cache, &keys[i]) == NULL);
+
+        for (long item = 0; item < 10; item++) values[item] = i + 1;
+
+        TGLRevealTableReset(&TGLLayoutCacheInsert(&cache, &keys[i])->revealTable, values, 10);
+    }
+
+    for (long i = 0; i < TGLLayoutCacheCapacity; i++) {
+
+        const TGLLayoutCacheEntry *entry = TGLLayoutCacheLookup(&cache, &keys[i]);
+
+        TGLTestAssert(entry != NULL);
+
+        if (entry) TGLTestAssertEqualDouble(TGLRevealTableTotal(&entry->revealTable), 10.0 * (i + 1));
+    }
+
+    // Changing any input misses
+    //
+    for (long field = 0; field < 11; field++) {
+
+        TGLLayoutCacheKey key = keys[0];
+
+        switch (field) {
+
+            case 0: key.boundsWidth += 1.0; break;
+            case 1: key.boundsHeight += 1.0; break;
+            case 2: key.marginTop += 1.0; break;
+            case 3: key.marginLeft += 1.0; break;
+            case 4: key.marginBottom += 1.0; break;
+            case 5: key.marginRight += 1.0; break;
+            case 6: key.itemWidth += 1.0; break;
+            case 7: key.itemHeight += 1.0; break;
+            case 8: key.itemReveal += 1.0; break;
+            case 9: key.itemCount += 1; break;
+            default: key.dataVersion += 1; break;
+        }
+
+        TGLTestAssert(TGLLayoutCacheLookup(&cache, &key) == NULL);
+    }
+
+    // Using the oldest entries again makes the
+    // third one least recently used, which is
+    // evicted by inserting another key, handing
+    // out its table's buffers for reuse
+    //
+    TGLLayoutCacheLookup(&cache, &keys[0]);
+    TGLLayoutCacheLookup(&cache, &keys[1]);
+
+    TGLLayoutCacheEntry *entry = TGLLayoutCacheInsert(&cache, &keys[TGLLayoutCacheCapacity]);
+
+    TGLTestAssert(TGLLayoutCacheLookup(&cache, &keys[2]) == NULL);
+    TGLTestAssertEqualDouble(TGLRevealTableTotal(&entry->revealTable), 30.0);
+
+    for (long i = 0; i <= TGLLayoutCacheCapacity; i++) {
+
+        if (i != 2) TGLTestAssert(TGLLayoutCacheLookup(&cache, &keys[i]) != NULL);
+    }
+
+    // Now the first is least recently used,
+    // unless its key is inserted again, which
+    // replaces its entry in place
+    //
+    TGLTestAssert(TGLLayoutCacheInsert(&cache, &keys[0]) == TGLLayoutCacheLookup(&cache, &keys[0]));
+
+    TGLLayoutCacheInsert(&cache, &keys[2]);
+
+    TGLTestAssert(TGLLayoutCacheLookup(&cache, &keys[0]) != NULL);
+    TGLTestAssert(TGLLayoutCacheLookup(&cache, &keys[1]) == NULL);
+
+    // Removing all entries misses every key
+    //
+    TGLLayoutCacheRemoveAll(&cache);
+
+    for (long i = 0; i <= TGLLayoutCacheCapacity; i++) TGLTestAssert(TGLLayoutCacheLookup(&cache, &keys[i]) == NULL);
+
+    TGLLayoutCacheFree(&cache);
+}
+
+// MARK: - Stacked geometry
+
+static void TGLTestStackedAtTop(void) {
+
+    TGLStackedParameters parameters = TGLTestStackedParameters(0.0);
+    TGLStackedGeometry geometry;
+    long firstCompressingItem = -1;
+
+    TGLStackedGeometryPrepare(&geometry, &parameters, &firstCompressingItem);
+
+    TGLTestAssertEqualLong(geometry.adjustment, TGLStackedAdjustmentNone);
+    TGLTestAssertEqualLong(geometry.pinnedItemCount, 0);
+    TGLTestAssertEqualDouble(TGLStackedGeometryOriginY(&geometry, 0), 20.0);
+    TGLTestAssertEqualDouble(TGLStackedGeometryOriginY(&geometry, 3), 320.0);
+    TGLTestAssertEqualDouble(TGLStackedGeometryOriginY(&geometry, 9), 920.0);
+
+    // Item 8 is located at 820,
+    // i.e. below visible rect
+    //
+    long first, end;
+
+    TGLStackedGeometryItemRange(&geometry, 0.0, 800.0, &first, &end);
+
+    TGLTestAssertEqualLong(first, 0);
+    TGLTestAssertEqualLong(end, 8);
+
+    TGLStackedGeometryItemRange(&geometry, 600.0, 800.0, &first, &end);
+
+    TGLTestAssertEqualLong(first, 1);
+    TGLTestAssertEqualLong(end, 8);
+
+    TGLTestStackedConsistency(&geometry);
+}
+
+static void TGLTestStackedPinned(void) {
+
+    TGLStackedParameters parameters = TGLTestStackedParameters(210.0);
+    TGLStackedGeometry geometry;
+    long firstCompressingItem = -1;
+
+    TGLStackedGeometryPrepare(&geometry, &parameters, &firstCompressingItem);
+
+    // Items 0...2 are above pinning
+    // offset 230 and item 0 hides
+    // below the top two
+    //
+    TGLTestAssertEqualLong(geometry.adjustment, TGLStackedAdjustmentNone);
+    TGLTestAssertEqualLong(geometry.pinnedItemCount, 3);
+    TGLTestAssertEqualDouble(TGLStackedGeometryOriginY(&geometry, 0), 230.0);
+    TGLTestAssertEqualDouble(TGLStackedGeometryOriginY(&geometry, 2), 230.0);
+    TGLTestAssertEqualDouble(TGLStackedGeometryOriginY(&geometry, 3), 320.0);
+    TGLTestAssertEqualLong(TGLStackedGeometryFlags(&geometry, 0), TGLLayoutItemFlagHidden);
+    TGLTestAssertEqualLong(TGLStackedGeometryFlags(&geometry, 1), 0);
+
+    long first, end;
+
+    TGLStackedGeometryItemRange(&geometry, 210.0, 1010.0, &first, &end);
+
+    TGLTestAssertEqualLong(first, 1);
+    TGLTestAssertEqualLong(end, 10);
+
+    TGLTestStackedConsistency(&geometry);
+}
+
+static void TGLTestStackedBouncing(void) {
+
+    // Expanding by 0.2 * 50pt per item
+    // when bouncing at the top
+    //
+    TGLStackedParameters parameters = TGLTestStackedParameters(-50.0);
+    TGLStackedGeometry geometry;
+    long firstCompressingItem = -1;
+
+    TGLStackedGeometryPrepare(&geometry, &parameters, &firstCompressingItem);
+
+    TGLTestAssertEqualLong(geometry.adjustment, TGLStackedAdjustmentExpanding);
+    TGLTestAssertEqualDouble(TGLStackedGeometryOriginY(&geometry, 0), 20.0);
+    TGLTestAssertEqualDouble(TGLStackedGeometryOriginY(&geometry, 3), 350.0);
+    TGLTestAssertEqualDouble(TGLStackedGeometryOriginY(&geometry, 9), 1010.0);
+
+    TGLTestStackedConsistency(&geometry);
+
+    // Compressing by 0.2 * 50pt per item
+    // relative to first unpinned item 3
+    // when bouncing at the bottom
+    //
+    parameters = TGLTestStackedParameters(270.0);
+
+    TGLStackedGeometryPrepare(&geometry, &parameters, &firstCompressingItem);
+
+    TGLTestAssertEqualLong(geometry.adjustment, TGLStackedAdjustmentCompressing);
+    TGLTestAssertEqualLong(geometry.pinnedItemCount, 3);
+    TGLTestAssertEqualLong(firstCompressingItem, 3);
+    TGLTestAssertEqualDouble(TGLStackedGeometryOriginY(&geometry, 2), 290.0);
+    TGLTestAssertEqualDouble(TGLStackedGeometryOriginY(&geometry, 3), 320.0);
+    TGLTestAssertEqualDouble(TGLStackedGeometryOriginY(&geometry, 4), 410.0);
+    TGLTestAssertEqualDouble(TGLStackedGeometryOriginY(&geometry, 9), 860.0);
+
+    TGLTestStackedConsistency(&geometry);
+
+    // Anchor is kept while bouncing continues,
+    // even though item 3 is pinned by now
+    //
+    parameters = TGLTestStackedParameters(320.0);
+
+    TGLStackedGeometryPrepare(&geometry, &parameters, &firstCompressingItem);
+
+    TGLTestAssertEqualLong(geometry.pinnedItemCount, 4);
+    TGLTestAssertEqualLong(geometry.compressingItem, 3);
+    TGLTestAssertEqualDouble(TGLStackedGeometryOriginY(&geometry, 3), 340.0);
+    TGLTestAssertEqualDouble(TGLStackedGeometryOriginY(&geometry, 4), 400.0);
+    TGLTestAssertEqualDouble(TGLStackedGeometryOriginY(&geometry, 9), 800.0);
+
+    TGLTestStackedConsistency(&geometry);
+
+    // Anchor is released when
+    // scrolled back into range
+    //
+    parameters = TGLTestStackedParameters(100.0);
+
+    TGLStackedGeometryPrepare(&geometry, &parameters, &firstCompressingItem);
+
+    TGLTestAssertEqualLong(firstCompressingItem, -1);
+}
+
+static void TGLTestStackedCenterSingleItem(void) {
+
+    TGLStackedParameters parameters = TGLTestStackedParameters(0.0);
+    TGLStackedGeometry geometry;
+    long firstCompressingItem = -1;
+
+    parameters.itemCount = 1;
+    parameters.contentHeight = 800.0;
+    parameters.centerSingleItem = true;
+
+    TGLStackedGeometryPrepare(&geometry, &parameters, &firstCompressingItem);
+
+    TGLTestAssertEqualLong(geometry.adjustment, TGLStackedAdjustmentCentering);
+    TGLTestAssertEqualDouble(TGLStackedGeometryOriginY(&geometry, 0), 160.0);
+}
+
+static void TGLTestStackedRevealTable(void) {
+
+    const double values[] = { 10.0, 20.0, 30.0, 40.0, 50.0, 60.0, 70.0, 80.0, 90.0, 100.0 };
+    TGLRevealTable table;
+
+    TGLRevealTableInit(&table);
+    TGLRevealTableReset(&table, values, 10);
+
+    TGLStackedParameters parameters = TGLTestStackedParameters(45.0);
+    TGLStackedGeometry geometry;
+    long firstCompressingItem = -1;
+
+    parameters.revealTable = &table;
+
+    TGLStackedGeometryPrepare(&geometry, &parameters, &firstCompressingItem);
+
+    // Items 0...3 are located at 20, 30, 50
+    // and 80, i.e. above pinning offset 65
+    //
+    TGLTestAssertEqualLong(geometry.pinnedItemCount, 3);
+    TGLTestAssertEqualDouble(TGLStackedGeometryOriginY(&geometry, 0), 65.0);
+    TGLTestAssertEqualDouble(TGLStackedGeometryOriginY(&geometry, 3), 80.0);
+    TGLTestAssertEqualDouble(TGLStackedGeometryOriginY(&geometry, 9), 470.0);
+
+    long first, end;
+
+    TGLStackedGeometryItemRange(&geometry, 45.0, 200.0, &first, &end);
+
+    TGLTestAssertEqualLong(first, 1);
+    TGLTestAssertEqualLong(end, 6);
+
+    TGLTestStackedConsistency(&geometry);
+
+    TGLRevealTableFree(&table);
+}
+
+static void TGLTestStackedItemRangeScaling(void) {
+
+    // Rect queries cost O(visible items), so for
+    // the same content offset the same items are
+    // returned regardless of the item count
+    //
+    const double offsets[] = { -100.0, 0.0, 500.0, 3333.0, 9000.0 };
+
+    for (int i = 0; i < 5; i++) {
+
+        long expectedFirst = -1, expectedEnd = -1;
+
+        for (long itemCount = 100; itemCount <= 1000000; itemCount *= 10) {
+
+            TGLStackedParameters parameters = TGLTestStackedParameters(offsets[i]);
+            TGLStackedGeometry geometry;
+            long firstCompressingItem = -1;
+
+            parameters.itemCount = itemCount;
+            parameters.contentHeight = parameters.marginTop + parameters.itemReveal * itemCount;
+
+            TGLStackedGeometryPrepare(&geometry, &parameters, &firstCompressingItem);
+
+            long first, end;
+
+            TGLStackedGeometryItemRange(&geometry, offsets[i], offsets[i] + parameters.boundsHeight, &first, &end);
+
+            // At most two pinned items, those revealed
+            // within bounds, and those reaching into
+            // bounds from above
+            //
+            TGLTestAssert(end - first <= 2 + (long)((parameters.boundsHeight + parameters.itemHeight) / parameters.itemReveal) + 1);
+
+            if (expectedFirst < 0) {
+
+                expectedFirst = first;
+                expectedEnd = end;
+
+            } else {
+
+                TGLTestAssertEqualLong(first, expectedFirst);
+                TGLTestAssertEqualLong(end, expectedEnd);
+            }
+        }
+    }
+}
+
+/** Returns in `first` and `end` the items intersecting the bounds at `contentOffset` */
+static void TGLTestStackedItemRangeAtOffset(TGLStackedParameters parameters, double contentOffset, long *first, long *end) {
+
+    TGLStackedGeometry geometry;
+    long firstCompressingItem = -1;
+
+    parameters.contentOffset = contentOffset;
+
+    TGLStackedGeometryPrepare(&geometry, &parameters, &firstCompressingItem);
+    TGLStackedGeometryItemRange(&geometry, contentOffset, contentOffset + parameters.boundsHeight, first, end);
+}
+
+static void TGLTestStackedPredictItemRange(void) {
+
+    TGLStackedParameters parameters = TGLTestStackedParameters(5000.0);
+
+    parameters.itemCount = 1000;
+    parameters.contentHeight = parameters.marginTop + parameters.itemReveal * parameters.itemCount;
+
+    double minOffset = -parameters.contentInsetTop;
+    double maxOffset = parameters.contentHeight - parameters.boundsHeight;
+    long currentFirst, currentEnd, targetFirst, targetEnd, first, end;
+
+    TGLTestStackedItemRangeAtOffset(parameters, 5000.0, &currentFirst, &currentEnd);
+
+    // Scrolling down predicts items at the
+    // bottom of the bounds at the target
+    // offset, not visible yet
+    //
+    TGLTestStackedItemRangeAtOffset(parameters, 6000.0, &targetFirst, &targetEnd);
+    TGLStackedGeometryPredictItemRange(&parameters, 2000.0, 0.5, &first, &end);
+
+    TGLTestAssertEqualLong(first, (currentEnd > targetFirst) ? currentEnd : targetFirst);
+    TGLTestAssertEqualLong(end, targetEnd);
+    TGLTestAssert(first < end);
+
+    // Scrolling up predicts items at the top
+    //
+    TGLTestStackedItemRangeAtOffset(parameters, 4000.0, &targetFirst, &targetEnd);
+    TGLStackedGeometryPredictItemRange(&parameters, -2000.0, 0.5, &first, &end);
+
+    TGLTestAssertEqualLong(first, targetFirst);
+    TGLTestAssertEqualLong(end, (currentFirst < targetEnd) ? currentFirst : targetEnd);
+    TGLTestAssert(first < end);
+
+    // Overlapping ranges only
+    // predict items not visible
+    //
+    TGLTestStackedItemRangeAtOffset(parameters, 5150.0, &targetFirst, &targetEnd);
+    TGLStackedGeometryPredictItemRange(&parameters, 300.0, 0.5, &first, &end);
+
+    TGLTestAssertEqualLong(first, currentEnd);
+    TGLTestAssertEqualLong(end, targetEnd);
+
+    TGLStackedGeometryPredictItemRange(&parameters, 0.0, 0.5, &first, &end);
+
+    TGLTestAssertEqualLong(end, first);
+
+    // Target offsets are clamped to
+    // the content's bottom edge...
+    //
+    parameters.contentOffset = maxOffset - 100.0;
+
+    TGLTestStackedItemRangeAtOffset(parameters, parameters.contentOffset, &currentFirst, &currentEnd);
+    TGLTestStackedItemRangeAtOffset(parameters, maxOffset, &targetFirst, &targetEnd);
+    TGLStackedGeometryPredictItemRange(&parameters, 100000.0, 0.5, &first, &end);
+
+    TGLTestAssertEqualLong(first, currentEnd);
+    TGLTestAssertEqualLong(end, targetEnd);
+    TGLTestAssertEqualLong(end, parameters.itemCount);
+
+    parameters.contentOffset = maxOffset;
+
+    TGLStackedGeometryPredictItemRange(&parameters, 2000.0, 0.5, &first, &end);
+
+    TGLTestAssertEqualLong(end, first);
+
+    // ...and to its top edge
+    //
+    parameters.contentOffset = minOffset + 100.0;
+
+    TGLTestStackedItemRangeAtOffset(parameters, parameters.contentOffset, &currentFirst, &currentEnd);
+    TGLTestStackedItemRangeAtOffset(parameters, minOffset, &targetFirst, &targetEnd);
+    TGLStackedGeometryPredictItemRange(&parameters, -100000.0, 0.5, &first, &end);
+
+    TGLTestAssertEqualLong(first, targetFirst);
+    TGLTestAssertEqualLong(first, 0);
+    TGLTestAssertEqualLong(end, (currentFirst < targetEnd) ? currentFirst : targetEnd);
+
+    parameters.contentOffset = minOffset;
+
+    TGLStackedGeometryPredictItemRange(&parameters, -2000.0, 0.5, &first, &end);
+
+    TGLTestAssertEqualLong(end, first);
+}
+
+static void TGLTestStackedOcclusion(void) {
+
+    TGLStackedParameters parameters = TGLTestStackedParameters(0.0);
+    TGLStackedGeometry geometry;
+    long firstCompressingItem = -1;
+
+    parameters.itemReveal = 0.5;
+    parameters.contentHeight = 800.0;
+    parameters.occlusionThreshold = 1.0;
+
+    TGLStackedGeometryPrepare(&geometry, &parameters, &firstCompressingItem);
+
+    // Items revealing half a point are covered
+    // by their successors but the last one
+    //
+    for (long item = 0; item < 9; item++) TGLTestAssertEqualLong(TGLStackedGeometryFlags(&geometry, item), TGLLayoutItemFlagHidden);
+
+    TGLTestAssertEqualLong(TGLStackedGeometryFlags(&geometry, 9), 0);
+
+    TGLTestStackedConsistency(&geometry);
+
+    // Items revealing exactly the threshold
+    // remain visible
+    //
+    parameters.itemReveal = 1.0;
+
+    TGLStackedGeometryPrepare(&geometry, &parameters, &firstCompressingItem);
+
+    for (long item = 0; item < 10; item++) TGLTestAssertEqualLong(TGLStackedGeometryFlags(&geometry, item), 0);
+
+    // Items compressed below the threshold when
+    // bouncing at the bottom are hidden, those
+    // pinned at the top are not affected
+    //
+    parameters = TGLTestStackedParameters(720.0);
+    parameters.occlusionThreshold = 1.0;
+
+    TGLStackedGeometryPrepare(&geometry, &parameters, &firstCompressingItem);
+
+    TGLTestAssertEqualDouble(geometry.adjustmentOffset, 100.0);
+    TGLTestAssertEqualLong(geometry.pinnedItemCount, 8);
+    TGLTestAssertEqualLong(TGLStackedGeometryFlags(&geometry, 6), 0);
+    TGLTestAssertEqualLong(TGLStackedGeometryFlags(&geometry, 7), 0);
+    TGLTestAssertEqualLong(TGLStackedGeometryFlags(&geometry, 8), TGLLayoutItemFlagHidden);
+    TGLTestAssertEqualLong(TGLStackedGeometryFlags(&geometry, 9), 0);
+
+    TGLTestStackedConsistency(&geometry);
+}
+
+// MARK: - Exposed geometry
+
+static void TGLTestExposedPinningNone(void) {
+
+    TGLExposedParameters parameters = TGLTestExposedParameters(TGLExposedPinningNone);
+    TGLExposedGeometry geometry;
+
+    TGLExposedGeometryPrepare(&geometry, &parameters);
+
+    // Overlapping items are added until
+    // they reach the bottom, i.e. all
+    // items below exposed item overlap
+    //
+    TGLTestAssertEqualLong(geometry.bottomOverlapCount, 6);
+
+    TGLTestAssertEqualDouble(TGLExposedGeometryOriginY(&geometry, 2), 30.0);
+    TGLTestAssertEqualLong(TGLExposedGeometryFlags(&geometry, 2), TGLLayoutItemFlagHidden);
+    TGLTestAssertEqualDouble(TGLExposedGeometryOriginY(&geometry, 3), 30.0);
+    TGLTestAssertEqualLong(TGLExposedGeometryFlags(&geometry, 3), 0);
+    TGLTestAssertEqualDouble(TGLExposedGeometryOriginY(&geometry, 4), 40.0);
+    TGLTestAssertEqualDouble(TGLExposedGeometryOriginY(&geometry, 5), 530.0);
+    TGLTestAssertEqualDouble(TGLExposedGeometryOriginY(&geometry, 9), 570.0);
+    TGLTestAssertEqualLong(TGLExposedGeometryFlags(&geometry, 9), 0);
+
+    long first[TGLExposedGeometryMaxRangeCount], end[TGLExposedGeometryMaxRangeCount];
+    long count = TGLExposedGeometryItemRanges(&geometry, 0.0, 800.0, first, end);
+
+    TGLTestAssertEqualLong(count, 3);
+    TGLTestAssertEqualLong(first[0], 3);
+    TGLTestAssertEqualLong(end[0], 4);
+    TGLTestAssertEqualLong(first[1], 4);
+    TGLTestAssertEqualLong(end[1], 5);
+    TGLTestAssertEqualLong(first[2], 5);
+    TGLTestAssertEqualLong(end[2], 10);
+
+    // Items below exposed item
+    // start at 530
+    //
+    count = TGLExposedGeometryItemRanges(&geometry, 0.0, 100.0, first, end);
+
+    TGLTestAssertEqualLong(count, 2);
+    TGLTestAssertEqualLong(first[0], 3);
+    TGLTestAssertEqualLong(end[1], 5);
+}
+
+static void TGLTestExposedPinningBelow(void) {
+
+    TGLExposedParameters parameters = TGLTestExposedParameters(TGLExposedPinningBelow);
+    TGLExposedGeometry geometry;
+
+    TGLExposedGeometryPrepare(&geometry, &parameters);
+
+    TGLTestAssertEqualLong(geometry.bottomPinningCount, 5);
+    TGLTestAssertEqualDouble(TGLExposedGeometryOriginY(&geometry, 3), 30.0);
+    TGLTestAssertEqualDouble(TGLExposedGeometryOriginY(&geometry, 5), 750.0);
+    TGLTestAssertEqualDouble(TGLExposedGeometryOriginY(&geometry, 9), 790.0);
+
+    // Pin two items only, hiding the rest
+    //
+    parameters.bottomPinningCount = 2;
+
+    TGLExposedGeometryPrepare(&geometry, &parameters);
+
+    TGLTestAssertEqualDouble(TGLExposedGeometryOriginY(&geometry, 5), 780.0);
+    TGLTestAssertEqualDouble(TGLExposedGeometryOriginY(&geometry, 6), 790.0);
+    TGLTestAssertEqualLong(TGLExposedGeometryFlags(&geometry, 6), 0);
+    TGLTestAssertEqualDouble(TGLExposedGeometryOriginY(&geometry, 7), 800.0);
+    TGLTestAssertEqualLong(TGLExposedGeometryFlags(&geometry, 7), TGLLayoutItemFlagHidden);
+
+    long first[TGLExposedGeometryMaxRangeCount], end[TGLExposedGeometryMaxRangeCount];
+    long count = TGLExposedGeometryItemRanges(&geometry, 0.0, 800.0, first, end);
+
+    TGLTestAssertEqualLong(count, 3);
+    TGLTestAssertEqualLong(first[2], 5);
+    TGLTestAssertEqualLong(end[2], 7);
+}
+
+static void TGLTestExposedPinningAll(void) {
+
+    TGLExposedParameters parameters = TGLTestExposedParameters(TGLExposedPinningAll);
+    TGLExposedGeometry geometry;
+
+    parameters.topPinningCount = 2;
+
+    TGLExposedGeometryPrepare(&geometry, &parameters);
+
+    // Two items above exposed item are
+    // pinned below those pinned from
+    // below exposed item
+    //
+    TGLTestAssertEqualDouble(TGLExposedGeometryOriginY(&geometry, 1), 800.0);
+    TGLTestAssertEqualLong(TGLExposedGeometryFlags(&geometry, 1), TGLLayoutItemFlagHidden);
+    TGLTestAssertEqualDouble(TGLExposedGeometryOriginY(&geometry, 2), 730.0);
+    TGLTestAssertEqualDouble(TGLExposedGeometryOriginY(&geometry, 3), 740.0);
+    TGLTestAssertEqualDouble(TGLExposedGeometryOriginY(&geometry, 4), 40.0);
+    TGLTestAssertEqualDouble(TGLExposedGeometryOriginY(&geometry, 5), 750.0);
+
+    long first[TGLExposedGeometryMaxRangeCount], end[TGLExposedGeometryMaxRangeCount];
+    long count = TGLExposedGeometryItemRanges(&geometry, 0.0, 800.0, first, end);
+
+    TGLTestAssertEqualLong(count, 3);
+    TGLTestAssertEqualLong(first[0], 2);
+    TGLTestAssertEqualLong(end[0], 4);
+    TGLTestAssertEqualLong(first[2], 5);
+    TGLTestAssertEqualLong(end[2], 10);
+}
+
+// MARK: - Main
+
+int main(void) {
+
+    TGLTestSectionTable();
+
+    TGLTestItemUpdateMap();
+    TGLTestLongestIncreasingSubsequence();
+
+    TGLTestRevealTable();
+    TGLTestRevealTableEdits();
+    TGLTestRevealTableUpdate();
+    TGLTestRevealTableConcurrentReset();
+
+    TGLTestLayoutCache();
+
+    TGLTestStackedAtTop();
+    TGLTestStackedPinned();
+    TGLTestStackedBouncing();
+    TGLTestStackedCenterSingleItem();
+    TGLTestStackedRevealTable();
+    TGLTestStackedItemRangeScaling();
+    TGLTestStackedPredictItemRange();
+    TGLTestStackedOcclusion();
+
+    TGLTestExposedPinningNone();
+    TGLTestExposedPinningBelow();
+    TGLTestExposedPinningAll();
+
+    return TGLTestFinish("TGLLayoutGeometryTests");
+}
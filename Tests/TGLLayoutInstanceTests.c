@@ -0,0 +1,261 @@
+//
+//  TGLLayoutInstanceTests.c
+//  TGLStackedViewController
+//
+//  Created by Tim Gleue on 17.10.26.
+//  Copyright (c) 2026 Tim Gleue ( http://gleue-interactive.com )
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+/* Headless test of independent layout instances.
+ *
+ * Drives two stacked layouts with different configurations
+ * concurrently on two threads, each keeping its own reveal
+ * table and compression anchor the way `TGLStackedLayout`
+ * does. Results of each thread must match those of the same
+ * layout driven alone, i.e. layout passes must not share
+ * any state.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include "TGLLayoutGeometry.h"
+#include "TGLTestAssertions.h"
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+static const long TGLTestFrameCount = 2000;
+static const long TGLTestRepeatCount = 20;
+
+// MARK: - Layout instance
+
+/** State owned by one layout instance */
+typedef struct {
+
+    long itemCount;
+    double itemReveal;
+    bool usesRevealTable;
+
+    TGLRevealTable revealTable;
+    long firstCompressingItem;
+
+    uint64_t checksum;          /* Hash of origins, flags and anchors of all frames */
+
+} TGLTestLayout;
+
+static void TGLTestLayoutInit(TGLTestLayout *layout, long itemCount, double itemReveal, bool usesRevealTable) {
+
+    layout->itemCount = itemCount;
+    layout->itemReveal = itemReveal;
+    layout->usesRevealTable = usesRevealTable;
+    layout->firstCompressingItem = -1;
+    layout->checksum = 0;
+
+    TGLRevealTableInit(&layout->revealTable);
+
+    if (usesRevealTable) {
+
+        double *values = malloc(itemCount * sizeof(double));
+
+        for (long item = 0; item < itemCount; item++) values[item] = itemReveal * (0.5 + (item % 3) * 0.5);
+
+        TGLRevealTableReset(&layout->revealTable, values, itemCount);
+
+        free(values);
+    }
+}
+
+static void TGLTestLayoutFree(TGLTestLayout *layout) {
+
+    TGLRevealTableFree(&layout->revealTable);
+}
+
+static uint64_t TGLTestHash(uint64_t hash, int64_t value) {
+
+    // FNV-1a over the value's bytes
+    //
+    if (hash == 0) hash = 0xcbf29ce484222325ULL;
+
+    for (int i = 0; i < 8; i++) {
+
+        hash ^= (uint64_t)(value >> (8 * i)) & 0xff;
+        hash *= 0x100000001b3ULL;
+    }
+
+    return hash;
+}
+
+/** Sweeps content offset from bouncing at top to bouncing at bottom and back */
+static void TGLTestLayoutSweep(TGLTestLayout *layout) {
+
+    const double boundsHeight = 800.0;
+    const double marginTop = 20.0;
+    const double stackHeight = layout->usesRevealTable ? TGLRevealTableTotal(&layout->revealTable) : layout->itemReveal * layout->itemCount;
+    const double contentHeight = fmax(marginTop + stackHeight, boundsHeight);
+
+    TGLStackedParameters parameters = {
+
+        .itemCount = layout->itemCount,
+        .itemReveal = layout->itemReveal,
+        .itemHeight = 500.0,
+        .revealTable = layout->usesRevealTable ? &layout->revealTable : NULL,
+        .marginTop = marginTop,
+        .layoutHeight = boundsHeight - marginTop,
+        .boundsHeight = boundsHeight,
+        .contentHeight = contentHeight,
+        .contentInsetTop = 0.0,
+        .bounceFactor = 0.2
+    };
+
+    double minOffset = -150.0;
+    double maxOffset = contentHeight - boundsHeight + 150.0;
+    double originY[64];
+    TGLLayoutItemFlags flags[64];
+    TGLStackedGeometry geometry;
+
+    for (long frame = 0; frame < TGLTestFrameCount; frame++) {
+
+        double phase = (double)frame / (TGLTestFrameCount - 1);
+
+        phase = (phase < 0.5) ? 2.0 * phase : 2.0 - 2.0 * phase;
+
+        parameters.contentOffset = minOffset + (maxOffset - minOffset) * phase;
+
+        TGLStackedGeometryPrepare(&geometry, &parameters, &layout->firstCompressingItem);
+
+        long first, end;
+
+        TGLStackedGeometryItemRange(&geometry, parameters.contentOffset, parameters.contentOffset + boundsHeight, &first, &end);
+
+        if (end - first > 64) end = first + 64;
+
+        TGLStackedGeometryGetItems(&geometry, first, end - first, originY, flags);
+
+        layout->checksum = TGLTestHash(layout->checksum, layout->firstCompressingItem);
+
+        for (long i = 0; i < end - first; i++) {
+
+            layout->checksum = TGLTestHash(layout->checksum, (int64_t)llround(originY[i] * 64.0));
+            layout->checksum = TGLTestHash(layout->checksum, flags[i]);
+        }
+    }
+}
+
+static void *TGLTestLayoutThread(void *context) {
+
+    TGLTestLayout *layout = context;
+
+    for (long repeat = 0; repeat < TGLTestRepeatCount; repeat++) TGLTestLayoutSweep(layout);
+
+    return NULL;
+}
+
+// MARK: - Tests
+
+static void TGLTestConcurrentLayouts(void) {
+
+    TGLTestLayout layouts[2];
+    uint64_t expected[2];
+
+    TGLTestLayoutInit(&layouts[0], 200, 100.0, false);
+    TGLTestLayoutInit(&layouts[1], 5000, 60.0, true);
+
+    // Reference results of each
+    // layout driven alone ...
+    //
+    for (int i = 0; i < 2; i++) {
+
+        TGLTestLayoutThread(&layouts[i]);
+
+        expected[i] = layouts[i].checksum;
+
+        layouts[i].checksum = 0;
+        layouts[i].firstCompressingItem = -1;
+    }
+
+    TGLTestAssert(expected[0] != expected[1]);
+
+    // ... must match results when
+    // driven at the same time
+    //
+    pthread_t threads[2];
+
+    for (int i = 0; i < 2; i++) TGLTestAssertEqualLong(pthread_create(&threads[i], NULL, TGLTestLayoutThread, &layouts[i]), 0);
+    for (int i = 0; i < 2; i++) TGLTestAssertEqualLong(pthread_join(threads[i], NULL), 0);
+
+    for (int i = 0; i < 2; i++) {
+
+        TGLTestAssert(layouts[i].checksum == expected[i]);
+
+        TGLTestLayoutFree(&layouts[i]);
+    }
+}
+
+static void TGLTestIndependentAnchors(void) {
+
+    // Bouncing one layout at the bottom must
+    // not move the other layout's anchor
+    //
+    TGLTestLayout layouts[2];
+
+    TGLTestLayoutInit(&layouts[0], 10, 100.0, false);
+    TGLTestLayoutInit(&layouts[1], 10, 100.0, false);
+
+    TGLStackedParameters parameters = {
+
+        .itemCount = 10,
+        .itemReveal = 100.0,
+        .itemHeight = 500.0,
+        .marginTop = 20.0,
+        .layoutHeight = 780.0,
+        .boundsHeight = 800.0,
+        .contentHeight = 1020.0,
+        .contentOffset = 270.0,
+        .bounceFactor = 0.2
+    };
+
+    TGLStackedGeometry geometry;
+
+    TGLStackedGeometryPrepare(&geometry, &parameters, &layouts[0].firstCompressingItem);
+
+    TGLTestAssertEqualLong(layouts[0].firstCompressingItem, 3);
+    TGLTestAssertEqualLong(layouts[1].firstCompressingItem, -1);
+
+    parameters.contentOffset = 320.0;
+
+    TGLStackedGeometryPrepare(&geometry, &parameters, &layouts[1].firstCompressingItem);
+
+    TGLTestAssertEqualLong(layouts[0].firstCompressingItem, 3);
+    TGLTestAssertEqualLong(layouts[1].firstCompressingItem, 4);
+
+    TGLTestLayoutFree(&layouts[0]);
+    TGLTestLayoutFree(&layouts[1]);
+}
+
+// MARK: - Main
+
+int main(void) {
+
+    TGLTestConcurrentLayouts();
+    TGLTestIndependentAnchors();
+
+    return TGLTestFinish("TGLLayoutInstanceTests");
+}
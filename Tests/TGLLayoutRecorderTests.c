@@ -0,0 +1,136 @@
+//
+//  TGLLayoutRecorderTests.c
+//  TGLStackedViewController
+//
+//  Created by Tim Gleue on 17.10.26.
+//  Copyright (c) 2026 Tim Gleue ( http://gleue-interactive.com )
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+/* Headless tests of layout metrics recording.
+ *
+ * Records passes, items and queries, checking cumulative
+ * counters, per-pass allocation counts and percentiles.
+ */
+
+#include "TGLLayoutRecorder.h"
+#include "TGLTestAssertions.h"
+
+// MARK: - Counters
+
+static void TGLTestCounters(void) {
+
+    TGLLayoutRecorder recorder;
+
+    TGLLayoutRecorderReset(&recorder);
+
+    TGLLayoutRecorderBeginPass(&recorder, 2);
+    TGLLayoutRecorderRecordPass(&recorder, 0.002, 12);
+    TGLLayoutRecorderRecordItems(&recorder, 10, 5);
+    TGLLayoutRecorderRecordQuery(&recorder, 8, 3);
+    TGLLayoutRecorderBeginPass(&recorder, 5);
+    TGLLayoutRecorderRecordPass(&recorder, 0.004, 40);
+    TGLLayoutRecorderBeginPass(&recorder, 0);
+    TGLLayoutRecorderRecordPass(&recorder, 0.001, 0);
+
+    TGLTestAssertEqualLong(recorder.counters.passCount, 3);
+    TGLTestAssertEqualDouble(recorder.counters.passDuration, 0.007);
+    TGLTestAssertEqualDouble(recorder.counters.maxPassDuration, 0.004);
+    TGLTestAssertEqualLong(recorder.counters.queryCount, 1);
+    TGLTestAssertEqualLong(recorder.counters.returnedCount, 8);
+    TGLTestAssertEqualLong(recorder.counters.visibleCount, 10);
+    TGLTestAssertEqualLong(recorder.counters.hiddenCount, 5);
+
+    // Allocations before the first pass count
+    // only toward the cumulative count, those
+    // of queries and up to the next pass toward
+    // the pass still in progress
+    //
+    TGLTestAssertEqualLong(recorder.counters.allocationCount, 62);
+    TGLTestAssertEqualLong(recorder.counters.passAllocationCount, 0);
+    TGLTestAssertEqualLong(recorder.counters.lastPassAllocationCount, 40);
+    TGLTestAssertEqualLong(recorder.counters.maxPassAllocationCount, 40);
+
+    TGLLayoutRecorderRecordQuery(&recorder, 4, 7);
+
+    TGLTestAssertEqualLong(recorder.counters.allocationCount, 69);
+    TGLTestAssertEqualLong(recorder.counters.passAllocationCount, 7);
+    TGLTestAssertEqualLong(recorder.counters.lastPassAllocationCount, 40);
+
+    // Item queries report their allocations
+    // when the next pass begins
+    //
+    TGLLayoutRecorderBeginPass(&recorder, 1);
+
+    TGLTestAssertEqualLong(recorder.counters.allocationCount, 70);
+    TGLTestAssertEqualLong(recorder.counters.passAllocationCount, 0);
+    TGLTestAssertEqualLong(recorder.counters.lastPassAllocationCount, 8);
+    TGLTestAssertEqualLong(recorder.counters.maxPassAllocationCount, 40);
+
+    TGLLayoutRecorderRecordPass(&recorder, 0.001, 6);
+    TGLLayoutRecorderRecordQuery(&recorder, 4, 50);
+    TGLLayoutRecorderBeginPass(&recorder, 0);
+
+    TGLTestAssertEqualLong(recorder.counters.lastPassAllocationCount, 56);
+    TGLTestAssertEqualLong(recorder.counters.maxPassAllocationCount, 56);
+
+    TGLLayoutRecorderReset(&recorder);
+
+    TGLTestAssertEqualLong(recorder.counters.passCount, 0);
+    TGLTestAssertEqualLong(recorder.counters.allocationCount, 0);
+    TGLTestAssertEqualLong(recorder.counters.passAllocationCount, 0);
+    TGLTestAssertEqualLong(recorder.counters.lastPassAllocationCount, 0);
+    TGLTestAssertEqualLong(recorder.counters.maxPassAllocationCount, 0);
+}
+
+// MARK: - Percentiles
+
+static void TGLTestPercentiles(void) {
+
+    TGLLayoutRecorder recorder;
+
+    TGLLayoutRecorderReset(&recorder);
+
+    TGLTestAssertEqualDouble(TGLLayoutRecorderPassDurationPercentile(&recorder, 0.5), 0.0);
+
+    for (int i = 1; i <= 5; i++) TGLLayoutRecorderRecordPass(&recorder, 0.001 * i, 0);
+
+    TGLTestAssertEqualDouble(TGLLayoutRecorderPassDurationPercentile(&recorder, 0.0), 0.001);
+    TGLTestAssertEqualDouble(TGLLayoutRecorderPassDurationPercentile(&recorder, 0.5), 0.003);
+    TGLTestAssertEqualDouble(TGLLayoutRecorderPassDurationPercentile(&recorder, 1.0), 0.005);
+    TGLTestAssertEqualDouble(TGLLayoutRecorderPassDurationPercentile(&recorder, 2.0), 0.005);
+
+    // Only recent samples count, older
+    // ones are overwritten in the ring
+    //
+    for (int i = 0; i < TGLLayoutRecorderSampleCount; i++) TGLLayoutRecorderRecordPass(&recorder, 0.010, 0);
+
+    TGLTestAssertEqualDouble(TGLLayoutRecorderPassDurationPercentile(&recorder, 0.0), 0.010);
+    TGLTestAssertEqualDouble(recorder.counters.maxPassDuration, 0.010);
+}
+
+// MARK: - Main
+
+int main(void) {
+
+    TGLTestCounters();
+    TGLTestPercentiles();
+
+    return TGLTestFinish("TGLLayoutRecorderTests");
+}
@@ -0,0 +1,346 @@
+//
+//  TGLLayoutTraceTests.c
+//  TGLStackedViewController
+//
+//  Created by Tim Gleue on 17.10.26.
+//  Copyright (c) 2026 Tim Gleue ( http://gleue-interactive.com )
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+/* Headless tests of the layout trace encoding.
+ *
+ * Round-trips headers and frames through encoding and
+ * decoding, and checks that the reference trace in folder
+ * `Fixtures` decodes into frames which encode to the very
+ * same bytes again. The reference trace is a synthetic
+ * recording of 100 items being flung with bounce, exposed,
+ * collapsed by pinching, and moved. Its replay checksum is
+ * checked by `make test` as well.
+ */
+
+#include "TGLLayoutTrace.h"
+#include "TGLTestAssertions.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TGLTestFixturePath = "Tests/Fixtures/TGLLayoutTrace.bin";
+
+// MARK: - Helpers
+
+static void TGLTestAssertEqualFrames(const TGLLayoutTraceFrame *frame, const TGLLayoutTraceFrame *expected) {
+
+    TGLTestAssert(fabs(frame->time - expected->time) < 1e-6);
+    TGLTestAssertEqualDouble(frame->contentOffset, expected->contentOffset);
+    TGLTestAssertEqualDouble(frame->boundsWidth, expected->boundsWidth);
+    TGLTestAssertEqualDouble(frame->boundsHeight, expected->boundsHeight);
+    TGLTestAssertEqualDouble(frame->contentInsetTop, expected->contentInsetTop);
+    TGLTestAssertEqualDouble(frame->contentInsetBottom, expected->contentInsetBottom);
+    TGLTestAssertEqualLong(frame->itemCount, expected->itemCount);
+    TGLTestAssertEqualDouble(frame->transitionProgress, expected->transitionProgress);
+    TGLTestAssertEqualLong(frame->exposedItem, expected->exposedItem);
+    TGLTestAssertEqualLong(frame->movingItem, expected->movingItem);
+    TGLTestAssertEqualDouble(frame->moveTargetX, expected->moveTargetX);
+    TGLTestAssertEqualDouble(frame->moveTargetY, expected->moveTargetY);
+}
+
+/** Encodes `frame`, checks the result decodes to the same frame and returns the encoded length */
+static size_t TGLTestRoundTripFrame(const TGLLayoutTraceFrame *frame, TGLLayoutTraceFrame *previous, TGLLayoutTraceFrame *decoded) {
+
+    unsigned char bytes[TGLLayoutTraceMaxFrameSize + 1];
+
+    bytes[TGLLayoutTraceMaxFrameSize] = 0xa5;
+
+    size_t length = TGLLayoutTraceEncodeFrame(frame, previous, bytes);
+
+    TGLTestAssert(length <= TGLLayoutTraceMaxFrameSize);
+    TGLTestAssertEqualLong(bytes[TGLLayoutTraceMaxFrameSize], 0xa5);
+
+    if (length == 0) return 0;
+
+    // Frames cut short are not decoded
+    //
+    for (size_t cut = 0; cut < length; cut++) {
+
+        TGLLayoutTraceFrame partial = *decoded;
+
+        TGLTestAssertEqualLong(TGLLayoutTraceDecodeFrame(bytes, cut, &partial), 0);
+    }
+
+    TGLTestAssertEqualLong(TGLLayoutTraceDecodeFrame(bytes, length, decoded), length);
+
+    TGLTestAssertEqualFrames(decoded, frame);
+    TGLTestAssertEqualFrames(previous, frame);
+
+    return length;
+}
+
+static unsigned char *TGLTestReadFile(const char *path, size_t *length) {
+
+    FILE *file = fopen(path, "rb");
+
+    if (file == NULL) return NULL;
+
+    size_t capacity = 1 << 16;
+    unsigned char *bytes = malloc(capacity);
+
+    *length = 0;
+
+    while (bytes) {
+
+        *length += fread(bytes + *length, 1, capacity - *length, file);
+
+        if (*length < capacity) break;
+
+        capacity *= 2;
+        bytes = realloc(bytes, capacity);
+    }
+
+    fclose(file);
+
+    return bytes;
+}
+
+// MARK: - Tests
+
+static void TGLTestHeaderRoundTrip(void) {
+
+    TGLLayoutTraceHeader header = {
+
+        .marginTop = 20.0,
+        .marginBottom = 4.5,
+        .itemHeight = 0.0,
+        .itemReveal = 120.0,
+        .bounceFactor = 0.2,
+        .occlusionThreshold = 1.0,
+        .fillHeight = true,
+        .centerSingleItem = false,
+        .alwaysBounce = true,
+
+        .exposedMarginTop = 40.0,
+        .exposedMarginBottom = 0.0,
+        .exposedItemHeight = 480.25,
+        .exposedTopOverlap = 10.0,
+        .exposedBottomOverlap = 12.0,
+        .exposedBottomOverlapCount = 3,
+        .exposedPinning = TGLExposedPinningBelow,
+        .exposedTopPinningCount = -1,
+        .exposedBottomPinningCount = 7
+    };
+
+    unsigned char bytes[TGLLayoutTraceHeaderSize];
+    TGLLayoutTraceHeader decoded;
+
+    TGLLayoutTraceEncodeHeader(&header, bytes);
+
+    TGLTestAssert(TGLLayoutTraceDecodeHeader(bytes, sizeof(bytes), &decoded));
+
+    TGLTestAssertEqualDouble(decoded.marginTop, header.marginTop);
+    TGLTestAssertEqualDouble(decoded.marginBottom, header.marginBottom);
+    TGLTestAssertEqualDouble(decoded.itemHeight, header.itemHeight);
+    TGLTestAssertEqualDouble(decoded.itemReveal, header.itemReveal);
+    TGLTestAssertEqualDouble(decoded.bounceFactor, header.bounceFactor);
+    TGLTestAssertEqualDouble(decoded.occlusionThreshold, header.occlusionThreshold);
+    TGLTestAssert(decoded.fillHeight == header.fillHeight);
+    TGLTestAssert(decoded.centerSingleItem == header.centerSingleItem);
+    TGLTestAssert(decoded.alwaysBounce == header.alwaysBounce);
+
+    TGLTestAssertEqualDouble(decoded.exposedMarginTop, header.exposedMarginTop);
+    TGLTestAssertEqualDouble(decoded.exposedMarginBottom, header.exposedMarginBottom);
+    TGLTestAssertEqualDouble(decoded.exposedItemHeight, header.exposedItemHeight);
+    TGLTestAssertEqualDouble(decoded.exposedTopOverlap, header.exposedTopOverlap);
+    TGLTestAssertEqualDouble(decoded.exposedBottomOverlap, header.exposedBottomOverlap);
+    TGLTestAssertEqualLong(decoded.exposedBottomOverlapCount, header.exposedBottomOverlapCount);
+    TGLTestAssertEqualLong(decoded.exposedPinning, header.exposedPinning);
+    TGLTestAssertEqualLong(decoded.exposedTopPinningCount, header.exposedTopPinningCount);
+    TGLTestAssertEqualLong(decoded.exposedBottomPinningCount, header.exposedBottomPinningCount);
+
+    // Truncated, foreign and future headers are rejected
+    //
+    TGLTestAssert(!TGLLayoutTraceDecodeHeader(bytes, sizeof(bytes) - 1, &decoded));
+
+    bytes[0] = 'X';
+
+    TGLTestAssert(!TGLLayoutTraceDecodeHeader(bytes, sizeof(bytes), &decoded));
+
+    TGLLayoutTraceEncodeHeader(&header, bytes);
+
+    bytes[4] = TGLLayoutTraceVersion + 1;
+
+    TGLTestAssert(!TGLLayoutTraceDecodeHeader(bytes, sizeof(bytes), &decoded));
+}
+
+static void TGLTestFrameRoundTrip(void) {
+
+    TGLLayoutTraceFrame frame, previous, decoded;
+
+    TGLLayoutTraceFrameInit(&frame);
+    TGLLayoutTraceFrameInit(&previous);
+    TGLLayoutTraceFrameInit(&decoded);
+
+    // Nothing changed, nothing encoded
+    //
+    unsigned char bytes[TGLLayoutTraceMaxFrameSize];
+
+    TGLTestAssertEqualLong(TGLLayoutTraceEncodeFrame(&frame, &previous, bytes), 0);
+
+    // First frame carries all of the
+    // collection view's state ...
+    //
+    frame.time = 0.5;
+    frame.contentOffset = -44.0;
+    frame.boundsWidth = 375.0;
+    frame.boundsHeight = 812.0;
+    frame.contentInsetTop = 44.0;
+    frame.contentInsetBottom = 34.0;
+    frame.itemCount = 100000;
+
+    TGLTestAssertEqualLong(TGLTestRoundTripFrame(&frame, &previous, &decoded), 1 + 4 + 4 + 16 + 4);
+
+    // ... while following frames carry
+    // changed values only
+    //
+    frame.time += 1.0 / 120.0;
+    frame.contentOffset = 1234.5;
+
+    TGLTestAssertEqualLong(TGLTestRoundTripFrame(&frame, &previous, &decoded), 1 + 4 + 4);
+
+    frame.time += 1.0 / 120.0;
+    frame.exposedItem = 42;
+
+    TGLTestAssertEqualLong(TGLTestRoundTripFrame(&frame, &previous, &decoded), 1 + 4 + 4);
+
+    frame.time += 1.0 / 120.0;
+    frame.transitionProgress = 0.25;
+
+    TGLTestAssertEqualLong(TGLTestRoundTripFrame(&frame, &previous, &decoded), 1 + 4 + 4);
+
+    frame.time += 1.0 / 120.0;
+    frame.transitionProgress = -1.0;
+    frame.exposedItem = -1;
+    frame.movingItem = 17;
+    frame.moveTargetX = 187.5;
+    frame.moveTargetY = 2000.25;
+
+    TGLTestAssertEqualLong(TGLTestRoundTripFrame(&frame, &previous, &decoded), TGLLayoutTraceMaxFrameSize - 4 - 16 - 4);
+
+    // Changes below encoded precision and
+    // move targets without moving item
+    // are not encoded
+    //
+    frame.time += 1.0 / 120.0;
+    frame.contentOffset += 1e-6;
+
+    TGLTestAssertEqualLong(TGLLayoutTraceEncodeFrame(&frame, &previous, bytes), 0);
+
+    frame.movingItem = -1;
+
+    TGLTestAssertEqualLong(TGLTestRoundTripFrame(&frame, &previous, &decoded), 1 + 4 + 12);
+
+    frame.moveTargetX = 0.0;
+
+    TGLTestAssertEqualLong(TGLLayoutTraceEncodeFrame(&frame, &previous, bytes), 0);
+
+    // All values at once take up
+    // maximum frame size
+    //
+    frame.time += 1.0;
+    frame.contentOffset = -100.0;
+    frame.boundsWidth = 812.0;
+    frame.boundsHeight = 375.0;
+    frame.contentInsetTop = 0.0;
+    frame.contentInsetBottom = 21.0;
+    frame.itemCount = 3;
+    frame.transitionProgress = 1.0;
+    frame.exposedItem = 2;
+    frame.movingItem = 0;
+    frame.moveTargetX = 10.0;
+    frame.moveTargetY = 20.0;
+
+    TGLTestAssertEqualLong(TGLTestRoundTripFrame(&frame, &previous, &decoded), TGLLayoutTraceMaxFrameSize);
+
+    // Unknown values are rejected
+    //
+    bytes[0] = 0x80;
+
+    TGLTestAssertEqualLong(TGLLayoutTraceDecodeFrame(bytes, sizeof(bytes), &decoded), 0);
+}
+
+static void TGLTestFixture(const char *path) {
+
+    size_t length = 0;
+    unsigned char *bytes = TGLTestReadFile(path, &length);
+
+    TGLTestAssert(bytes != NULL);
+
+    if (bytes == NULL) return;
+
+    TGLLayoutTraceHeader header;
+
+    TGLTestAssert(TGLLayoutTraceDecodeHeader(bytes, length, &header));
+    TGLTestAssertEqualDouble(header.itemReveal, 120.0);
+    TGLTestAssertEqualLong(header.exposedPinning, TGLExposedPinningAll);
+
+    // Decoded frames encode to the same
+    // bytes they were decoded from
+    //
+    TGLLayoutTraceFrame frame, previous;
+    size_t offset = TGLLayoutTraceHeaderSize;
+    long frameCount = 0;
+
+    TGLLayoutTraceFrameInit(&frame);
+    TGLLayoutTraceFrameInit(&previous);
+
+    while (offset < length) {
+
+        size_t frameLength = TGLLayoutTraceDecodeFrame(bytes + offset, length - offset, &frame);
+
+        TGLTestAssert(frameLength > 0);
+
+        if (frameLength == 0) break;
+
+        unsigned char encoded[TGLLayoutTraceMaxFrameSize];
+        size_t encodedLength = TGLLayoutTraceEncodeFrame(&frame, &previous, encoded);
+
+        TGLTestAssertEqualLong(encodedLength, frameLength);
+        TGLTestAssert(encodedLength == frameLength && memcmp(encoded, bytes + offset, frameLength) == 0);
+
+        offset += frameLength;
+        frameCount++;
+    }
+
+    TGLTestAssertEqualLong(offset, length);
+    TGLTestAssertEqualLong(frameCount, 1003);
+    TGLTestAssertEqualLong(frame.itemCount, 100);
+    TGLTestAssertEqualDouble(frame.boundsHeight, 812.0);
+    TGLTestAssert(fabs(frame.time - 20.0) < 1e-3);
+
+    free(bytes);
+}
+
+// MARK: - Main
+
+int main(int argc, const char *argv[]) {
+
+    TGLTestHeaderRoundTrip();
+    TGLTestFrameRoundTrip();
+    TGLTestFixture((argc > 1) ? argv[1] : TGLTestFixturePath);
+
+    return TGLTestFinish("TGLLayoutTraceTests");
+}
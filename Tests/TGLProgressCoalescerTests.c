@@ -0,0 +1,170 @@
+//
+//  TGLProgressCoalescerTests.c
+//  TGLStackedViewController
+//
+//  Created by Tim Gleue on 17.10.26.
+//  Copyright (c) 2026 Tim Gleue ( http://gleue-interactive.com )
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+/* Headless tests of interactive progress coalescing.
+ *
+ * Feeds timestamped gesture input and display ticks into
+ * a coalescer, checking the progress applied per tick
+ * with and without prediction.
+ */
+
+#include "TGLProgressCoalescer.h"
+#include "TGLTestAssertions.h"
+
+static const double TGLTestFrameDuration = 1.0 / 120.0;
+
+// MARK: - Coalescing
+
+static void TGLTestCoalescing(void) {
+
+    TGLProgressCoalescer coalescer;
+    double progress = -1.0;
+
+    TGLProgressCoalescerReset(&coalescer, 0.0);
+
+    // Nothing to apply without input
+    //
+    TGLTestAssert(!TGLProgressCoalescerTick(&coalescer, TGLTestFrameDuration, 0.0, &progress));
+    TGLTestAssertEqualDouble(progress, -1.0);
+
+    // Three inputs within one frame
+    // are applied as one progress
+    //
+    TGLProgressCoalescerAddInput(&coalescer, 0.1, 0.001);
+    TGLProgressCoalescerAddInput(&coalescer, 0.15, 0.002);
+    TGLProgressCoalescerAddInput(&coalescer, 0.2, 0.003);
+
+    TGLTestAssert(TGLProgressCoalescerTick(&coalescer, TGLTestFrameDuration, 0.0, &progress));
+    TGLTestAssertEqualDouble(progress, 0.2);
+    TGLTestAssertEqualLong(coalescer.inputCount, 3);
+    TGLTestAssertEqualLong(coalescer.tickCount, 1);
+
+    // Ticks without new or with unchanged
+    // progress don't apply anything
+    //
+    TGLTestAssert(!TGLProgressCoalescerTick(&coalescer, 2.0 * TGLTestFrameDuration, 0.0, &progress));
+
+    TGLProgressCoalescerAddInput(&coalescer, 0.2, 0.012);
+
+    TGLTestAssert(!TGLProgressCoalescerTick(&coalescer, 3.0 * TGLTestFrameDuration, 0.0, &progress));
+    TGLTestAssertEqualLong(coalescer.inputCount, 4);
+    TGLTestAssertEqualLong(coalescer.tickCount, 1);
+
+    TGLProgressCoalescerAddInput(&coalescer, 0.25, 0.026);
+    TGLProgressCoalescerAddInput(&coalescer, 0.3, 0.029);
+
+    TGLTestAssert(TGLProgressCoalescerTick(&coalescer, 4.0 * TGLTestFrameDuration, 0.0, &progress));
+    TGLTestAssertEqualDouble(progress, 0.3);
+    TGLTestAssertEqualLong(coalescer.inputCount, 6);
+    TGLTestAssertEqualLong(coalescer.tickCount, 2);
+
+    // Progress is clamped to 0...1
+    //
+    TGLProgressCoalescerAddInput(&coalescer, 1.5, 0.035);
+
+    TGLTestAssert(TGLProgressCoalescerTick(&coalescer, 5.0 * TGLTestFrameDuration, 0.0, &progress));
+    TGLTestAssertEqualDouble(progress, 1.0);
+
+    // Reset counts as applied
+    //
+    TGLProgressCoalescerReset(&coalescer, 0.5);
+
+    TGLTestAssertEqualLong(coalescer.inputCount, 0);
+    TGLTestAssertEqualLong(coalescer.tickCount, 0);
+    TGLTestAssert(!TGLProgressCoalescerTick(&coalescer, 6.0 * TGLTestFrameDuration, 0.0, &progress));
+}
+
+// MARK: - Prediction
+
+static void TGLTestPrediction(void) {
+
+    TGLProgressCoalescer coalescer;
+    double progress = -1.0;
+
+    TGLProgressCoalescerReset(&coalescer, 0.0);
+
+    // First input carries no velocity
+    //
+    TGLProgressCoalescerAddInput(&coalescer, 0.0, 0.0);
+
+    TGLTestAssertEqualDouble(coalescer.velocity, 0.0);
+
+    // Moving at 4/s after 25ms, i.e. the smoothing
+    // time constant, yields half that velocity
+    //
+    TGLProgressCoalescerAddInput(&coalescer, 0.1, 0.025);
+
+    TGLTestAssertEqualDouble(coalescer.velocity, 2.0);
+    TGLTestAssertEqualDouble(TGLProgressCoalescerPredictedProgress(&coalescer, 0.035, 0.0), 0.1);
+    TGLTestAssertEqualDouble(TGLProgressCoalescerPredictedProgress(&coalescer, 0.035, 0.01), 0.14);
+
+    // Input older than timeout is not extrapolated
+    //
+    TGLTestAssertEqualDouble(TGLProgressCoalescerPredictedProgress(&coalescer, 0.1, 0.01), 0.1);
+
+    TGLProgressCoalescerAddInput(&coalescer, 0.2, 0.05);
+
+    TGLTestAssertEqualDouble(coalescer.velocity, 3.0);
+    TGLTestAssertEqualDouble(TGLProgressCoalescerPredictedProgress(&coalescer, 0.05, 0.01), 0.23);
+
+    // Input sharing a timestamp updates
+    // progress but not velocity
+    //
+    TGLProgressCoalescerAddInput(&coalescer, 0.25, 0.05);
+
+    TGLTestAssertEqualDouble(coalescer.velocity, 3.0);
+    TGLTestAssertEqualLong(coalescer.inputCount, 4);
+
+    // Ticks apply extrapolated progress until
+    // input times out, then fall back to the
+    // latest input
+    //
+    TGLTestAssert(TGLProgressCoalescerTick(&coalescer, 0.06, 0.01, &progress));
+    TGLTestAssertEqualDouble(progress, 0.31);
+    TGLTestAssert(!TGLProgressCoalescerTick(&coalescer, 0.06, 0.01, &progress));
+    TGLTestAssert(TGLProgressCoalescerTick(&coalescer, 0.07, 0.01, &progress));
+    TGLTestAssertEqualDouble(progress, 0.34);
+    TGLTestAssert(TGLProgressCoalescerTick(&coalescer, 0.2, 0.01, &progress));
+    TGLTestAssertEqualDouble(progress, 0.25);
+    TGLTestAssertEqualLong(coalescer.tickCount, 3);
+
+    // Extrapolation is clamped as well
+    //
+    TGLProgressCoalescerAddInput(&coalescer, 0.95, 0.25);
+
+    TGLTestAssert(TGLProgressCoalescerTick(&coalescer, 0.26, 0.05, &progress));
+    TGLTestAssertEqualDouble(progress, 1.0);
+    TGLTestAssertEqualLong(coalescer.tickCount, 4);
+}
+
+// MARK: - Main
+
+int main(void) {
+
+    TGLTestCoalescing();
+    TGLTestPrediction();
+
+    return TGLTestFinish("TGLProgressCoalescerTests");
+}
@@ -0,0 +1,250 @@
+//
+//  TGLRecordWindowTests.c
+//  TGLStackedViewController
+//
+//  Created by Tim Gleue on 17.10.26.
+//  Copyright (c) 2026 Tim Gleue ( http://gleue-interactive.com )
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+/* Headless tests of the paged record window.
+ *
+ * Checks that records map to the items they were read for,
+ * that no more than the window's capacity of pages become
+ * resident, and that pages farthest from the visible range
+ * are evicted first, reading from a synthetic callback as
+ * well as from a memory-mapped file.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "TGLRecordWindow.h"
+#include "TGLTestAssertions.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// MARK: - Helpers
+
+typedef struct {
+
+    long item;
+    char title[24];
+
+} TGLTestRecord;
+
+static bool TGLTestReadRecords(void *context, long first, long count, void *buffer) {
+
+    TGLTestRecord *records = buffer;
+    long *failingPage = context;
+
+    if (failingPage && first / 10 == *failingPage) return false;
+
+    for (long i = 0; i < count; i++) {
+
+        records[i].item = first + i;
+
+        snprintf(records[i].title, sizeof(records[i].title), "Card #%ld", first + i);
+    }
+
+    return true;
+}
+
+static bool TGLTestPageIsResident(const TGLRecordWindow *window, long page) {
+
+    for (long slot = 0; slot < window->pageCapacity; slot++) {
+
+        if (window->slotPages[slot] == page) return true;
+    }
+
+    return false;
+}
+
+// MARK: - Tests
+
+static void TGLTestRecordMapping(void) {
+
+    TGLRecordWindow window;
+
+    TGLTestAssert(TGLRecordWindowInit(&window, 1005, sizeof(TGLTestRecord), 10, 4, TGLTestReadRecords, NULL));
+
+    const long items[] = { 0, 9, 10, 505, 999, 1000, 1004 };
+
+    for (int i = 0; i < 7; i++) {
+
+        const TGLTestRecord *record = TGLRecordWindowRecord(&window, items[i]);
+        char title[24];
+
+        snprintf(title, sizeof(title), "Card #%ld", items[i]);
+
+        TGLTestAssert(record != NULL);
+
+        if (record) {
+
+            TGLTestAssertEqualLong(record->item, items[i]);
+            TGLTestAssert(strcmp(record->title, title) == 0);
+        }
+
+        TGLTestAssert(TGLRecordWindowResidentPageCount(&window) <= 4);
+    }
+
+    // Out of range
+    //
+    TGLTestAssert(TGLRecordWindowRecord(&window, -1) == NULL);
+    TGLTestAssert(TGLRecordWindowRecord(&window, 1005) == NULL);
+
+    TGLRecordWindowFree(&window);
+}
+
+static void TGLTestResidentPageCap(void) {
+
+    TGLRecordWindow window;
+
+    TGLTestAssert(TGLRecordWindowInit(&window, 1000, sizeof(TGLTestRecord), 10, 4, TGLTestReadRecords, NULL));
+
+    size_t residentBytes = TGLRecordWindowResidentBytes(&window);
+
+    // Visible page 50 is read first, then pages
+    // alternating outwards until all slots are
+    // in use. Page 52 would have to evict page
+    // 48, which is as close to visible items
+    //
+    TGLRecordWindowSetVisibleRange(&window, 500, 510, 480, 540);
+
+    TGLTestAssertEqualLong(TGLRecordWindowResidentPageCount(&window), 4);
+    TGLTestAssertEqualLong(window.loadCount, 4);
+    TGLTestAssertEqualLong(window.evictionCount, 0);
+    TGLTestAssert(TGLTestPageIsResident(&window, 48));
+    TGLTestAssert(TGLTestPageIsResident(&window, 49));
+    TGLTestAssert(TGLTestPageIsResident(&window, 50));
+    TGLTestAssert(TGLTestPageIsResident(&window, 51));
+    TGLTestAssert(!TGLTestPageIsResident(&window, 52));
+
+    // Records accessed on demand evict the
+    // page farthest from visible items
+    //
+    const TGLTestRecord *record = TGLRecordWindowRecord(&window, 0);
+
+    TGLTestAssert(record && record->item == 0);
+    TGLTestAssertEqualLong(window.evictionCount, 1);
+    TGLTestAssert(!TGLTestPageIsResident(&window, 48));
+    TGLTestAssert(TGLTestPageIsResident(&window, 0));
+
+    // Scrolling far away replaces all pages,
+    // while resident pages and memory stay
+    // bounded
+    //
+    for (long first = 0; first < 1000; first += 7) {
+
+        long end = (first + 10 < 1000) ? first + 10 : 1000;
+
+        TGLRecordWindowSetVisibleRange(&window, first, end, first, end + 30);
+
+        TGLTestAssert(TGLRecordWindowResidentPageCount(&window) <= 4);
+
+        for (long item = first; item < end; item++) {
+
+            record = TGLRecordWindowRecord(&window, item);
+
+            TGLTestAssert(record && record->item == item);
+        }
+    }
+
+    TGLTestAssertEqualLong(TGLRecordWindowResidentPageCount(&window), 4);
+    TGLTestAssert(TGLTestPageIsResident(&window, 99));
+    TGLTestAssertEqualLong(TGLRecordWindowResidentBytes(&window), residentBytes);
+
+    TGLRecordWindowFree(&window);
+}
+
+static void TGLTestReadFailure(void) {
+
+    TGLRecordWindow window;
+    long failingPage = 3;
+
+    TGLTestAssert(TGLRecordWindowInit(&window, 100, sizeof(TGLTestRecord), 10, 4, TGLTestReadRecords, &failingPage));
+
+    TGLTestAssert(TGLRecordWindowRecord(&window, 35) == NULL);
+    TGLTestAssert(TGLRecordWindowRecord(&window, 45) != NULL);
+    TGLTestAssertEqualLong(TGLRecordWindowResidentPageCount(&window), 1);
+
+    TGLRecordWindowFree(&window);
+}
+
+static void TGLTestMappedFile(void) {
+
+    char path[] = "/tmp/TGLRecordWindowTests.XXXXXX";
+    int fd = mkstemp(path);
+
+    TGLTestAssert(fd >= 0);
+
+    if (fd < 0) return;
+
+    // File of 250 records following
+    // a 16 byte header, plus a partial
+    // record at the end
+    //
+    FILE *file = fdopen(fd, "wb");
+    char header[16] = "TGLTESTRECORDS";
+    TGLTestRecord records[250];
+
+    TGLTestReadRecords(NULL, 0, 250, records);
+
+    fwrite(header, 1, sizeof(header), file);
+    fwrite(records, sizeof(TGLTestRecord), 250, file);
+    fwrite(header, 1, 3, file);
+    fclose(file);
+
+    TGLRecordMapping mapping;
+
+    TGLTestAssert(TGLRecordMappingOpen(&mapping, path, sizeof(header), sizeof(TGLTestRecord)));
+    TGLTestAssertEqualLong(mapping.recordCount, 250);
+
+    TGLRecordWindow window;
+
+    TGLTestAssert(TGLRecordWindowInit(&window, mapping.recordCount, sizeof(TGLTestRecord), 10, 3, TGLRecordMappingRead, &mapping));
+
+    for (long item = 249; item >= 0; item -= 3) {
+
+        TGLRecordWindowSetVisibleRange(&window, item, item + 1, item - 10, item + 1);
+
+        const TGLTestRecord *record = TGLRecordWindowRecord(&window, item);
+
+        TGLTestAssert(record && record->item == item);
+        TGLTestAssert(TGLRecordWindowResidentPageCount(&window) <= 3);
+    }
+
+    TGLRecordWindowFree(&window);
+    TGLRecordMappingClose(&mapping);
+
+    unlink(path);
+}
+
+// MARK: - Main
+
+int main(void) {
+
+    TGLTestRecordMapping();
+    TGLTestResidentPageCap();
+    TGLTestReadFailure();
+    TGLTestMappedFile();
+
+    return TGLTestFinish("TGLRecordWindowTests");
+}
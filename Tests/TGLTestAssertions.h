@@ -0,0 +1,81 @@
+//
+//  TGLTestAssertions.h
+//  TGLStackedViewController
+//
+//  Created by Tim Gleue on 17.10.26.
+//  Copyright (c) 2026 Tim Gleue ( http://gleue-interactive.com )
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+#ifndef TGLTestAssertions_h
+#define TGLTestAssertions_h
+
+/* Minimal assertions shared by the headless tests.
+ *
+ * Each test is a program of its own, so failures are
+ * counted per program. Failed assertions are reported
+ * to `stderr` and testing continues, while the exit
+ * status returned by `TGLTestFinish` tells if any
+ * assertion failed.
+ */
+
+#include <math.h>
+#include <stdio.h>
+
+static int TGLTestFailureCount = 0;
+
+#define TGLTestAssert(condition) do { \
+    if (!(condition)) { \
+        fprintf(stderr, "%s:%d: assertion failed: %s\n", __FILE__, __LINE__, #condition); \
+        TGLTestFailureCount++; \
+    } \
+} while (0)
+
+#define TGLTestAssertEqualLong(value, expected) do { \
+    long _value = (long)(value), _expected = (long)(expected); \
+    if (_value != _expected) { \
+        fprintf(stderr, "%s:%d: %s is %ld, expected %ld\n", __FILE__, __LINE__, #value, _value, _expected); \
+        TGLTestFailureCount++; \
+    } \
+} while (0)
+
+#define TGLTestAssertEqualDouble(value, expected) do { \
+    double _value = (double)(value), _expected = (double)(expected); \
+    if (fabs(_value - _expected) > 1e-9 * fmax(1.0, fabs(_expected))) { \
+        fprintf(stderr, "%s:%d: %s is %g, expected %g\n", __FILE__, __LINE__, #value, _value, _expected); \
+        TGLTestFailureCount++; \
+    } \
+} while (0)
+
+/** Reports the outcome of test `name` and returns the program's exit status */
+static inline int TGLTestFinish(const char *name) {
+
+    if (TGLTestFailureCount > 0) {
+
+        printf("%s: %d assertion(s) failed\n", name, TGLTestFailureCount);
+
+        return 1;
+    }
+
+    printf("%s: passed\n", name);
+
+    return 0;
+}
+
+#endif /* TGLTestAssertions_h */